@@ -28,6 +28,7 @@ using namespace std;
 #include "skrerrorhub.h"
 #include "skrpropertyhub.h"
 #include "skrstathub.h"
+#include "skrsearchhub.h"
 #include "documenthandler.h"
 #include "skrhighlighter.h"
 #include "skrspellchecker.h"
@@ -265,6 +266,12 @@ int main(int argc, char *argv[])
                                            "SKRStatHub",
                                            "Can't instantiate SKRStatHub");
 
+    qmlRegisterUncreatableType<SKRSearchHub>("eu.skribisto.searchhub",
+                                             1,
+                                             0,
+                                             "SKRSearchHub",
+                                             "Can't instantiate SKRSearchHub");
+
     qmlRegisterUncreatableType<SKRErrorHub>("eu.skribisto.errorhub",
                                             1,
                                             0,
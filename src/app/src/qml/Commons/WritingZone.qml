@@ -612,6 +612,7 @@ WritingZoneForm {
             if(!spellCheckerKilled){
                 // activate
                 SkrSettings.spellCheckingSettings.onSpellCheckingActivationChanged.connect(determineSpellCheckerActivation)
+                SkrSettings.spellCheckingSettings.onSpellCheckingInBackgroundChanged.connect(determineSpellCheckerActivation)
                 determineSpellCheckerActivation()
 
                 //lang
@@ -622,6 +623,7 @@ WritingZoneForm {
         }
         Component.onDestruction: {
             SkrSettings.spellCheckingSettings.onSpellCheckingActivationChanged.disconnect(determineSpellCheckerActivation)
+            SkrSettings.spellCheckingSettings.onSpellCheckingInBackgroundChanged.disconnect(determineSpellCheckerActivation)
             SkrSettings.spellCheckingSettings.onSpellCheckingLangCodeChanged.disconnect(determineSpellCheckerLanguageCode)
         }
 
@@ -663,6 +665,7 @@ WritingZoneForm {
     function determineSpellCheckerActivation(){
         var value = SkrSettings.spellCheckingSettings.spellCheckingActivation
         highlighter.spellChecker.activate(SkrSettings.spellCheckingSettings.spellCheckingActivation)
+        highlighter.backgroundSpellCheckEnabled = SkrSettings.spellCheckingSettings.spellCheckingInBackground
         highlighter.rehighlight()
 
         // needed to "shake" the highlighter
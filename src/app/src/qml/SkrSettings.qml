@@ -26,6 +26,7 @@ QtObject {
         property string paths: ""
         property bool saveEveryCheckBoxChecked: false
         property int saveEveryMinutes: 10
+        property bool walMode: false
 
     }
     property Settings accessibilitySettings: Settings{
@@ -50,6 +51,7 @@ QtObject {
     property Settings spellCheckingSettings: Settings{
         category: "spellChecking"
         property bool spellCheckingActivation: true
+        property bool spellCheckingInBackground: true
         property string spellCheckingLangCode: "en_US"
     }
 
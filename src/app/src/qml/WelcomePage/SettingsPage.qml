@@ -617,6 +617,14 @@ SettingsPageForm {
 
     }
 
+    walModeSwitch.checked: SkrSettings.saveSettings.walMode
+    Binding {
+        target: SkrSettings.saveSettings
+        property: "walMode"
+        value: walModeSwitch.checked
+        restoreMode: Binding.RestoreBindingOrValue
+    }
+
     //dials :
 
     saveDial.onMoved: saveSpinBox.value = saveDial.value
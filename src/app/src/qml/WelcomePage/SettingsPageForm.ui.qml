@@ -10,6 +10,7 @@ Item {
     property alias saveDial: saveDial
     property alias saveSpinBox: saveSpinBox
     property alias saveEveryCheckBox: saveEveryCheckBox
+    property alias walModeSwitch: walModeSwitch
     property alias backUpEveryCheckBox: backUpEveryCheckBox
     property alias backupHoursSpinBox: backupHoursSpinBox
     property alias backupHoursDial: backupHoursDial
@@ -343,6 +344,11 @@ Item {
                                 wheelEnabled: true
                             }
                         }
+
+                        SkrSwitch {
+                            id: walModeSwitch
+                            text: qsTr("Save in the background (applied to the next opened projects)")
+                        }
                     }
                 }
 
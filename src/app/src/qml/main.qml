@@ -1067,6 +1067,44 @@ ApplicationWindow {
         }
     }
 
+    Connections{
+        target: plmData.projectHub()
+        function onProjectRecoverable(projectId, recoveredPath){
+            recoverProjectDialog.projectId = projectId
+            recoverProjectDialog.projectName = plmData.projectHub().getProjectName(projectId)
+            recoverProjectDialog.recoveredPath = recoveredPath
+            recoverProjectDialog.open()
+        }
+    }
+
+    SimpleDialog {
+        property int projectId: -2
+        property string projectName: ""
+        property url recoveredPath
+
+        id: recoverProjectDialog
+        title: "Warning"
+        text: qsTr("The project %1 wasn't closed properly. Its last changes were kept in %2. Do you want to recover them ?").arg(projectName).arg(skrQMLTools.translateURLToLocalFile(recoveredPath))
+        standardButtons: Dialog.Open  | Dialog.Discard | Dialog.Cancel
+
+        onRejected: {
+            recoverProjectDialog.close()
+
+        }
+
+        onDiscarded: {
+            plmData.projectHub().discardRecoveredProject(recoveredPath)
+            recoverProjectDialog.close()
+
+        }
+
+        onAccepted: {
+            plmData.projectHub().recoverProject(projectId, recoveredPath)
+            recoverProjectDialog.close()
+
+        }
+    }
+
     // delay close of loading popup to let the time to switch to the sheet tab
     Timer {
         id: closeLoadingPopupTimer
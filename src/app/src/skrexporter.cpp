@@ -6,6 +6,13 @@
 #include <QPdfWriter>
 #include <QPagedPaintDevice>
 #include <QTextBlock>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
 
 #ifdef SKR_PRINT_SUPPORT
 # include <QPrinter>
@@ -38,6 +45,10 @@ void SKRExporter::run()
         return;
     }
 
+    QElapsedTimer timer;
+    timer.start();
+    m_lastRunStats.clear();
+
     emit progressMaximumChanged(m_treeItemIdList.count());
 
 
@@ -47,89 +58,54 @@ void SKRExporter::run()
     m_blockFormat.setTopMargin(m_textTopMargin);
     m_blockFormat.setTextIndent(m_textIndent);
 
-
-    QTextDocument *finalDocument = new QTextDocument(this);
     QString projectTitle = plmdata->projectHub()->getProjectName(m_projectId);
+    QString fileName = m_outputUrl.toLocalFile();
 
-    QTextCursor textCursor(finalDocument);
-    if (!m_quick) {
-        // project title :
-
-        textCursor.movePosition(QTextCursor::Start);
-
-
-        QTextDocument titleDoc;
+    // Markdown, text and HTML are written item by item, without building the
+    // whole document
 
-        titleDoc.setHtml(QString("%1").arg(projectTitle));
+    if (this->isStreamable()) {
+        QFile file(fileName);
 
-        textCursor.insertFragment(QTextDocumentFragment(&titleDoc));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "SKRExporter: can't open" << fileName;
+            return;
+        }
 
-        QTextBlockFormat titleBlockFormat;
+        this->writeStream(projectTitle, file);
+        file.close();
 
-        titleBlockFormat.setAlignment(Qt::AlignHCenter);
-        titleBlockFormat.setHeadingLevel(1);
-        textCursor.setBlockFormat(titleBlockFormat);
-        textCursor.insertBlock(m_blockFormat, m_charFormat);
-    }
-    QList<int> treeItemNumbers;
+        m_lastRunStats.insert("elapsedMs", timer.elapsed());
 
-    for (int treeItemId : qAsConst(m_treeItemIdList)) {
-        this->createContent(finalDocument, m_projectId, treeItemId, &treeItemNumbers);
+        return;
     }
 
 
+    QTextDocument *finalDocument = new QTextDocument(this);
 
-    // set size and bold with headers for ODT, PDF, Print
-
-    for (int i = 0; i < finalDocument->blockCount(); i++) {
-        QTextBlock textBlock = finalDocument->findBlockByNumber(i);
-
-        int headingLevel = textBlock.blockFormat().headingLevel();
+    QTextCursor textCursor(finalDocument);
+    if (!m_quick) {
+        this->insertProjectTitle(textCursor, projectTitle);
 
-        if (headingLevel > 0) {
-            QTextCursor cursor(finalDocument);
-            cursor.setPosition(textBlock.position());
-            cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+        // set size and bold with headers for ODT, PDF, Print, the items have
+        // theirs set when converted
+        SKRExporter::formatHeadings(finalDocument, m_fontPointSize);
+    }
 
-            QTextCharFormat textCharFormat;
-            textCharFormat.setFontWeight(QFont::Bold);
-            textCharFormat.setFontPointSize(m_fontPointSize + m_fontPointSize / headingLevel);
-            cursor.mergeCharFormat(textCharFormat);
+    // converted on the thread pool, only inserted here, in order
+    this->convertItems([&textCursor](ConvertedItem& convertedItem) {
+        if (convertedItem.document) {
+            textCursor.movePosition(QTextCursor::End);
+            textCursor.insertFragment(QTextDocumentFragment(convertedItem.document.data()));
         }
-    }
+    });
 
 
     // writing
 
 
-    QByteArray format;
-
-    switch (m_outputType) {
-    case OutputType::Odt:
-        format = "odf";
-        break;
-
-    case OutputType::Html:
-        format = "HTML";
-        break;
-
-    case OutputType::Txt:
-        format = "plaintext";
-        break;
-
-    case OutputType::Md:
-        format = "markdown";
-        break;
-
-    default:
-        format = "";
-        break;
-    }
-
-    QString fileName = m_outputUrl.toLocalFile();
-
-    if ((m_outputType != OutputType::Printer) && (m_outputType != OutputType::Pdf)) {
-        QTextDocumentWriter writer(fileName, format);
+    if (m_outputType == OutputType::Odt) {
+        QTextDocumentWriter writer(fileName, "odf");
         bool ok = writer.write(finalDocument);
     }
 
@@ -177,159 +153,439 @@ void SKRExporter::run()
 
 
 #endif // SKR_PRINT_SUPPORT
+
+    m_lastRunStats.insert("itemCount",      m_treeItemIdList.count());
+    m_lastRunStats.insert("characterCount", finalDocument->characterCount());
+    m_lastRunStats.insert("streamed",       false);
+    m_lastRunStats.insert("elapsedMs",      timer.elapsed());
+
+    finalDocument->deleteLater();
 }
 
 // --------------------------------------------------------------------------------------
 
-void SKRExporter::createContent(QTextDocument *textDocument, int projectId,
-                                int treeItemId, QList<int> *numbers) {
-    SKRTreeHub *treeHub = plmdata->treeHub();
+///
+/// \brief SKRExporter::lastRunStats
+/// \return what the last run did: "itemCount", "elapsedMs", "streamed",
+/// "threadCount" and "peakBufferedCharacters", the most converted text waiting
+/// to be used at once. For streamed runs "bytesWritten", otherwise
+/// "characterCount" of the whole document.
+QVariantMap SKRExporter::lastRunStats() const
+{
+    return m_lastRunStats;
+}
 
-    QString type = treeHub->getType(projectId, treeItemId);
+// --------------------------------------------------------------------------------------
 
-    //TODO: temp until other types are done
-    if(type != "TEXT"){
-        return;
+bool SKRExporter::isStreamable() const
+{
+    return m_outputType == OutputType::Md || m_outputType == OutputType::Txt || m_outputType ==
+           OutputType::Html;
+}
+
+// --------------------------------------------------------------------------------------
+
+///
+/// \brief SKRExporter::writeStream
+/// \param projectTitle
+/// \param file
+/// The converted items are written in the order of the list as soon as they
+/// are ready.
+void SKRExporter::writeStream(const QString& projectTitle, QFile& file)
+{
+    qint64 bytesWritten = 0;
+
+    // empty in quick mode, still giving the HTML page around the items
+    QTextDocument titleDoc;
+
+    if (!m_quick) {
+        QTextCursor titleCursor(&titleDoc);
+
+        this->insertProjectTitle(titleCursor, projectTitle);
+        SKRExporter::formatHeadings(&titleDoc, m_fontPointSize);
     }
 
-    QTextCursor textCursor(textDocument);
+    // the page header of Qt, with its style block keeping the spaces and the
+    // default font on the body, as when the whole document was written at once
+    QString htmlFooter;
 
-    textCursor.movePosition(QTextCursor::End);
+    if (m_outputType == OutputType::Html) {
+        QString html      = titleDoc.toHtml();
+        int     bodyStart = html.indexOf('>', html.indexOf("<body")) + 1;
+        int     bodyEnd   = html.lastIndexOf("</body>");
 
+        bytesWritten += file.write(html.left(bodyStart).toUtf8() + "\n");
+        htmlFooter    = html.mid(bodyEnd);
+    }
 
-    int indent = treeHub->getIndent(projectId, treeItemId);
+    if (!m_quick) {
+        bytesWritten += file.write(this->serialize(&titleDoc).toUtf8());
+    }
 
 
-    if ((m_indentWithTitle > indent) || (type == "TEXT")) {
-        // number :
+    this->convertItems([&bytesWritten, &file](ConvertedItem& convertedItem) {
+        bytesWritten += file.write(convertedItem.text.toUtf8());
+    });
 
-        // increment :
-        while (indent + 1 >= numbers->count()) {
-            numbers->append(0);
-        }
+    if (m_outputType == OutputType::Html) {
+        bytesWritten += file.write(htmlFooter.toUtf8());
+    }
+
+    m_lastRunStats.insert("itemCount",    m_treeItemIdList.count());
+    m_lastRunStats.insert("streamed",     true);
+    m_lastRunStats.insert("bytesWritten", bytesWritten);
+}
+
+// --------------------------------------------------------------------------------------
+
+///
+/// \brief SKRExporter::convertItem
+/// \param item
+/// \return the item in the output format. Runs on the thread pool, so it only
+/// uses the item and the export settings.
+SKRExporter::ConvertedItem SKRExporter::convertItem(const ExportItem& item) const
+{
+    QSharedPointer<QTextDocument> itemDoc(new QTextDocument());
+    QTextCursor textCursor(itemDoc.data());
+
+    this->insertItem(textCursor, item);
+    SKRExporter::formatHeadings(itemDoc.data(), m_fontPointSize);
+
+    ConvertedItem convertedItem;
+
+    if (this->isStreamable()) {
+        convertedItem.text           = this->serialize(itemDoc.data());
+        convertedItem.characterCount = convertedItem.text.size();
+    }
+    else {
+        // handed over to the thread of the exporter, which reads it and
+        // deletes it. No fragment is built here, it would belong to the pool.
+        itemDoc->moveToThread(this->thread());
+        convertedItem.document       = itemDoc;
+        convertedItem.characterCount = itemDoc->characterCount();
+    }
+
+    return convertedItem;
+}
+
+// --------------------------------------------------------------------------------------
+
+///
+/// \brief SKRExporter::convertItems
+/// \param consume called on the main thread with each converted item, in the
+/// order of the list
+/// The items are read from the hubs here, on the main thread, then converted
+/// on a thread pool. A bounded number of items is in flight at once, so the
+/// memory used doesn't depend on the size of the project.
+void SKRExporter::convertItems(const std::function<void(ConvertedItem&)>& consume)
+{
+    struct PendingItem {
+        ConvertedItem convertedItem;
+        bool          isDone = false;
+    };
 
+    const int itemCount = m_treeItemIdList.count();
+    QVector<PendingItem> pendingItems(itemCount);
+    QMutex mutex;
+    QWaitCondition itemDone;
+    int bufferedCharacters     = 0;
+    int peakBufferedCharacters = 0;
 
-        // reset following numbers
-        numbers->replace(indent, numbers->at(indent) + 1);
+    QThreadPool threadPool;
 
-        for (int v = indent + 1; v < numbers->count(); v++) {
-            numbers->replace(v, 0);
+    threadPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+    const int maxItemsInFlight = 2 * threadPool.maxThreadCount();
+
+    QList<int> treeItemNumbers;
+    int submittedCount = 0;
+
+    for (int consumedCount = 0; consumedCount < itemCount; ++consumedCount) {
+        // keep the pool busy
+        while (submittedCount < itemCount && submittedCount - consumedCount < maxItemsInFlight) {
+            int index = submittedCount;
+            ++submittedCount;
+
+            ExportItem item;
+
+            if (!this->fetchItem(m_projectId, m_treeItemIdList.at(index), &treeItemNumbers, &item)) {
+                QMutexLocker locker(&mutex);
+                pendingItems[index].isDone = true;
+                continue;
+            }
+
+            threadPool.start([this, item, index, &pendingItems, &mutex, &itemDone,
+                              &bufferedCharacters, &peakBufferedCharacters]() {
+                ConvertedItem convertedItem = this->convertItem(item);
+
+                QMutexLocker locker(&mutex);
+                bufferedCharacters    += convertedItem.characterCount;
+                peakBufferedCharacters = qMax(peakBufferedCharacters, bufferedCharacters);
+                pendingItems[index].convertedItem = convertedItem;
+                pendingItems[index].isDone        = true;
+                itemDone.wakeAll();
+            });
         }
 
-        // create string :
-        QStringList numberStringList;
+        // consume the next one in order
+        ConvertedItem convertedItem;
+        {
+            QMutexLocker locker(&mutex);
 
-        for (int i = 0; i <= indent; i++) {
-            numberStringList.append(QString::number(numbers->at(i)));
+            while (!pendingItems.at(consumedCount).isDone) {
+                itemDone.wait(&mutex);
+            }
+            std::swap(convertedItem, pendingItems[consumedCount].convertedItem);
+            bufferedCharacters -= convertedItem.characterCount;
         }
-        QString numberString = numberStringList.join(".");
 
-        // title :
+        consume(convertedItem);
+
+        emit progressChanged(1);
+    }
+
+    threadPool.waitForDone();
+
+    m_lastRunStats.insert("threadCount",            threadPool.maxThreadCount());
+    m_lastRunStats.insert("peakBufferedCharacters", peakBufferedCharacters);
+}
+
+// --------------------------------------------------------------------------------------
+
+QString SKRExporter::serialize(QTextDocument *textDocument) const
+{
+    switch (m_outputType) {
+    case OutputType::Md:
+        return textDocument->toMarkdown() + "\n";
+
+    case OutputType::Txt:
+        return textDocument->toPlainText() + "\n";
 
-        QString title =  treeHub->getTitle(projectId, treeItemId);
+    case OutputType::Html: {
+        // only the body, the page header is written once
+        QString html      = textDocument->toHtml();
+        int     bodyStart = html.indexOf("<body");
 
-        QTextDocument titleDoc;
+        bodyStart = html.indexOf('>', bodyStart) + 1;
+        int bodyEnd = html.lastIndexOf("</body>");
 
-        if (m_numbered) {
-            titleDoc.setPlainText(QString("%1. %2").arg(numberString).arg(title));
+        if ((bodyStart <= 0) || (bodyEnd < bodyStart)) {
+            return html;
         }
-        else {
-            titleDoc.setPlainText(QString("%1").arg(title));
+
+        return html.mid(bodyStart, bodyEnd - bodyStart) + "\n";
+    }
+
+    default:
+        return QString();
+    }
+}
+
+// --------------------------------------------------------------------------------------
+
+void SKRExporter::formatHeadings(QTextDocument *textDocument, int fontPointSize)
+{
+    for (QTextBlock textBlock = textDocument->begin(); textBlock.isValid(); textBlock = textBlock.next()) {
+        int headingLevel = textBlock.blockFormat().headingLevel();
+
+        if (headingLevel > 0) {
+            QTextCursor cursor(textDocument);
+            cursor.setPosition(textBlock.position());
+            cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+
+            QTextCharFormat textCharFormat;
+            textCharFormat.setFontWeight(QFont::Bold);
+            textCharFormat.setFontPointSize(fontPointSize + fontPointSize / headingLevel);
+            cursor.mergeCharFormat(textCharFormat);
         }
+    }
+}
 
-        QTextBlockFormat titleBlockFormat;
-        titleBlockFormat.setAlignment(Qt::AlignHCenter);
-        titleBlockFormat.setHeadingLevel(indent + 2);
-        textCursor.insertBlock(titleBlockFormat, m_charFormat);
-        textCursor.insertFragment(QTextDocumentFragment(&titleDoc));
-        textCursor.insertBlock(m_blockFormat, m_charFormat);
-        textCursor.insertBlock(m_blockFormat, m_charFormat);
+// --------------------------------------------------------------------------------------
+
+void SKRExporter::insertProjectTitle(QTextCursor& textCursor, const QString& projectTitle) const
+{
+    // project title :
+
+    textCursor.movePosition(QTextCursor::Start);
+
+
+    QTextDocument titleDoc;
+
+    titleDoc.setHtml(QString("%1").arg(projectTitle));
+
+    textCursor.insertFragment(QTextDocumentFragment(&titleDoc));
+
+    QTextBlockFormat titleBlockFormat;
+
+    titleBlockFormat.setAlignment(Qt::AlignHCenter);
+    titleBlockFormat.setHeadingLevel(1);
+    textCursor.setBlockFormat(titleBlockFormat);
+    textCursor.insertBlock(m_blockFormat, m_charFormat);
+}
+
+// --------------------------------------------------------------------------------------
+
+///
+/// \brief SKRExporter::fetchItem
+/// \param numbers numbering of the previous items, updated
+/// \param item filled with what is needed to convert the item
+/// \return false if the item isn't exported
+bool SKRExporter::fetchItem(int projectId, int treeItemId, QList<int> *numbers, ExportItem *item) const
+{
+    SKRTreeHub *treeHub = plmdata->treeHub();
+
+    QString type = treeHub->getType(projectId, treeItemId);
+
+    //TODO: temp until other types are done
+    if(type != "TEXT"){
+        return false;
     }
 
-    // tags :
+    int indent = treeHub->getIndent(projectId, treeItemId);
 
+    item->indent = indent;
 
-    if (m_tagsEnabled) {
-        QTextDocument tagsDoc;
-        QList<int>    tagsIdList = plmdata->tagHub()->getTagsFromItemId(projectId, treeItemId);
+    // number :
 
+    // increment :
+    while (indent + 1 >= numbers->count()) {
+        numbers->append(0);
+    }
 
-        if (!tagsIdList.isEmpty()) {
-            QStringList tagsStringList;
 
-            for (int tagId : qAsConst(tagsIdList)) {
-                tagsStringList.append(plmdata->tagHub()->getTagName(projectId, tagId));
-            }
-            tagsStringList.sort(Qt::CaseInsensitive);
+    // reset following numbers
+    numbers->replace(indent, numbers->at(indent) + 1);
 
-            QString tagsMd = tagsStringList.join(" ; ");
+    for (int v = indent + 1; v < numbers->count(); v++) {
+        numbers->replace(v, 0);
+    }
 
-            tagsDoc.setMarkdown(tagsMd);
-            QTextCursor cursor(&tagsDoc);
-            cursor.select(QTextCursor::Document);
-            cursor.mergeCharFormat(m_charFormat);
-            cursor.mergeBlockFormat(m_blockFormat);
-            cursor.movePosition(QTextCursor::Start);
+    // create string :
+    QStringList numberStringList;
 
-            QTextBlockFormat blockFormat;
-            blockFormat.setAlignment(Qt::AlignLeft);
-            QTextCharFormat textCharFormat;
-            textCharFormat.setFontItalic(true);
-            cursor.insertBlock(blockFormat, textCharFormat);
-            cursor.insertText(tr("Tags:"), textCharFormat);
-            cursor.insertBlock(m_blockFormat, m_charFormat);
-            cursor.insertBlock(m_blockFormat, m_charFormat);
+    for (int i = 0; i <= indent; i++) {
+        numberStringList.append(QString::number(numbers->at(i)));
+    }
+    QString numberString = numberStringList.join(".");
 
-            textCursor.movePosition(QTextCursor::End);
-            textCursor.insertFragment(QTextDocumentFragment(&tagsDoc));
-            textCursor.insertBlock(m_blockFormat, m_charFormat);
-        }
+    // title :
+
+    QString title =  treeHub->getTitle(projectId, treeItemId);
+
+    if (m_numbered) {
+        item->title = QString("%1. %2").arg(numberString).arg(title);
     }
+    else {
+        item->title = title;
+    }
+
+    // tags :
+
+    if (m_tagsEnabled) {
+        QList<int> tagsIdList = plmdata->tagHub()->getTagsFromItemId(projectId, treeItemId);
+        QStringList tagsStringList;
+
+        for (int tagId : qAsConst(tagsIdList)) {
+            tagsStringList.append(plmdata->tagHub()->getTagName(projectId, tagId));
+        }
+        tagsStringList.sort(Qt::CaseInsensitive);
 
-    bool synopsisIsEmpty = true;
+        item->tags = tagsStringList.join(" ; ");
+    }
 
     if (m_includeSynopsis) {
+        item->synopsis = treeHub->getSecondaryContent(projectId, treeItemId);
+    }
+
+    item->content = treeHub->getPrimaryContent(projectId, treeItemId);
+
+    return true;
+}
+
+// --------------------------------------------------------------------------------------
+
+void SKRExporter::insertItem(QTextCursor& textCursor, const ExportItem& item) const
+{
+    // title :
+
+    QTextDocument titleDoc;
+
+    titleDoc.setPlainText(item.title);
+
+    QTextBlockFormat titleBlockFormat;
+    titleBlockFormat.setAlignment(Qt::AlignHCenter);
+    titleBlockFormat.setHeadingLevel(item.indent + 2);
+    textCursor.insertBlock(titleBlockFormat, m_charFormat);
+    textCursor.insertFragment(QTextDocumentFragment(&titleDoc));
+    textCursor.insertBlock(m_blockFormat, m_charFormat);
+    textCursor.insertBlock(m_blockFormat, m_charFormat);
+
+    // tags :
+
+
+    if (!item.tags.isEmpty()) {
+        QTextDocument tagsDoc;
+
+        tagsDoc.setMarkdown(item.tags);
+        QTextCursor cursor(&tagsDoc);
+        cursor.select(QTextCursor::Document);
+        cursor.mergeCharFormat(m_charFormat);
+        cursor.mergeBlockFormat(m_blockFormat);
+        cursor.movePosition(QTextCursor::Start);
+
+        QTextBlockFormat blockFormat;
+        blockFormat.setAlignment(Qt::AlignLeft);
+        QTextCharFormat textCharFormat;
+        textCharFormat.setFontItalic(true);
+        cursor.insertBlock(blockFormat, textCharFormat);
+        cursor.insertText(tr("Tags:"), textCharFormat);
+        cursor.insertBlock(m_blockFormat, m_charFormat);
+        cursor.insertBlock(m_blockFormat, m_charFormat);
+
+        textCursor.movePosition(QTextCursor::End);
+        textCursor.insertFragment(QTextDocumentFragment(&tagsDoc));
+        textCursor.insertBlock(m_blockFormat, m_charFormat);
+    }
+
+    bool synopsisIsEmpty = item.synopsis.isEmpty();
+
+    if (!synopsisIsEmpty) {
         QTextDocument synopsisDoc;
-        QString synopsisMd = plmdata->treeHub()->getSecondaryContent(projectId, treeItemId);
-        synopsisIsEmpty = synopsisMd.isEmpty();
 
-        if (!synopsisIsEmpty) {
-            synopsisDoc.setMarkdown(synopsisMd);
-            QTextCursor cursor(&synopsisDoc);
+        synopsisDoc.setMarkdown(item.synopsis);
+        QTextCursor cursor(&synopsisDoc);
 
-            cursor.select(QTextCursor::Document);
-            cursor.mergeCharFormat(m_charFormat);
-            cursor.mergeBlockFormat(m_blockFormat);
-            cursor.movePosition(QTextCursor::Start);
+        cursor.select(QTextCursor::Document);
+        cursor.mergeCharFormat(m_charFormat);
+        cursor.mergeBlockFormat(m_blockFormat);
+        cursor.movePosition(QTextCursor::Start);
 
-            QTextBlockFormat blockFormat;
-            blockFormat.setAlignment(Qt::AlignLeft);
-            QTextCharFormat textCharFormat;
-            textCharFormat.setFontItalic(true);
-            cursor.insertBlock(blockFormat, textCharFormat);
-            cursor.insertText(tr("Outline:"), textCharFormat);
-            cursor.insertBlock(m_blockFormat, m_charFormat);
-            cursor.insertBlock(m_blockFormat, m_charFormat);
+        QTextBlockFormat blockFormat;
+        blockFormat.setAlignment(Qt::AlignLeft);
+        QTextCharFormat textCharFormat;
+        textCharFormat.setFontItalic(true);
+        cursor.insertBlock(blockFormat, textCharFormat);
+        cursor.insertText(tr("Outline:"), textCharFormat);
+        cursor.insertBlock(m_blockFormat, m_charFormat);
+        cursor.insertBlock(m_blockFormat, m_charFormat);
 
-            textCursor.movePosition(QTextCursor::End);
-            textCursor.insertFragment(QTextDocumentFragment(&synopsisDoc));
-            textCursor.insertBlock(m_blockFormat, m_charFormat);
-        }
+        textCursor.movePosition(QTextCursor::End);
+        textCursor.insertFragment(QTextDocumentFragment(&synopsisDoc));
+        textCursor.insertBlock(m_blockFormat, m_charFormat);
     }
 
     // content :
-    QTextDocument contentDoc;
-    QString contentMd = treeHub->getPrimaryContent(projectId, treeItemId);
 
-    if (!contentMd.isEmpty()) {
-        contentDoc.setMarkdown(contentMd);
+    if (!item.content.isEmpty()) {
+        QTextDocument contentDoc;
+
+        contentDoc.setMarkdown(item.content);
         QTextCursor cursor(&contentDoc);
         cursor.select(QTextCursor::Document);
-        qDebug() << "cursor.selectedText()" << cursor.selectedText().count();
         cursor.mergeBlockFormat(m_blockFormat);
         cursor.mergeCharFormat(m_charFormat);
 
-        if (m_includeSynopsis && !synopsisIsEmpty) {
+        if (!synopsisIsEmpty) {
 
 
             cursor.movePosition(QTextCursor::Start);
@@ -348,10 +604,10 @@ void SKRExporter::createContent(QTextDocument *textDocument, int projectId,
         textCursor.insertFragment(QTextDocumentFragment(&contentDoc));
         textCursor.insertBlock(m_blockFormat, m_charFormat);
     }
-
-    emit progressChanged(1);
 }
 
+// --------------------------------------------------------------------------------------
+
 int SKRExporter::textIndent() const
 {
     return m_textIndent;
@@ -5,8 +5,14 @@
 #include <QUrl>
 #include <QTextDocument>
 #include <QTextCharFormat>
+#include <QTextCursor>
+#include <QSharedPointer>
+#include <QVariantMap>
+#include <functional>
 #include "skr.h"
 
+class QFile;
+
 class SKRExporter : public QObject
 {
     Q_OBJECT
@@ -42,6 +48,7 @@ public:
 
     explicit SKRExporter(QObject *parent = nullptr);
     Q_INVOKABLE void run();
+    Q_INVOKABLE QVariantMap lastRunStats() const;
 
 
     bool printEnabled() const;
@@ -111,7 +118,34 @@ signals:
     void textIndentChanged(int value);
 
 private:
-    void createContent(QTextDocument *textDocument, int projectId, int paperId, QList<int> *numbers);
+
+    // what an item needs to be converted, read from the hubs on the main thread
+    struct ExportItem {
+        QString title;
+        int indent = 0;
+        QString tags;
+        QString synopsis;
+        QString content;
+    };
+
+    // an item once converted on the thread pool : text for the streamed
+    // outputs, else a document handed to the consuming thread, to be inserted
+    // in the whole document
+    struct ConvertedItem {
+        QString text;
+        QSharedPointer<QTextDocument> document;
+        int characterCount = 0;
+    };
+
+    bool fetchItem(int projectId, int treeItemId, QList<int> *numbers, ExportItem *item) const;
+    void insertProjectTitle(QTextCursor &textCursor, const QString &projectTitle) const;
+    void insertItem(QTextCursor &textCursor, const ExportItem &item) const;
+    ConvertedItem convertItem(const ExportItem &item) const;
+    void convertItems(const std::function<void(ConvertedItem &)> &consume);
+    QString serialize(QTextDocument *textDocument) const;
+    bool isStreamable() const;
+    void writeStream(const QString &projectTitle, QFile &file);
+    static void formatHeadings(QTextDocument *textDocument, int fontPointSize);
 
 private:
     int m_projectId;
@@ -130,6 +164,7 @@ private:
     bool m_quick;
     int m_textTopMargin;
     int m_textIndent;
+    QVariantMap m_lastRunStats;
 
 };
 
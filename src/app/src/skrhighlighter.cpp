@@ -2,15 +2,31 @@
 #include <QDebug>
 #include <QTextDocument>
 #include <QTextBoundaryFinder>
+#include <QTextBlock>
+#include <QTimer>
+#include <climits>
 #include "plmdata.h"
 
 SKRHighlighter::SKRHighlighter(QTextDocument *parentDoc)
-    : QSyntaxHighlighter(parentDoc), m_spellCheckerSet(false), m_projectId(-2)
+    : QSyntaxHighlighter(parentDoc), m_spellCheckerSet(false), m_projectId(-2),
+    m_backgroundSpellCheckEnabled(false)
 {
     SKRSpellChecker *spellChecker = new SKRSpellChecker(this);
 
     this->setSpellChecker(spellChecker);
 
+    // words met during one highlighting pass are sent together
+    m_backgroundSpellCheckTimer = new QTimer(this);
+    m_backgroundSpellCheckTimer->setSingleShot(true);
+    m_backgroundSpellCheckTimer->setInterval(0);
+    connect(m_backgroundSpellCheckTimer, &QTimer::timeout, this, [this]() {
+        m_spellChecker->spellInBackground(m_wordsToCheckInBackground.values());
+        m_wordsToCheckInBackground.clear();
+    });
+
+    connect(spellChecker, &SKRSpellChecker::backgroundSpellCheckDone, this,
+            &SKRHighlighter::rehighlightPendingBlocks);
+
     connect(plmdata->projectDictHub(),
             &SKRProjectDictHub::projectDictFullyChanged,
             this,
@@ -59,15 +75,9 @@ void SKRHighlighter::highlightBlock(const QString& text)
     setCurrentBlockState(0);
 
 
-    if (text.length() > 7000) { // cancel the highlighting to prevent slowing.
-        qWarning() << "a paragraph is too long for highlighting !";
-        return;
-    }
-
-
     // find  :
 
-    QList<int> findList;
+    QVector<QPair<int, int> > findRanges;
 
     QTextCharFormat findFormat;
 
@@ -76,20 +86,15 @@ void SKRHighlighter::highlightBlock(const QString& text)
     if (!textToHighLight.isEmpty()) {
         int position = 0;
 
-        while (position >= 0) {
+        while (position < text.length()) {
             int start = text.indexOf(textToHighLight, position, sensitivity);
 
             if (start == -1) break;
 
-            //            setFormat(start , textToHighLight.size(), findFormat);
-
-            // list for later merging :
-            for (int i = start; i < start + textToHighLight.size();
-                 ++i) findList.append(i);
+            // range for later merging :
+            findRanges.append(qMakePair(start, start + textToHighLight.size()));
 
-            position = text.indexOf(textToHighLight,
-                                    position + textToHighLight.size(),
-                                    sensitivity);
+            position = start + textToHighLight.size();
         }
 
         setCurrentBlockState(1);
@@ -98,7 +103,8 @@ void SKRHighlighter::highlightBlock(const QString& text)
 
     //    spell check :
 
-    QList<int> spellcheckerList;
+    QVector<QPair<int, int> > spellcheckerRanges;
+    QSet<QString> pendingWords;
 
     QTextCharFormat spellcheckFormat;
 
@@ -135,11 +141,7 @@ void SKRHighlighter::highlightBlock(const QString& text)
                 wordValue = text.mid(wordStart, wordLength);
 
 
-                if (!m_spellChecker->spell(text.mid(wordStart, wordLength))) {
-                    //                setFormat(wordStart, wordLength,
-                    // spellcheckFormat);
-
-
+                if (!this->spell(wordValue, pendingWords)) {
                     if (text.mid(wordStart + wordLength, 1) == "-") { // cerf-volant,
                         // orateur-né
                         wordFinder.toNextBoundary();
@@ -153,14 +155,12 @@ void SKRHighlighter::highlightBlock(const QString& text)
 
                         //                    qDebug() <<
                         // "hyphenWord_Highlighter : " + hyphenWord;
-                        if (!m_spellChecker->spell(text.mid(wordStart,
-                                                            hyphenWord.size()))) {
+                        if (!this->spell(hyphenWord, pendingWords)) {
                             wordLength = hyphenWord.size();
                             wordFinder.toNextBoundary();
                             wordFinder.toNextBoundary();
 
-                            for (int i = wordStart; i < wordStart + wordLength;
-                                 ++i) spellcheckerList.append(i);
+                            spellcheckerRanges.append(qMakePair(wordStart, wordStart + wordLength));
                             continue;
                         }
                         else {
@@ -171,30 +171,151 @@ void SKRHighlighter::highlightBlock(const QString& text)
                     }
 
 
-                    // list for later merging :
-                    for (int i = wordStart; i < wordStart + wordLength;
-                         ++i) spellcheckerList.append(i);
+                    // range for later merging :
+                    spellcheckerRanges.append(qMakePair(wordStart, wordStart + wordLength));
                 }
             }
             setCurrentBlockState(2);
         }
 
+    this->setPendingWords(pendingWords);
+
+
+    this->applyFormatRanges(findRanges, findFormat, spellcheckerRanges, spellcheckFormat);
+
+    emit shakeTextSoHighlightsTakeEffectCalled();
+}
+
+// -------------------------------------------------------------------
+
+///
+/// \brief SKRHighlighter::spell
+/// \param word
+/// \param pendingWords filled with the words sent to the background check
+/// \return false if the word is misspelled. In background mode, words not yet
+/// checked are considered correct until their result comes back.
+bool SKRHighlighter::spell(const QString& word, QSet<QString>& pendingWords)
+{
+    if (!m_backgroundSpellCheckEnabled) {
+        return m_spellChecker->spell(word);
+    }
+
+    bool isCorrect = true;
+
+    if (!m_spellChecker->isSpellCached(word, &isCorrect)) {
+        pendingWords.insert(word);
+        m_wordsToCheckInBackground.insert(word);
+        m_backgroundSpellCheckTimer->start();
+
+        return true;
+    }
+
+    return isCorrect;
+}
+
+// -------------------------------------------------------------------
+
+void SKRHighlighter::setPendingWords(const QSet<QString>& pendingWords)
+{
+    SKRSpellBlockData *blockData = static_cast<SKRSpellBlockData *>(currentBlockUserData());
+
+    if (!blockData) {
+        if (pendingWords.isEmpty()) {
+            return;
+        }
+
+        blockData = new SKRSpellBlockData;
+        setCurrentBlockUserData(blockData);
+    }
+
+    blockData->pendingWords = pendingWords;
+}
+
+// -------------------------------------------------------------------
+
+void SKRHighlighter::rehighlightPendingBlocks(const QStringList& checkedWords)
+{
+    if (!m_backgroundSpellCheckEnabled || !document()) {
+        return;
+    }
+
+    QSet<QString> checkedWordSet(checkedWords.begin(), checkedWords.end());
+
+    for (QTextBlock block = document()->begin(); block.isValid(); block = block.next()) {
+        SKRSpellBlockData *blockData = static_cast<SKRSpellBlockData *>(block.userData());
+
+        if (blockData && blockData->pendingWords.intersects(checkedWordSet)) {
+            this->rehighlightBlock(block);
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+
+///
+/// \brief SKRHighlighter::applyFormatRanges
+/// Both lists hold sorted and non-overlapping [start, end) ranges. They are
+/// swept together so each run of characters sharing the same formats gets a
+/// single setFormat(). The formats of the block were already cleared by
+/// QSyntaxHighlighter, so the runs without format are skipped.
+void SKRHighlighter::applyFormatRanges(const QVector<QPair<int, int> >& firstRanges,
+                                       const QTextCharFormat          & firstFormat,
+                                       const QVector<QPair<int, int> >& secondRanges,
+                                       const QTextCharFormat          & secondFormat)
+{
+    int firstIndex  = 0;
+    int secondIndex = 0;
+    int position    = 0;
+
+    while (true) {
+        while (firstIndex < firstRanges.size() && firstRanges.at(firstIndex).second <= position) {
+            ++firstIndex;
+        }
+
+        while (secondIndex < secondRanges.size() && secondRanges.at(secondIndex).second <= position) {
+            ++secondIndex;
+        }
+
+        bool hasFirst  = firstIndex < firstRanges.size();
+        bool hasSecond = secondIndex < secondRanges.size();
+
+        if (!hasFirst && !hasSecond) {
+            break;
+        }
+
+        bool inFirst  = hasFirst && firstRanges.at(firstIndex).first <= position;
+        bool inSecond = hasSecond && secondRanges.at(secondIndex).first <= position;
+
+        if (!inFirst && !inSecond) {
+            position = qMin(hasFirst ? firstRanges.at(firstIndex).first : INT_MAX,
+                            hasSecond ? secondRanges.at(secondIndex).first : INT_MAX);
+            continue;
+        }
+
+        // the run ends where one of the ranges starts or ends
+        int end = INT_MAX;
+
+        if (hasFirst) {
+            end = qMin(end, inFirst ? firstRanges.at(firstIndex).second : firstRanges.at(firstIndex).first);
+        }
+
+        if (hasSecond) {
+            end = qMin(end, inSecond ? secondRanges.at(secondIndex).second : secondRanges.at(secondIndex).first);
+        }
 
-    for (int k = 0; k < text.length(); ++k) {
         QTextCharFormat finalFormat;
 
-        if (findList.contains(k)){
-            finalFormat.merge(findFormat);
+        if (inFirst) {
+            finalFormat.merge(firstFormat);
         }
 
-        if (spellcheckerList.contains(k)) {
-            finalFormat.merge(spellcheckFormat);
+        if (inSecond) {
+            finalFormat.merge(secondFormat);
         }
 
-        setFormat(k, 1, finalFormat);
+        setFormat(position, end - position, finalFormat);
+        position = end;
     }
-
-    emit shakeTextSoHighlightsTakeEffectCalled();
 }
 
 // -------------------------------------------------------------------
@@ -247,6 +368,23 @@ int SKRHighlighter::getProjectId() const
     return m_projectId;
 }
 
+bool SKRHighlighter::isBackgroundSpellCheckEnabled() const
+{
+    return m_backgroundSpellCheckEnabled;
+}
+
+void SKRHighlighter::setBackgroundSpellCheckEnabled(bool enabled)
+{
+    if (m_backgroundSpellCheckEnabled == enabled) {
+        return;
+    }
+
+    m_backgroundSpellCheckEnabled = enabled;
+    m_wordsToCheckInBackground.clear();
+
+    emit backgroundSpellCheckEnabledChanged(enabled);
+}
+
 void SKRHighlighter::setProjectId(int projectId)
 {
     m_projectId = projectId;
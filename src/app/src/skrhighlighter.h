@@ -23,13 +23,31 @@
 #define SKRHIGHLIGHTER_H
 
 #include <QSyntaxHighlighter>
+#include <QVector>
+#include <QPair>
+#include <QSet>
+#include <QTextBlockUserData>
 #include "skrspellchecker.h"
 
+class QTimer;
+
+///
+/// \brief The SKRSpellBlockData class
+/// Words of the block still waiting for the background spell check. The block
+/// is highlighted again when their results come back.
+class SKRSpellBlockData : public QTextBlockUserData {
+public:
+
+    QSet<QString> pendingWords;
+};
+
 class SKRHighlighter : public QSyntaxHighlighter {
     Q_OBJECT
 
     Q_PROPERTY(SKRSpellChecker * spellChecker READ getSpellChecker)
     Q_PROPERTY(int projectId READ getProjectId WRITE setProjectId NOTIFY projectIdChanged)
+    Q_PROPERTY(
+        bool backgroundSpellCheckEnabled READ isBackgroundSpellCheckEnabled WRITE setBackgroundSpellCheckEnabled NOTIFY backgroundSpellCheckEnabledChanged)
 
 public:
 
@@ -42,6 +60,9 @@ public:
     int              getProjectId() const;
     void             setProjectId(int projectId);
 
+    bool             isBackgroundSpellCheckEnabled() const;
+    void             setBackgroundSpellCheckEnabled(bool enabled);
+
 protected:
 
     void highlightBlock(const QString& text) override;
@@ -49,6 +70,7 @@ protected:
 signals:
 
     void projectIdChanged(int projectId);
+    void backgroundSpellCheckEnabledChanged(bool enabled);
     void suggestionListChanged(QStringList list);
     void suggestionOriginalWordChanged(QString word);
     void shakeTextSoHighlightsTakeEffectCalled();
@@ -57,6 +79,14 @@ public slots:
 private:
 
     void setSpellChecker(SKRSpellChecker *spellChecker);
+    bool spell(const QString& word,
+               QSet<QString>& pendingWords);
+    void setPendingWords(const QSet<QString>& pendingWords);
+    void rehighlightPendingBlocks(const QStringList& checkedWords);
+    void applyFormatRanges(const QVector<QPair<int, int> >& firstRanges,
+                           const QTextCharFormat          & firstFormat,
+                           const QVector<QPair<int, int> >& secondRanges,
+                           const QTextCharFormat          & secondFormat);
 
 private:
 
@@ -66,6 +96,9 @@ private:
     bool m_spellCheckerSet;
     int m_projectId;
     QStringList m_userDictList;
+    bool m_backgroundSpellCheckEnabled;
+    QSet<QString>m_wordsToCheckInBackground;
+    QTimer *m_backgroundSpellCheckTimer;
 };
 
 #endif // SKRHIGHLIGHTER_H
@@ -22,6 +22,8 @@
 #ifndef SKRPAGEINTERFACE_H
 #define SKRPAGEINTERFACE_H
 
+#include <QHash>
+#include <QList>
 #include <QString>
 #include "skrresult.h"
 
@@ -44,6 +46,17 @@ public:
     virtual void      updateCharAndWordCount(int  projectId,
                                              int  treeItemId,
                                              bool sameThread = false) {}
+
+    // when the project is loaded, knownFingerprints being those of the stored counts
+    virtual void      updateAllCharAndWordCount(int                        projectId,
+                                                const QList<int>         & treeItemIds,
+                                                const QHash<int, QString>& knownFingerprints) {
+        Q_UNUSED(knownFingerprints)
+
+        for (int treeItemId : treeItemIds) {
+            this->updateCharAndWordCount(projectId, treeItemId, false);
+        }
+    }
 };
 
 #define SKRPageInterface_iid "com.skribisto.PageInterface/1.0"
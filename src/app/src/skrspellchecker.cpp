@@ -6,6 +6,8 @@
 #include <QDebug>
 #include <QDir>
 #include <QCoreApplication>
+#include <QMutexLocker>
+#include <QThreadPool>
 
 //#ifdef Q_OS_WIN
 //# include "externals/hunspell/hunspell.hxx"
@@ -14,20 +16,27 @@
 #include <hunspell.hxx>
 #include "plmutils.h"
 
+// bounds the memory used by the cache, it is emptied when full
+static const int maxSpellCacheSize = 50000;
+
 SKRSpellChecker::SKRSpellChecker(QObject *parent) :
     QObject(parent), m_isActive(false), m_hunspellLaunched(false), m_encodingFix("utf8"),
-    m_dictionaryPath("")
-{}
+    m_dictionaryPath(""), m_threadPool(new QThreadPool(this)), m_cacheGeneration(0)
+{
+    // one worker is enough, Hunspell is used under a lock anyway
+    m_threadPool->setMaxThreadCount(1);
+}
 
 SKRSpellChecker::~SKRSpellChecker()
 {
+    m_threadPool->clear();
+    m_threadPool->waitForDone();
+
     if (m_hunspellLaunched) delete m_hunspell;
 }
 
 void SKRSpellChecker::setDict(const QString& dictionaryPath)
 {
-    if (m_hunspellLaunched) delete m_hunspell;
-
     m_dictionaryPath = dictionaryPath;
 
     QString dictFile  = dictionaryPath + ".dic";
@@ -41,12 +50,20 @@ void SKRSpellChecker::setDict(const QString& dictionaryPath)
     QByteArray dictFilePathBA  = dictFile.toUtf8();
     QByteArray affixFilePathBA = affixFile.toUtf8();
 
-    m_hunspell = new Hunspell(affixFilePathBA.constData(), dictFilePathBA.constData());
+    {
+        QMutexLocker locker(&m_hunspellMutex);
+
+        if (m_hunspellLaunched) delete m_hunspell;
+
+        m_hunspell = new Hunspell(affixFilePathBA.constData(), dictFilePathBA.constData());
 
 
-    m_encodingFix = this->testHunspellForEncoding();
+        m_encodingFix = this->testHunspellForEncoding();
+
+        m_hunspellLaunched = true;
+    }
 
-    m_hunspellLaunched = true;
+    this->clearSpellCache();
 
     // test :
 
@@ -60,7 +77,127 @@ bool SKRSpellChecker::isHunspellLaunched() const{
     return m_hunspellLaunched;
 }
 
+///
+/// \brief SKRSpellChecker::spell
+/// \param word
+/// \return false if the word is misspelled. The result is cached until the
+/// dictionary or the user dictionary changes.
 bool SKRSpellChecker::spell(const QString& word)
+{
+    QHash<QString, bool>::const_iterator it = m_spellCache.constFind(word);
+
+    if (it != m_spellCache.constEnd()) {
+        return it.value();
+    }
+
+    bool isCorrect = this->spellWithoutCache(word);
+
+    this->cacheSpellResult(word, isCorrect);
+
+    return isCorrect;
+}
+
+// ---------------------------------------------------------------------------------
+
+///
+/// \brief SKRSpellChecker::isSpellCached
+/// \param word
+/// \param isCorrect set to the cached result, if any
+/// \return true if the word was already checked
+bool SKRSpellChecker::isSpellCached(const QString& word, bool *isCorrect) const
+{
+    QHash<QString, bool>::const_iterator it = m_spellCache.constFind(word);
+
+    if (it == m_spellCache.constEnd()) {
+        return false;
+    }
+
+    if (isCorrect) {
+        *isCorrect = it.value();
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------------
+
+///
+/// \brief SKRSpellChecker::spellInBackground
+/// \param words
+/// Checks the words not yet cached on a worker thread. Once they are cached,
+/// backgroundSpellCheckDone() is emitted with them.
+void SKRSpellChecker::spellInBackground(const QStringList& words)
+{
+    QStringList wordsToCheck;
+
+    for (const QString& word : words) {
+        if (m_spellCache.contains(word) || m_queuedWords.contains(word)) {
+            continue;
+        }
+        m_queuedWords.insert(word);
+        wordsToCheck.append(word);
+    }
+
+    if (wordsToCheck.isEmpty()) {
+        return;
+    }
+
+    int generation = m_cacheGeneration;
+
+    m_threadPool->start([this, wordsToCheck, generation]() {
+        QHash<QString, bool> results;
+
+        for (const QString& word : wordsToCheck) {
+            results.insert(word, this->spellWithoutCache(word));
+        }
+
+        QMetaObject::invokeMethod(this, [this, results, generation]() {
+            // the dictionary changed in the meantime
+            if (generation != m_cacheGeneration) {
+                return;
+            }
+
+            QHash<QString, bool>::const_iterator it = results.constBegin();
+
+            while (it != results.constEnd()) {
+                this->cacheSpellResult(it.key(), it.value());
+                m_queuedWords.remove(it.key());
+                ++it;
+            }
+
+            emit backgroundSpellCheckDone(results.keys());
+        }, Qt::QueuedConnection);
+    });
+}
+
+// ---------------------------------------------------------------------------------
+
+void SKRSpellChecker::cacheSpellResult(const QString& word, bool isCorrect)
+{
+    if (m_spellCache.size() >= maxSpellCacheSize) {
+        m_spellCache.clear();
+    }
+
+    m_spellCache.insert(word, isCorrect);
+}
+
+// ---------------------------------------------------------------------------------
+
+void SKRSpellChecker::clearSpellCache()
+{
+    m_spellCache.clear();
+    m_queuedWords.clear();
+    ++m_cacheGeneration;
+}
+
+// ---------------------------------------------------------------------------------
+
+///
+/// \brief SKRSpellChecker::spellWithoutCache
+/// \param word
+/// \return false if Hunspell finds the word misspelled
+/// Can be called from the background worker.
+bool SKRSpellChecker::spellWithoutCache(const QString& word)
 {
     //    qWarning() << "word  : " << word;
     bool f_ignore_numbers   = false;
@@ -129,6 +266,10 @@ Letter:
 
         if (is_word || ((i == count) && (index != -1))) {
             if (!is_uppercase && !is_number) {
+                QMutexLocker locker(&m_hunspellMutex);
+
+                if (!m_hunspellLaunched) return true;
+
                 if (m_encodingFix == "latin1") return m_hunspell->spell(
                         word.toLatin1().toStdString());
 
@@ -151,6 +292,8 @@ QStringList SKRSpellChecker::suggest(const QString& word)
 
     std::vector<std::string> suggestionsVector;
 
+    QMutexLocker locker(&m_hunspellMutex);
+
     if (m_encodingFix == "latin1") suggestionsVector = m_hunspell->suggest(
             word.toLatin1().toStdString());
 
@@ -183,9 +326,15 @@ void SKRSpellChecker::addWordToDict(const QString& word)
 {
     if (word == "") return;
 
-    if (m_encodingFix == "latin1") m_hunspell->add(word.toLatin1().toStdString());
+    {
+        QMutexLocker locker(&m_hunspellMutex);
 
-    if (m_encodingFix == "utf8") m_hunspell->add(word.toUtf8().toStdString());
+        if (m_encodingFix == "latin1") m_hunspell->add(word.toLatin1().toStdString());
+
+        if (m_encodingFix == "utf8") m_hunspell->add(word.toUtf8().toStdString());
+    }
+
+    this->clearSpellCache();
 }
 
 // ---------------------------------------------------------------------------------
@@ -214,9 +363,15 @@ bool SKRSpellChecker::isActive()
 
 void SKRSpellChecker::removeWordFromUserDict(const QString& word, bool emitSignal)
 {
-    if (m_encodingFix == "latin1") m_hunspell->remove(word.toLatin1().toStdString());
+    {
+        QMutexLocker locker(&m_hunspellMutex);
+
+        if (m_encodingFix == "latin1") m_hunspell->remove(word.toLatin1().toStdString());
+
+        if (m_encodingFix == "utf8") m_hunspell->remove(word.toUtf8().toStdString());
+    }
 
-    if (m_encodingFix == "utf8") m_hunspell->remove(word.toUtf8().toStdString());
+    this->clearSpellCache();
 
     m_userDict.removeAll(word);
 
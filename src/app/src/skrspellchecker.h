@@ -27,7 +27,10 @@
 #include <QHash>
 #include <QTextStream>
 #include <QStringList>
+#include <QSet>
+#include <QMutex>
 
+class QThreadPool;
 
 class Hunspell;
 
@@ -47,6 +50,9 @@ public:
     bool                                     isHunspellLaunched() const;
 
     Q_INVOKABLE bool                         spell(const QString& word);
+    bool                                     isSpellCached(const QString& word,
+                                                           bool          *isCorrect = nullptr) const;
+    void                                     spellInBackground(const QStringList& words);
     Q_INVOKABLE QStringList                  suggest(const QString& word);
 
     bool                                     isActive();
@@ -81,12 +87,19 @@ signals:
 
     void suggestionListChanged(QStringList list);
     void suggestionOriginalWordChanged(QString word);
+    void backgroundSpellCheckDone(const QStringList& words);
+
 private:
 
     // fix bug when hunspell gives me latin1 encoded results on several Linux
     // systems :
     QString testHunspellForEncoding();
     void    addWordToDict(const QString& word);
+    bool    spellWithoutCache(const QString& word);
+    void    cacheSpellResult(const QString& word,
+                             bool           isCorrect);
+    void    clearSpellCache();
+
     Hunspell *m_hunspell;
     bool m_isActive, m_hunspellLaunched;
     QStringList m_userDict;
@@ -94,6 +107,15 @@ private:
 
 
     QString m_encodingFix, m_dictionaryPath;
+
+    // Hunspell is shared with the background worker
+    QMutex m_hunspellMutex;
+    QThreadPool *m_threadPool;
+
+    // results for the current dictionary and user dictionary
+    QHash<QString, bool>m_spellCache;
+    QSet<QString>m_queuedWords;
+    int m_cacheGeneration;
 };
 
 #endif // SKRSPELLCHECKER_H
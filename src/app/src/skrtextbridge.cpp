@@ -3,6 +3,8 @@
 #include <QTextCursor>
 #include <QTextDocumentFragment>
 #include <QTextObject>
+#include <QTextBlock>
+#include <QDebug>
 
 
 SKRSyncDocument::SKRSyncDocument() :  m_uniqueDocumentReference(""), m_skrTextAreaUniqueObjectName("")
@@ -113,7 +115,8 @@ void SKRSyncDocument::setUniqueDocumentReference(const QString &uniqueDocumentRe
 // ------SKRTextBridge-----------------------------------------------------------------------
 // --------------------------------------------------------------------------------------
 
-SKRTextBridge::SKRTextBridge(QObject *parent) : QObject(parent)
+SKRTextBridge::SKRTextBridge(QObject *parent) : QObject(parent), m_isApplyingOperation(false),
+    m_resyncCount(0)
 {
     qRegisterMetaType<QList<SKRSyncDocument> >("QList<SKRSyncDocument>");
 }
@@ -124,21 +127,32 @@ void SKRTextBridge::subscribeTextDocument(const QString &uniqueDocumentReference
                                           const QString     & skrTextAreaUniqueObjectName,
                                           QQuickTextDocument *qQuickTextDocument)
 {
+    if (!qQuickTextDocument) {
+        return;
+    }
+
     SKRSyncDocument syncDoc = SKRSyncDocument(uniqueDocumentReference,
                                               skrTextAreaUniqueObjectName,
                                               qQuickTextDocument);
 
-    if (!m_syncDocList.contains(syncDoc)) {
-        m_syncDocList.append(syncDoc);
+    QList<SKRSyncDocument>& syncDocs = m_syncDocsByReferenceHash[uniqueDocumentReference];
+
+    if (!syncDocs.contains(syncDoc)) {
+        syncDocs.append(syncDoc);
     }
     else {
         return;
     }
 
+    QTextDocument *textDocument = qQuickTextDocument->textDocument();
 
-    syncDoc.qQuickTextDocument()->textDocument()->setProperty(
-        "skrTextAreaUniqueObjectName",
-        skrTextAreaUniqueObjectName);
+    m_syncDocByTextDocumentHash.insert(textDocument, syncDoc);
+
+    textDocument->setProperty("skrTextAreaUniqueObjectName",
+                              skrTextAreaUniqueObjectName);
+
+    connect(textDocument, &QObject::destroyed, this, &SKRTextBridge::forgetTextDocument,
+            Qt::UniqueConnection);
 
     this->connectContentsChangeSignal(syncDoc);
 }
@@ -153,8 +167,63 @@ void SKRTextBridge::unsubscribeTextDocument(const QString &uniqueDocumentReferen
                                               skrTextAreaUniqueObjectName,
                                               qQuickTextDocument);
 
-    this->disconnectContentsChangeSignal(syncDoc);
-    m_syncDocList.removeAll(syncDoc);
+    if (qQuickTextDocument) {
+        QTextDocument *textDocument = qQuickTextDocument->textDocument();
+
+        this->disconnectContentsChangeSignal(syncDoc);
+        disconnect(textDocument, &QObject::destroyed, this, &SKRTextBridge::forgetTextDocument);
+
+        if (m_syncDocByTextDocumentHash.value(textDocument) == syncDoc) {
+            m_syncDocByTextDocumentHash.remove(textDocument);
+        }
+    }
+
+    auto it = m_syncDocsByReferenceHash.find(uniqueDocumentReference);
+
+    if (it != m_syncDocsByReferenceHash.end()) {
+        it.value().removeAll(syncDoc);
+
+        if (it.value().isEmpty()) {
+            m_syncDocsByReferenceHash.erase(it);
+        }
+    }
+}
+
+// --------------------------------------------------------------------------------------
+
+void SKRTextBridge::forgetTextDocument(QObject *textDocument)
+{
+    SKRSyncDocument syncDoc = m_syncDocByTextDocumentHash.take(textDocument);
+
+    auto it = m_syncDocsByReferenceHash.find(syncDoc.uniqueDocumentReference());
+
+    if (it == m_syncDocsByReferenceHash.end()) {
+        return;
+    }
+
+    // the QPointer of the destroyed view is already null
+    QList<SKRSyncDocument>& syncDocs = it.value();
+
+    for (int i = syncDocs.size() - 1; i >= 0; --i) {
+        if (!syncDocs.at(i)) {
+            syncDocs.removeAt(i);
+        }
+    }
+
+    if (syncDocs.isEmpty()) {
+        m_syncDocsByReferenceHash.erase(it);
+    }
+}
+
+// --------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTextBridge::resyncCount
+/// \return the number of times a view had to be resynchronized, which
+/// should stay at 0
+int SKRTextBridge::resyncCount() const
+{
+    return m_resyncCount;
 }
 
 // --------------------------------------------------------------------------------------
@@ -163,19 +232,15 @@ bool SKRTextBridge::isThereAnyOtherSimilarSyncDoc(const QString& uniqueDocumentR
                                                   const QString& skrTextAreaUniqueObjectName)
 const
 {
-    bool value = false;
+    const QList<SKRSyncDocument> syncDocs = m_syncDocsByReferenceHash.value(uniqueDocumentReference);
 
-    for (const SKRSyncDocument& syncDoc : m_syncDocList) {
-        value =
-            (syncDoc.uniqueDocumentReference() == uniqueDocumentReference &&
-             syncDoc.skrTextAreaUniqueObjectName() != skrTextAreaUniqueObjectName);
-
-        if (value) {
-            break;
+    for (const SKRSyncDocument& syncDoc : syncDocs) {
+        if (syncDoc.skrTextAreaUniqueObjectName() != skrTextAreaUniqueObjectName) {
+            return true;
         }
     }
 
-    return value;
+    return false;
 }
 
 // --------------------------------------------------------------------------------------
@@ -194,9 +259,10 @@ const
 {
     QList<SKRSyncDocument> list;
 
-    for (const SKRSyncDocument& syncDoc : m_syncDocList) {
-        if ((syncDoc.uniqueDocumentReference() == uniqueDocumentReference) &&
-            (syncDoc.skrTextAreaUniqueObjectName() != skrTextAreaUniqueObjectName)) {
+    const QList<SKRSyncDocument> syncDocs = m_syncDocsByReferenceHash.value(uniqueDocumentReference);
+
+    for (const SKRSyncDocument& syncDoc : syncDocs) {
+        if (syncDoc.skrTextAreaUniqueObjectName() != skrTextAreaUniqueObjectName) {
             list.append(syncDoc);
         }
     }
@@ -236,30 +302,192 @@ void SKRTextBridge::disconnectContentsChangeSignal(const SKRSyncDocument& syncDo
                &SKRTextBridge::useTextBridge);
 }
 
+// --------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTextBridge::readOperation
+/// \param textDocument the edited document
+/// \return the change, read once for all the other views. Text added inside a
+/// block is kept as runs of formatted text, which is much lighter than a
+/// QTextDocumentFragment, needed only when the change spans several blocks.
+SKRTextOperation SKRTextBridge::readOperation(QTextDocument *textDocument,
+                                              int            position,
+                                              int            charsRemoved,
+                                              int            charsAdded) const
+{
+    SKRTextOperation operation;
+
+    // contentsChange() may count the last paragraph separator, which can't be
+    // selected
+    int lastPosition = textDocument->characterCount() - 1;
+
+    operation.position     = qMin(position, lastPosition);
+    operation.charsRemoved = charsRemoved;
+
+    int end = qMin(position + charsAdded, lastPosition);
+
+    if (end <= operation.position) {
+        return operation;
+    }
+
+    QTextBlock block = textDocument->findBlock(operation.position);
+
+    if (block.isValid() && (end < block.position() + block.length())) {
+        for (QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it) {
+            QTextFragment fragment = it.fragment();
+            int fragmentStart      = qMax(fragment.position(), operation.position);
+            int fragmentEnd        = qMin(fragment.position() + fragment.length(), end);
+
+            if (fragmentStart >= fragmentEnd) {
+                continue;
+            }
+
+            operation.textRuns.append(qMakePair(fragment.text().mid(fragmentStart - fragment.position(),
+                                                                    fragmentEnd - fragmentStart),
+                                                fragment.charFormat()));
+        }
+
+        return operation;
+    }
+
+    QTextCursor selectionCursor(textDocument);
+
+    selectionCursor.setPosition(operation.position, QTextCursor::MoveAnchor);
+    selectionCursor.setPosition(end,                QTextCursor::KeepAnchor);
+
+    operation.fragment   = selectionCursor.selection();
+    operation.isFragment = true;
+
+    return operation;
+}
+
+// --------------------------------------------------------------------------------------
+
+void SKRTextBridge::applyOperation(QTextDocument *textDocument, const SKRTextOperation& operation) const
+{
+    int lastPosition = textDocument->characterCount() - 1;
+    int position     = qMin(operation.position, lastPosition);
+
+    QTextCursor cursor(textDocument);
+
+    cursor.beginEditBlock();
+
+    // remove
+    cursor.setPosition(position,                                              QTextCursor::MoveAnchor);
+    cursor.setPosition(qMin(operation.position + operation.charsRemoved, lastPosition), QTextCursor::KeepAnchor);
+    cursor.removeSelectedText();
+
+    // add
+    if (operation.isFragment) {
+        cursor.insertFragment(operation.fragment);
+    }
+    else {
+        for (const QPair<QString, QTextCharFormat>& textRun : operation.textRuns) {
+            cursor.insertText(textRun.first, textRun.second);
+        }
+    }
+
+    cursor.endEditBlock();
+}
+
+// --------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTextBridge::resyncDocument
+/// \param sourceDocument
+/// \param targetDocument
+/// Recovery, only the blocks between the first and the last differing ones are
+/// copied, not the whole document.
+void SKRTextBridge::resyncDocument(QTextDocument *sourceDocument, QTextDocument *targetDocument) const
+{
+    const int sourceBlockCount = sourceDocument->blockCount();
+    const int targetBlockCount = targetDocument->blockCount();
+    const int minBlockCount    = qMin(sourceBlockCount, targetBlockCount);
+
+    // same leading blocks
+    int prefix = 0;
+
+    for (QTextBlock sourceBlock = sourceDocument->firstBlock(), targetBlock = targetDocument->firstBlock();
+         prefix < minBlockCount && sourceBlock.text() == targetBlock.text();
+         sourceBlock = sourceBlock.next(), targetBlock = targetBlock.next()) {
+        prefix += 1;
+    }
+
+    if ((prefix == sourceBlockCount) && (prefix == targetBlockCount)) {
+        return;
+    }
+
+    // same trailing blocks, not overlapping the leading ones
+    int suffix = 0;
+
+    for (QTextBlock sourceBlock = sourceDocument->lastBlock(), targetBlock = targetDocument->lastBlock();
+         suffix < minBlockCount - prefix && sourceBlock.text() == targetBlock.text();
+         sourceBlock = sourceBlock.previous(), targetBlock = targetBlock.previous()) {
+        suffix += 1;
+    }
+
+    // with same leading blocks, the range begins at the separator before the
+    // first differing block, else it ends at the separator after the last one
+    auto blockEnd = [](QTextDocument *document, int blockNumber) {
+                        QTextBlock block = document->findBlockByNumber(blockNumber);
+
+                        return block.position() + block.length() - 1;
+                    };
+
+    auto differingRange = [prefix, suffix, blockEnd](QTextDocument *document) {
+                              const int blockCount = document->blockCount();
+
+                              if (prefix > 0) {
+                                  return qMakePair(blockEnd(document, prefix - 1),
+                                                   blockEnd(document, blockCount - suffix - 1));
+                              }
+
+                              if (suffix > 0) {
+                                  return qMakePair(0, document->findBlockByNumber(blockCount - suffix).position());
+                              }
+
+                              return qMakePair(0, blockEnd(document, blockCount - 1));
+                          };
+
+    const QPair<int, int> sourceRange = differingRange(sourceDocument);
+    const QPair<int, int> targetRange = differingRange(targetDocument);
+
+    QTextCursor sourceCursor(sourceDocument);
+
+    sourceCursor.setPosition(sourceRange.first,  QTextCursor::MoveAnchor);
+    sourceCursor.setPosition(sourceRange.second, QTextCursor::KeepAnchor);
+
+    QTextCursor targetCursor(targetDocument);
+
+    targetCursor.beginEditBlock();
+    targetCursor.setPosition(targetRange.first,  QTextCursor::MoveAnchor);
+    targetCursor.setPosition(targetRange.second, QTextCursor::KeepAnchor);
+    targetCursor.removeSelectedText();
+    targetCursor.insertFragment(sourceCursor.selection());
+    targetCursor.endEditBlock();
+}
+
+// --------------------------------------------------------------------------------------
+
 void SKRTextBridge::useTextBridge(int position, int charsRemoved, int charsAdded)
 {
+    // changes made by the bridge itself
+    if (m_isApplyingOperation) {
+        return;
+    }
+
     if (!this->sender()) {
         qDebug() << this->metaObject()->className() << "no sender";
         return;
     }
 
     // find SKRSyncDocument
-    QTextDocument *textDocument         = static_cast<QTextDocument *>(this->sender());
-    QString skrTextAreaUniqueObjectName = textDocument->property(
-        "skrTextAreaUniqueObjectName").toString();
-
-    SKRSyncDocument senderSyncDoc;
-
-    for (const SKRSyncDocument& syncDoc : qAsConst(m_syncDocList)) {
-        if (syncDoc.skrTextAreaUniqueObjectName() == skrTextAreaUniqueObjectName) {
-            senderSyncDoc = syncDoc;
-            break;
-        }
-    }
+    QTextDocument *textDocument   = static_cast<QTextDocument *>(this->sender());
+    SKRSyncDocument senderSyncDoc = m_syncDocByTextDocumentHash.value(textDocument);
 
     if (!senderSyncDoc) {
         qDebug() << this->metaObject()->className() << "no synDoc found for " <<
-            skrTextAreaUniqueObjectName;
+            textDocument->property("skrTextAreaUniqueObjectName").toString();
         return;
     }
 
@@ -268,57 +496,35 @@ void SKRTextBridge::useTextBridge(int position, int charsRemoved, int charsAdded
     // charsAdded;
 
     // find others similar
-    if (!this->isThereAnyOtherSimilarSyncDoc(senderSyncDoc)) {
+    QList<SKRSyncDocument> otherSyncDocs = this->listOtherSimilarSyncDocs(senderSyncDoc);
+
+    if (otherSyncDocs.isEmpty()) {
         // qDebug() << this->metaObject()->className() << "no other doc to sync
         // with";
         return;
     }
 
+    SKRTextOperation operation = this->readOperation(textDocument, position, charsRemoved, charsAdded);
 
-    QList<SKRSyncDocument> otherSyncDocs = this->listOtherSimilarSyncDocs(senderSyncDoc);
-
-    // get added text
-
-    QTextCursor selectionCursor = textDocument->rootFrame()->firstCursorPosition();
-
-    selectionCursor.setPosition(position,              QTextCursor::MoveAnchor);
-    selectionCursor.setPosition(position + charsAdded, QTextCursor::KeepAnchor);
-
-    //qDebug() << "selectionCursor" << selectionCursor.selectedText();
-
-    QTextDocumentFragment docFragment = selectionCursor.selection();
+    m_isApplyingOperation = true;
 
-    for (const SKRSyncDocument& syncDoc : otherSyncDocs) {
+    for (const SKRSyncDocument& syncDoc : qAsConst(otherSyncDocs)) {
         if (!syncDoc.qQuickTextDocument()) {
             continue;
         }
 
-        this->disconnectContentsChangeSignal(syncDoc);
-
         QTextDocument *otherTextDocument = syncDoc.qQuickTextDocument()->textDocument();
 
-        QTextCursor otherDocSelectionCursor =
-            otherTextDocument->rootFrame()->firstCursorPosition();
-
-        // remove
-        otherDocSelectionCursor.setPosition(position,                QTextCursor::MoveAnchor);
-        otherDocSelectionCursor.setPosition(position + charsRemoved, QTextCursor::KeepAnchor);
-        otherDocSelectionCursor.removeSelectedText();
-
-        // add
-        otherDocSelectionCursor.setPosition(position, QTextCursor::MoveAnchor);
-        otherDocSelectionCursor.insertFragment(docFragment);
+        this->applyOperation(otherTextDocument, operation);
 
-
-        //fail safe :
-        otherDocSelectionCursor.setPosition(position + charsAdded, QTextCursor::MoveAnchor);
-        if(otherDocSelectionCursor.block().text().size() != selectionCursor.block().text().size()){
-            otherTextDocument->setMarkdown(textDocument->toMarkdown());
-            qDebug() << "failsafe used for " << senderSyncDoc.uniqueDocumentReference();
+        // the views were out of sync before this change
+        if (otherTextDocument->characterCount() != textDocument->characterCount()) {
+            this->resyncDocument(textDocument, otherTextDocument);
+            m_resyncCount += 1;
         }
-
-        this->connectContentsChangeSignal(syncDoc);
     }
+
+    m_isApplyingOperation = false;
 }
 
 // --------------------------------------------------------------------------------------
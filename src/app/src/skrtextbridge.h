@@ -5,6 +5,10 @@
 #include <QQuickTextDocument>
 #include <QString>
 #include <QPointer>
+#include <QHash>
+#include <QPair>
+#include <QTextCharFormat>
+#include <QTextDocumentFragment>
 
 class SKRTextBridge;
 struct SKRSyncDocument;
@@ -44,6 +48,24 @@ private:
 Q_DECLARE_METATYPE(SKRSyncDocument)
 
 
+///
+/// \brief The SKRTextOperation struct
+/// One change of a document, read once from the edited view and applied as is
+/// to the other views of the same document.
+struct SKRTextOperation
+{
+    int position     = 0;
+    int charsRemoved = 0;
+
+    // added text staying inside one block, by runs of the same format
+    QList<QPair<QString, QTextCharFormat> >textRuns;
+
+    // added text spanning several blocks, to carry the block formats too
+    QTextDocumentFragment fragment;
+    bool                  isFragment = false;
+};
+
+
 class SKRTextBridge : public QObject {
     Q_OBJECT
 
@@ -58,6 +80,8 @@ public:
                                              const QString     & skrTextAreaUniqueObjectName,
                                              QQuickTextDocument *qQuickTextDocument);
 
+    int              resyncCount() const;
+
 signals:
 
 private:
@@ -78,15 +102,31 @@ private:
     void                  connectContentsChangeSignal(const SKRSyncDocument& syncDoc);
     void                  disconnectContentsChangeSignal(const SKRSyncDocument& syncDoc);
 
+    SKRTextOperation      readOperation(QTextDocument *textDocument,
+                                        int            position,
+                                        int            charsRemoved,
+                                        int            charsAdded) const;
+    void                  applyOperation(QTextDocument          *textDocument,
+                                         const SKRTextOperation& operation) const;
+    void                  resyncDocument(QTextDocument *sourceDocument,
+                                         QTextDocument *targetDocument) const;
+
 private slots:
 
     void useTextBridge(int position,
                        int charsRemoved,
                        int charsAdded);
+    void forgetTextDocument(QObject *textDocument);
 
 private:
 
-    QList<SKRSyncDocument>m_syncDocList;
+    // unique document reference -> views showing it
+    QHash<QString, QList<SKRSyncDocument> >m_syncDocsByReferenceHash;
+    QHash<QObject *, SKRSyncDocument>m_syncDocByTextDocumentHash;
+    bool m_isApplyingOperation;
+
+    // views found out of sync after applying a change, see resyncDocument()
+    int m_resyncCount;
 };
 
 #endif // SKRTEXTBRIDGE_H
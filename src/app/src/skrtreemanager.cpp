@@ -32,6 +32,13 @@ SKRTreeManager::SKRTreeManager(QObject *parent) : QObject(parent)
         QString pageType = plmdata->treeHub()->getType(projectId, treeItemId);
         this->finaliseAfterCreationOfTreeItem(projectId, treeItemId, pageType);
     });
+    connect(plmdata->treeHub(), &SKRTreeHub::treeItemsAdded, this,
+            [this](int projectId, const QList<int>& treeItemIds) {
+        for (int treeItemId : treeItemIds) {
+            QString pageType = plmdata->treeHub()->getType(projectId, treeItemId);
+            this->finaliseAfterCreationOfTreeItem(projectId, treeItemId, pageType);
+        }
+    });
 
 
     connect(plmdata->projectHub(), &PLMProjectHub::projectLoaded, this, [this](int projectId) {
@@ -55,12 +62,10 @@ QUrl SKRTreeManager::getIconUrlFromPageType(const QString& pageType) const
         url = "qrc:///icons/backup/data-warning.svg";
     }
 
-    QList<SKRPageInterface *> pluginList = plmdata->pluginHub()->pluginsByType<SKRPageInterface>();
+    SKRPageInterface *plugin = this->pagePlugin(pageType);
 
-    for (SKRPageInterface *plugin: qAsConst(pluginList)) {
-        if (pageType == plugin->pageType()) {
-            url = plugin->pageTypeIconUrl();
-        }
+    if (plugin) {
+        url = plugin->pageTypeIconUrl();
     }
 
 
@@ -79,17 +84,8 @@ QStringList SKRTreeManager::getPageTypeList(bool constructibleOnly = true) const
 
     stringList << "FOLDER";
 
-
-    QList<SKRPageInterface *> pluginList = plmdata->pluginHub()->pluginsByType<SKRPageInterface>();
-
-    for (SKRPageInterface *plugin: qAsConst(pluginList)) {
-        if (constructibleOnly && !plugin->isConstructible()) {
-            continue;
-        }
-        else {
-            stringList << plugin->pageType();
-        }
-    }
+    // from the metadata, no plugin is loaded
+    stringList << plmdata->pluginHub()->pageTypes(constructibleOnly);
 
     return stringList;
 }
@@ -107,12 +103,10 @@ QString SKRTreeManager::getPageTypeText(const QString& pageType) const
         text = tr("Folder");
     }
 
-    QList<SKRPageInterface *> pluginList = plmdata->pluginHub()->pluginsByType<SKRPageInterface>();
+    SKRPageInterface *plugin = this->pagePlugin(pageType);
 
-    for (SKRPageInterface *plugin: qAsConst(pluginList)) {
-        if (pageType == plugin->pageType()) {
-            text = plugin->visualText();
-        }
+    if (plugin) {
+        text = plugin->visualText();
     }
 
     return text;
@@ -124,13 +118,10 @@ QString SKRTreeManager::getPageDetailText(const QString& pageType) const
 {
     QString text;
 
-    QList<SKRPageInterface *> pluginList = plmdata->pluginHub()->pluginsByType<SKRPageInterface>();
+    SKRPageInterface *plugin = this->pagePlugin(pageType);
 
-    for (SKRPageInterface *plugin: qAsConst(pluginList)) {
-        if (pageType == plugin->pageType()) {
-            text = plugin->pageDetailText();
-            break;
-        }
+    if (plugin) {
+        text = plugin->pageDetailText();
     }
 
     return text;
@@ -140,25 +131,40 @@ QString SKRTreeManager::getPageDetailText(const QString& pageType) const
 
 void SKRTreeManager::updateCharAndWordCount(int projectId, int treeItemId, const QString& pageType, bool sameThread)
 {
-    QList<SKRPageInterface *> pluginList = plmdata->pluginHub()->pluginsByType<SKRPageInterface>();
+    SKRPageInterface *plugin = this->pagePlugin(pageType);
 
-    for (SKRPageInterface *plugin: qAsConst(pluginList)) {
-        if (pageType == plugin->pageType()) {
-            plugin->updateCharAndWordCount(projectId, treeItemId, sameThread);
-            break;
-        }
+    if (plugin) {
+        plugin->updateCharAndWordCount(projectId, treeItemId, sameThread);
     }
 }
 
 // ---------------------------------------------------------------------------------
 
+///
+/// \brief SKRTreeManager::updateAllCharAndWordCount
+/// \param projectId
+/// The stored counts are loaded first, then each page plugin is given all its
+/// items at once and only counts again those whose content changed.
 void SKRTreeManager::updateAllCharAndWordCount(int projectId)
 {
-    QList<int> allIds = plmdata->treeHub()->getAllIds(projectId);
+    plmdata->statHub()->loadStats(projectId);
 
-    for (int treeItemId : qAsConst(allIds)) {
-        QString pageType = plmdata->treeHub()->getType(projectId, treeItemId);
-        this->updateCharAndWordCount(projectId, treeItemId, pageType);
+    const QHash<int, QString> knownFingerprints = plmdata->statHub()->getFingerprints(projectId);
+    const QList<int> allIds                     = plmdata->treeHub()->getAllIds(projectId);
+    const QHash<int, QString> pageTypes         = plmdata->treeHub()->getAllTypes(projectId);
+    QHash<QString, QList<int> > treeItemIdsByPageType;
+
+    for (int treeItemId : allIds) {
+        treeItemIdsByPageType[pageTypes.value(treeItemId)].append(treeItemId);
+    }
+
+    // only the plugins of the page types used by the project are loaded
+    for (auto it = treeItemIdsByPageType.constBegin(); it != treeItemIdsByPageType.constEnd(); ++it) {
+        SKRPageInterface *plugin = this->pagePlugin(it.key());
+
+        if (plugin) {
+            plugin->updateAllCharAndWordCount(projectId, it.value(), knownFingerprints);
+        }
     }
 }
 
@@ -169,16 +175,25 @@ SKRResult SKRTreeManager::finaliseAfterCreationOfTreeItem(int projectId, int tre
 {
     SKRResult result(this);
 
-    QList<SKRPageInterface *> pluginList = plmdata->pluginHub()->pluginsByType<SKRPageInterface>();
+    SKRPageInterface *plugin = this->pagePlugin(pageType);
 
-    for (SKRPageInterface *plugin: qAsConst(pluginList)) {
-        if (pageType == plugin->pageType()) {
-            result = plugin->finaliseAfterCreationOfTreeItem(projectId, treeItemId);
-            break;
-        }
+    if (plugin) {
+        result = plugin->finaliseAfterCreationOfTreeItem(projectId, treeItemId);
     }
 
     return result;
 }
 
 // ---------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeManager::pagePlugin
+/// \param pageType
+/// \return
+/// Only the plugin declaring this page type in its metadata is loaded.
+SKRPageInterface * SKRTreeManager::pagePlugin(const QString& pageType) const
+{
+    return plmdata->pluginHub()->pluginByPageType<SKRPageInterface>(pageType);
+}
+
+// ---------------------------------------------------------------------------------
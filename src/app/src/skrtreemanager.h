@@ -25,6 +25,8 @@
 #include <QObject>
 #include "skrresult.h"
 
+class SKRPageInterface;
+
 class SKRTreeManager : public QObject {
     Q_OBJECT
 
@@ -43,6 +45,7 @@ public:
 
 private:
 
+    SKRPageInterface    * pagePlugin(const QString& pageType) const;
     Q_INVOKABLE SKRResult finaliseAfterCreationOfTreeItem(int            projectId,
                                                           int            treeItemId,
                                                           const QString& pageType);
@@ -98,11 +98,10 @@ QUrl SKRViewManager::getQmlUrlFromPageType(const QString &pageType) const
         url = "qrc:///qml/EmptyPage.qml";
     }
 
-    QList<SKRPageInterface *> pluginList = plmdata->pluginHub()->pluginsByType<SKRPageInterface>();
-    for ( SKRPageInterface *plugin: qAsConst(pluginList)){
-        if(pageType == plugin->pageType()){
-            url = plugin->pageUrl();
-        }
+    // only the plugin of this page type is loaded
+    SKRPageInterface *plugin = plmdata->pluginHub()->pluginByPageType<SKRPageInterface>(pageType);
+    if(plugin){
+        url = plugin->pageUrl();
     }
 
     return url;
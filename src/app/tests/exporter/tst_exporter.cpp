@@ -0,0 +1,148 @@
+#include <QString>
+#include <QtTest>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTextDocument>
+
+#include "plmdata.h"
+#include "skrexporter.h"
+
+class ExporterCase : public QObject {
+    Q_OBJECT
+
+public:
+
+    ExporterCase();
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    // html
+    void htmlKeepsSpaces_data();
+    void htmlKeepsSpaces();
+
+    // whole document
+    void odtExport();
+
+private:
+
+    QString exportItem(SKRExporter::OutputType outputType,
+                       const QString         & suffix,
+                       bool                    quick);
+
+private:
+
+    PLMData *m_data;
+    int m_projectId;
+    int m_treeItemId;
+    QTemporaryDir m_dir;
+};
+
+ExporterCase::ExporterCase() : m_data(nullptr), m_projectId(-2), m_treeItemId(-2)
+{}
+
+void ExporterCase::initTestCase()
+{
+    m_data = new PLMData(this);
+
+    SKRResult result = plmdata->projectHub()->loadProject(QUrl("qrc:/testfiles/skribisto_test_project.skrib"), true);
+
+    QVERIFY(result.isSuccess());
+    m_projectId = result.getData("projectId", -2).toInt();
+
+    const QList<int> ids = plmdata->treeHub()->getAllIds(m_projectId);
+
+    for (int id : ids) {
+        if (plmdata->treeHub()->getType(m_projectId, id) == "TEXT") {
+            m_treeItemId = id;
+            break;
+        }
+    }
+    QVERIFY(m_treeItemId != -2);
+
+    QVERIFY(plmdata->treeHub()->setPrimaryContent(m_projectId, m_treeItemId, "two  spaces").isSuccess());
+}
+
+void ExporterCase::cleanupTestCase()
+{
+    plmdata->projectHub()->closeProject(m_projectId);
+}
+
+// ------------------------------------------------------------------------------------
+
+void ExporterCase::htmlKeepsSpaces_data()
+{
+    QTest::addColumn<bool>("quick");
+
+    QTest::newRow("with the project title") << false;
+    QTest::newRow("quick") << true;
+}
+
+///
+/// \brief ExporterCase::htmlKeepsSpaces
+/// the items are converted one by one, the page around them must still keep
+/// the repeated spaces and the default font
+void ExporterCase::htmlKeepsSpaces()
+{
+    QFETCH(bool, quick);
+
+    QString html = this->exportItem(SKRExporter::Html, "html", quick);
+
+    QVERIFY(html.contains("white-space: pre-wrap"));
+    QVERIFY(html.contains("<body style="));
+    QCOMPARE(html.count("<body"), 1);
+    QCOMPARE(html.count("</html>"), 1);
+
+    QTextDocument document;
+
+    document.setHtml(html);
+    QVERIFY(document.toPlainText().contains("two  spaces"));
+}
+
+// ------------------------------------------------------------------------------------
+
+void ExporterCase::odtExport()
+{
+    SKRExporter exporter;
+
+    exporter.setProjectId(m_projectId);
+    exporter.setTreeItemIdList(plmdata->treeHub()->getAllIds(m_projectId));
+    exporter.setOutputType(SKRExporter::Odt);
+    exporter.setOutputUrl(QUrl::fromLocalFile(m_dir.filePath("export.odt")));
+    exporter.run();
+
+    QVERIFY(QFileInfo(m_dir.filePath("export.odt")).size() > 0);
+    QCOMPARE(exporter.lastRunStats().value("streamed").toBool(), false);
+    QVERIFY(exporter.lastRunStats().value("characterCount").toInt() > 1);
+}
+
+// ------------------------------------------------------------------------------------
+
+QString ExporterCase::exportItem(SKRExporter::OutputType outputType, const QString& suffix, bool quick)
+{
+    const QString fileName = m_dir.filePath("export." + suffix);
+    SKRExporter   exporter;
+
+    exporter.setProjectId(m_projectId);
+    exporter.setTreeItemIdList(QList<int>({ m_treeItemId }));
+    exporter.setOutputType(outputType);
+    exporter.setOutputUrl(QUrl::fromLocalFile(fileName));
+    exporter.setQuick(quick);
+    exporter.run();
+
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    return QString::fromUtf8(file.readAll());
+}
+
+QTEST_MAIN(ExporterCase)
+
+#include "tst_exporter.moc"
@@ -0,0 +1,116 @@
+#include <QString>
+#include <QtTest>
+#include <QDebug>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QTextLayout>
+
+#include "plmdata.h"
+#include "skrhighlighter.h"
+#include "skrspellchecker.h"
+
+class HighlighterCase : public QObject {
+    Q_OBJECT
+
+public:
+
+    HighlighterCase();
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    // long blocks
+    void highlightLongBlocks_data();
+    void highlightLongBlocks();
+
+private:
+
+    QString createBlock(int characterCount) const;
+
+private:
+
+    PLMData *m_data;
+};
+
+HighlighterCase::HighlighterCase() : m_data(nullptr)
+{}
+
+void HighlighterCase::initTestCase()
+{
+    // the highlighter follows the project dictionaries
+    m_data = new PLMData(this);
+}
+
+void HighlighterCase::cleanupTestCase()
+{}
+
+// ------------------------------------------------------------------------------------
+
+void HighlighterCase::highlightLongBlocks_data()
+{
+    QTest::addColumn<QString>("textToHighlight");
+    QTest::addColumn<bool>("spellCheck");
+
+    QTest::newRow("50k characters blocks") << QString() << false;
+    QTest::newRow("50k characters blocks, find") << QString("dolor") << false;
+    QTest::newRow("50k characters blocks, find and spell check") << QString("dolor") << true;
+}
+
+///
+/// \brief HighlighterCase::highlightLongBlocks
+/// blocks over 7000 characters used to be skipped, they are highlighted in one
+/// sweep of the format ranges now
+void HighlighterCase::highlightLongBlocks()
+{
+    QFETCH(QString, textToHighlight);
+    QFETCH(bool,    spellCheck);
+
+    const QString block = this->createBlock(50000);
+    QTextDocument document;
+
+    document.setPlainText(QStringList({ block, block, block, block }).join('\n'));
+
+    SKRHighlighter *highlighter = new SKRHighlighter(&document);
+
+    highlighter->setCaseSensitivity(false);
+
+    if (spellCheck) {
+        const QStringList dictPathList = SKRSpellChecker::dictPathList();
+
+        if (dictPathList.isEmpty()) {
+            delete highlighter;
+            QSKIP("no Hunspell dictionary installed");
+        }
+
+        highlighter->getSpellChecker()->setDict(dictPathList.first());
+        QVERIFY(highlighter->getSpellChecker()->activate());
+    }
+
+    QBENCHMARK {
+        highlighter->setTextToHighlight(textToHighlight);
+    }
+
+    // one format per match when there is nothing else to merge with
+    if (!spellCheck) {
+        for (QTextBlock textBlock = document.firstBlock(); textBlock.isValid(); textBlock = textBlock.next()) {
+            QCOMPARE(textBlock.layout()->formats().size(),
+                     textToHighlight.isEmpty() ? 0 : textBlock.text().count(textToHighlight));
+        }
+    }
+
+    delete highlighter;
+}
+
+// ------------------------------------------------------------------------------------
+
+QString HighlighterCase::createBlock(int characterCount) const
+{
+    return QString("lorem ipsum dolor sit amet, consectetur adipiscing elit ")
+           .repeated(characterCount / 56 + 1).left(characterCount);
+}
+
+QTEST_MAIN(HighlighterCase)
+
+#include "tst_highlighter.moc"
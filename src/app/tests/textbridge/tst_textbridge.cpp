@@ -0,0 +1,219 @@
+#include <QString>
+#include <QtTest>
+#include <QDebug>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QQuickTextDocument>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QTextDocumentFragment>
+
+#include "skrtextbridge.h"
+
+class TextBridgeCase : public QObject {
+    Q_OBJECT
+
+public:
+
+    TextBridgeCase();
+
+private Q_SLOTS:
+
+    void init();
+    void cleanup();
+
+    // typing
+    void keystroke_data();
+    void keystroke();
+    void multiBlockPaste();
+
+    // recovery
+    void outOfSyncView();
+
+private:
+
+    void               createViews(int viewCount,
+                                   int characterCount);
+    QQuickTextDocument* view(int index) const;
+    QString            createText(int characterCount) const;
+    void               compareViews() const;
+
+private:
+
+    QQmlEngine *m_engine;
+    SKRTextBridge *m_textBridge;
+    QList<QObject *>m_textEdits;
+};
+
+TextBridgeCase::TextBridgeCase() : m_engine(nullptr), m_textBridge(nullptr)
+{}
+
+void TextBridgeCase::init()
+{
+    m_engine     = new QQmlEngine(this);
+    m_textBridge = new SKRTextBridge(this);
+}
+
+void TextBridgeCase::cleanup()
+{
+    qDeleteAll(m_textEdits);
+    m_textEdits.clear();
+
+    delete m_textBridge;
+    m_textBridge = nullptr;
+    delete m_engine;
+    m_engine = nullptr;
+}
+
+// ------------------------------------------------------------------------------------
+
+void TextBridgeCase::keystroke_data()
+{
+    QTest::addColumn<int>("viewCount");
+    QTest::addColumn<int>("characterCount");
+
+    QTest::newRow("2 views, 100k characters") << 2 << 100000;
+    QTest::newRow("4 views, 100k characters") << 4 << 100000;
+}
+
+///
+/// \brief TextBridgeCase::keystroke
+/// one character typed in the middle of the first view, the others follow
+void TextBridgeCase::keystroke()
+{
+    QFETCH(int, viewCount);
+    QFETCH(int, characterCount);
+
+    this->createViews(viewCount, characterCount);
+
+    QTextCursor cursor(view(0)->textDocument());
+
+    cursor.setPosition(characterCount / 2);
+
+    int keystroke = 0;
+
+    QBENCHMARK {
+        cursor.insertText(QString(QChar('a' + keystroke % 26)));
+        keystroke += 1;
+    }
+
+    this->compareViews();
+    QCOMPARE(m_textBridge->resyncCount(), 0);
+}
+
+// ------------------------------------------------------------------------------------
+
+void TextBridgeCase::multiBlockPaste()
+{
+    this->createViews(4, 100000);
+
+    QTextDocument pasted;
+
+    pasted.setPlainText("first pasted line\nsecond pasted line\nthird pasted line");
+
+    QTextCursor cursor(view(1)->textDocument());
+
+    cursor.setPosition(12345);
+    cursor.insertFragment(QTextDocumentFragment(&pasted));
+
+    // and removed over several blocks
+    cursor.setPosition(500);
+    cursor.setPosition(5000, QTextCursor::KeepAnchor);
+    cursor.removeSelectedText();
+
+    this->compareViews();
+    QCOMPARE(m_textBridge->resyncCount(), 0);
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief TextBridgeCase::outOfSyncView
+/// a view changed while not subscribed is repaired at the next change, by
+/// copying only the differing blocks
+void TextBridgeCase::outOfSyncView()
+{
+    this->createViews(2, 100000);
+
+    m_textBridge->unsubscribeTextDocument("document", "view_1", view(1));
+
+    QTextCursor outOfSyncCursor(view(1)->textDocument());
+
+    outOfSyncCursor.movePosition(QTextCursor::End);
+    outOfSyncCursor.insertText("\nonly in the second view");
+
+    m_textBridge->subscribeTextDocument("document", "view_1", view(1));
+
+    QTextCursor cursor(view(0)->textDocument());
+
+    cursor.setPosition(10);
+    cursor.insertText("typed");
+
+    this->compareViews();
+    QCOMPARE(m_textBridge->resyncCount(), 1);
+}
+
+// ------------------------------------------------------------------------------------
+
+void TextBridgeCase::createViews(int viewCount, int characterCount)
+{
+    QQmlComponent component(m_engine);
+
+    component.setData("import QtQuick 2.15\nTextEdit { textFormat: TextEdit.RichText }", QUrl());
+
+    const QString text = this->createText(characterCount);
+
+    for (int i = 0; i < viewCount; i++) {
+        QObject *textEdit = component.create();
+
+        QVERIFY2(textEdit, qPrintable(component.errorString()));
+        m_textEdits.append(textEdit);
+
+        QQuickTextDocument *textDocument = view(i);
+
+        QVERIFY(textDocument);
+        textDocument->textDocument()->setPlainText(text);
+    }
+
+    for (int i = 0; i < viewCount; i++) {
+        m_textBridge->subscribeTextDocument("document", QString("view_%1").arg(i), view(i));
+    }
+}
+
+QQuickTextDocument * TextBridgeCase::view(int index) const
+{
+    return m_textEdits.at(index)->property("textDocument").value<QQuickTextDocument *>();
+}
+
+///
+/// \brief TextBridgeCase::createText
+/// paragraphs of 100 characters
+QString TextBridgeCase::createText(int characterCount) const
+{
+    QString paragraph = QString("lorem ipsum dolor sit amet ").repeated(4).left(99);
+    QString text;
+
+    text.reserve(characterCount);
+
+    while (text.size() + 100 <= characterCount) {
+        text.append(paragraph);
+        text.append('\n');
+    }
+
+    return text;
+}
+
+void TextBridgeCase::compareViews() const
+{
+    const QString text = view(0)->textDocument()->toPlainText();
+
+    for (int i = 1; i < m_textEdits.size(); i++) {
+        QCOMPARE(view(i)->textDocument()->toPlainText(), text);
+    }
+}
+
+QTEST_MAIN(TextBridgeCase)
+
+#include "tst_textbridge.moc"
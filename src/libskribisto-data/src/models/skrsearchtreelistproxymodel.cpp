@@ -6,8 +6,9 @@ SKRSearchTreeListProxyModel::SKRSearchTreeListProxyModel()
     :
     QSortFilterProxyModel(),
     m_showTrashedFilter(true), m_showNotTrashedFilter(true), m_navigateByBranchesEnabled(
-        false), m_textFilter(""),
-    m_projectIdFilter(-2), m_parentIdFilter(-2), m_showParentWhenParentIdFilter(false)
+        false), m_textFilter(""), m_fullTextFilter(""), m_isFullTextFilterRefreshPlanned(false),
+    m_projectIdFilter(-2), m_parentIdFilter(-2), m_showParentWhenParentIdFilter(false),
+    m_isTagFilterCacheOutdated(true), m_isAttributeFilterCacheOutdated(true)
 {
     this->setSourceModel(skrmodels->treeListModel());
 
@@ -34,9 +35,64 @@ SKRSearchTreeListProxyModel::SKRSearchTreeListProxyModel()
         this->clearHistory(projectId);
     });
     connect(plmdata->projectHub(), &PLMProjectHub::projectClosed, this, [this]() {
+        m_isTagFilterCacheOutdated       = true;
+        m_isAttributeFilterCacheOutdated = true;
         this->invalidateFilter();
     });
 
+    // search again once the typing settles
+    auto planFullTextFilterRefresh = [this](int projectId) {
+                                         if (m_fullTextFilter.isEmpty() ||
+                                             ((m_projectIdFilter != -2) && (projectId != m_projectIdFilter)) ||
+                                             m_isFullTextFilterRefreshPlanned) {
+                                             return;
+                                         }
+                                         m_isFullTextFilterRefreshPlanned = true;
+
+                                         QTimer::singleShot(300, this, [this] {
+            m_isFullTextFilterRefreshPlanned = false;
+            this->updateFullTextFilterIds();
+            this->invalidateFilter();
+        });
+                                     };
+
+    connect(m_treeHub, &SKRTreeHub::titleChanged, this, planFullTextFilterRefresh);
+
+    // tag and attribute caches
+    auto outdateTagFilterCache = [this](int projectId) {
+                                     if (projectId == m_projectIdFilter) {
+                                         m_isTagFilterCacheOutdated = true;
+                                     }
+                                 };
+
+    connect(plmdata->tagHub(), &SKRTagHub::tagRelationshipChanged, this, outdateTagFilterCache);
+    connect(plmdata->tagHub(), &SKRTagHub::tagRelationshipRemoved, this, outdateTagFilterCache);
+    connect(plmdata->tagHub(), &SKRTagHub::tagRemoved,             this, outdateTagFilterCache);
+
+    connect(m_propertyHub, &SKRPropertyHub::propertyChanged, this,
+            [this](int projectId, int propertyId, int treeItemCode, const QString& name) {
+        Q_UNUSED(propertyId)
+        Q_UNUSED(treeItemCode)
+
+        if ((projectId == m_projectIdFilter) && (name == "attributes")) {
+            m_isAttributeFilterCacheOutdated = true;
+        }
+    });
+    connect(m_propertyHub, &SKRPropertyHub::propertyRemoved, this, [this](int projectId) {
+        if (projectId == m_projectIdFilter) {
+            m_isAttributeFilterCacheOutdated = true;
+        }
+    });
+
+    connect(m_treeHub, &SKRTreeHub::primaryContentChanged, this, planFullTextFilterRefresh);
+    connect(m_treeHub, &SKRTreeHub::secondaryContentChanged, this, planFullTextFilterRefresh);
+
+    // a search through all the projects covers the ones loaded later
+    connect(plmdata->projectHub(), &PLMProjectHub::projectLoaded, this, planFullTextFilterRefresh);
+    connect(plmdata->projectHub(), &PLMProjectHub::projectClosed, this, [this](int projectId) {
+        m_fullTextFilterIdsByProject.remove(projectId);
+    });
+
 
     // connect this proxy model to all other proxy models using the main model
 
@@ -65,6 +121,7 @@ SKRSearchTreeListProxyModel * SKRSearchTreeListProxyModel::clone()
     newInstance->setShowNotTrashedFilter(m_showNotTrashedFilter);
     newInstance->setNavigateByBranchesEnabled(m_navigateByBranchesEnabled);
     newInstance->setTextFilter(m_textFilter);
+    newInstance->setFullTextFilter(m_fullTextFilter);
     newInstance->setTreeItemIdListFilter(m_treeItemIdListFilter);
     newInstance->setHideTreeItemIdListFilter(m_hideTreeItemIdListFilter);
     newInstance->setForcedCurrentIndex(m_forcedCurrentIndex);
@@ -340,8 +397,8 @@ void SKRSearchTreeListProxyModel::determineCheckStateOfAllAncestors(
 
 void SKRSearchTreeListProxyModel::setTagIdListFilter(const QList<int>& tagIdListFilter)
 {
-    m_tagIdListFilter = tagIdListFilter;
-
+    m_tagIdListFilter          = tagIdListFilter;
+    m_isTagFilterCacheOutdated = true;
 
     emit tagIdListFilterChanged(tagIdListFilter);
 
@@ -352,7 +409,8 @@ void SKRSearchTreeListProxyModel::setTagIdListFilter(const QList<int>& tagIdList
 
 void SKRSearchTreeListProxyModel::setHideThoseWithAttributesFilter(const QStringList& hideThoseWithAttributesFilter)
 {
-    m_hideThoseWithAttributesFilter = hideThoseWithAttributesFilter;
+    m_hideThoseWithAttributesFilter  = hideThoseWithAttributesFilter;
+    m_isAttributeFilterCacheOutdated = true;
 
     emit hideThoseWithAttributesFilterChanged(hideThoseWithAttributesFilter);
 
@@ -363,7 +421,8 @@ void SKRSearchTreeListProxyModel::setHideThoseWithAttributesFilter(const QString
 
 void SKRSearchTreeListProxyModel::setShowOnlyWithAttributesFilter(const QStringList& showOnlyWithAttributesFilter)
 {
-    m_showOnlyWithAttributesFilter = showOnlyWithAttributesFilter;
+    m_showOnlyWithAttributesFilter   = showOnlyWithAttributesFilter;
+    m_isAttributeFilterCacheOutdated = true;
 
     emit showOnlyWithAttributesFilterChanged(showOnlyWithAttributesFilter);
 
@@ -414,11 +473,14 @@ void SKRSearchTreeListProxyModel::setCheckedIdsList(const QList<int>checkedIdsLi
         return;
     }
 
+    // the child states of all items at once
+    const QHash<int, int> childStateHash = m_treeHub->getAllChildStates(m_projectIdFilter);
+
     for (int i = checkedIdsList.count() - 1; i >= 0; i--) {
         int treeItemId = checkedIdsList[i];
 
 
-        if (!this->hasChildren(m_projectIdFilter, treeItemId)) {
+        if (!this->isChildStateShown(childStateHash.value(treeItemId, SKRTreeTopology::NoChild))) {
             m_checkedIdsHash.insert(treeItemId, Qt::Checked);
         }
         else { // has children so verify if there is one checked or partially
@@ -600,11 +662,14 @@ bool SKRSearchTreeListProxyModel::filterAcceptsRow(int                sourceRow,
         return false;
     }
 
-    // project filtering :
+    // project filtering, a full-text search without project goes through all of them :
     if (value &&
         (item->data(SKRTreeItem::Roles::ProjectIdRole).toInt() == m_projectIdFilter)) {
         value = true;
     }
+    else if (value && (m_projectIdFilter == -2) && !m_fullTextFilter.isEmpty()) {
+        value = true;
+    }
     else if (value) {
         value = false;
     }
@@ -632,6 +697,12 @@ bool SKRSearchTreeListProxyModel::filterAcceptsRow(int                sourceRow,
 
     int treeItemId = item->data(SKRTreeItem::Roles::TreeItemIdRole).toInt();
 
+    // full-text filtering :
+    if (value && !m_fullTextFilter.isEmpty() &&
+        !m_fullTextFilterIdsByProject.value(item->data(SKRTreeItem::Roles::ProjectIdRole).toInt()).contains(treeItemId)) {
+        value = false;
+    }
+
     // treeItemIdListFiltering :
     if (value && (!m_treeItemIdListFilter.isEmpty() || !m_hideTreeItemIdListFilter.isEmpty())) {
         int showed = false;
@@ -683,29 +754,21 @@ bool SKRSearchTreeListProxyModel::filterAcceptsRow(int                sourceRow,
     // tagId filtering
 
     if (value && !m_tagIdListFilter.isEmpty() && (m_projectIdFilter != -2)) {
-        QList<int> tagIds = plmdata->tagHub()->getTagsFromItemId(m_projectIdFilter, treeItemId);
-
-        value = false;
-
-        int tagCountGoal = m_tagIdListFilter.count();
-        int tagCount     = 0;
-
-        for (int tag : qAsConst(tagIds)) {
-            if (m_tagIdListFilter.contains(tag)) {
-                tagCount += 1;
-            }
+        if (m_isTagFilterCacheOutdated) {
+            this->updateTagFilterCache();
         }
 
-        if (tagCount == tagCountGoal) {
-            value = true;
-        }
+        value = m_idsWithAllFilterTags.contains(treeItemId);
     }
 
     //  attribute filtering
     if (value && (!m_showOnlyWithAttributesFilter.isEmpty() || !m_hideThoseWithAttributesFilter.isEmpty()) &&
         (m_projectIdFilter != -2)) {
-        QStringList attributes = m_propertyHub->getProperty(m_projectIdFilter, treeItemId, "attributes").split(";",
-                                                                                                               Qt::SkipEmptyParts);
+        if (m_isAttributeFilterCacheOutdated) {
+            this->updateAttributeFilterCache();
+        }
+
+        const QStringList attributes = m_attributesByTreeItemHash.value(treeItemId);
 
         int showed = false;
 
@@ -747,9 +810,67 @@ void SKRSearchTreeListProxyModel::setProjectIdFilter(int projectIdFilter)
     m_parentIdFilter = -2;
     emit parentIdFilterChanged(m_parentIdFilter);
 
+    m_isTagFilterCacheOutdated       = true;
+    m_isAttributeFilterCacheOutdated = true;
+
+    this->updateFullTextFilterIds();
     this->invalidateFilter();
 }
 
+// --------------------------------------------------------------
+
+///
+/// \brief SKRSearchTreeListProxyModel::updateTagFilterCache
+/// the ids of the items holding every tag of the filter, from one query
+void SKRSearchTreeListProxyModel::updateTagFilterCache() const
+{
+    m_idsWithAllFilterTags.clear();
+    m_isTagFilterCacheOutdated = false;
+
+    const QHash<int, QList<int> > tagsByTreeItemHash = plmdata->tagHub()->getTagsForAllItems(m_projectIdFilter);
+    const QSet<int> wantedTagIds(m_tagIdListFilter.begin(), m_tagIdListFilter.end());
+
+    QHash<int, QList<int> >::const_iterator i = tagsByTreeItemHash.constBegin();
+
+    while (i != tagsByTreeItemHash.constEnd()) {
+        int tagCount = 0;
+
+        for (int tagId : i.value()) {
+            if (wantedTagIds.contains(tagId)) {
+                tagCount += 1;
+            }
+        }
+
+        if (tagCount == m_tagIdListFilter.count()) {
+            m_idsWithAllFilterTags.insert(i.key());
+        }
+        ++i;
+    }
+}
+
+// --------------------------------------------------------------
+
+///
+/// \brief SKRSearchTreeListProxyModel::updateAttributeFilterCache
+/// the attributes of all the items, from one query
+void SKRSearchTreeListProxyModel::updateAttributeFilterCache() const
+{
+    m_attributesByTreeItemHash.clear();
+    m_isAttributeFilterCacheOutdated = false;
+
+    const QHash<int, QHash<QString, QString> > propertiesByTreeItemHash =
+        m_propertyHub->getPropertiesForAllItems(m_projectIdFilter, QStringList() << "attributes");
+
+    m_attributesByTreeItemHash.reserve(propertiesByTreeItemHash.count());
+
+    QHash<int, QHash<QString, QString> >::const_iterator i = propertiesByTreeItemHash.constBegin();
+
+    while (i != propertiesByTreeItemHash.constEnd()) {
+        m_attributesByTreeItemHash.insert(i.key(), i.value().value("attributes").split(";", Qt::SkipEmptyParts));
+        ++i;
+    }
+}
+
 // --------------------------------------------------------------
 // TODO: complete this :
 void SKRSearchTreeListProxyModel::clearFilters()
@@ -766,6 +887,10 @@ void SKRSearchTreeListProxyModel::clearFilters()
     m_textFilter = "";
     emit textFilterChanged(m_textFilter);
 
+    m_fullTextFilter = "";
+    m_fullTextFilterIdsByProject.clear();
+    emit fullTextFilterChanged(m_fullTextFilter);
+
     m_parentIdFilter = -2;
     emit parentIdFilterChanged(m_parentIdFilter);
 
@@ -1036,6 +1161,50 @@ void SKRSearchTreeListProxyModel::setTextFilter(const QString& value)
 
 // ----------------------------------------------------------------------------------
 
+///
+/// \brief SKRSearchTreeListProxyModel::setFullTextFilter
+/// \param value
+/// keep only the items whose title, contents or tags hold every word of value
+void SKRSearchTreeListProxyModel::setFullTextFilter(const QString& value)
+{
+    m_fullTextFilter = value;
+    emit fullTextFilterChanged(value);
+
+    this->updateFullTextFilterIds();
+    this->invalidateFilter();
+}
+
+// ----------------------------------------------------------------------------------
+
+///
+/// \brief SKRSearchTreeListProxyModel::updateFullTextFilterIds
+/// without a project filter, every loaded project is searched
+void SKRSearchTreeListProxyModel::updateFullTextFilterIds()
+{
+    m_fullTextFilterIdsByProject.clear();
+
+    if (m_fullTextFilter.isEmpty()) {
+        return;
+    }
+
+    QList<int> projectIds;
+
+    if (m_projectIdFilter == -2) {
+        projectIds = plmdata->projectHub()->getProjectIdList();
+    }
+    else {
+        projectIds << m_projectIdFilter;
+    }
+
+    for (int projectId : qAsConst(projectIds)) {
+        const QList<int> ids = plmdata->searchHub()->getRankedIds(projectId, m_fullTextFilter);
+
+        m_fullTextFilterIdsByProject.insert(projectId, QSet<int>(ids.begin(), ids.end()));
+    }
+}
+
+// ----------------------------------------------------------------------------------
+
 QList<int>SKRSearchTreeListProxyModel::getChildrenList(int  projectId,
                                                        int  treeItemId,
                                                        bool getTrashed,
@@ -1155,6 +1324,18 @@ bool SKRSearchTreeListProxyModel::hasChildren(int projectId, int treeItemId) con
 
 // --------------------------------------------------------------
 
+///
+/// \brief SKRSearchTreeListProxyModel::isChildStateShown
+/// \param childState SKRTreeTopology::ChildState flags
+/// \return true if one of these children passes the trashed filters, like hasChildren()
+bool SKRSearchTreeListProxyModel::isChildStateShown(int childState) const
+{
+    return (m_showTrashedFilter && (childState & SKRTreeTopology::HasTrashedChild)) ||
+           (m_showNotTrashedFilter && (childState & SKRTreeTopology::HasNotTrashedChild));
+}
+
+// --------------------------------------------------------------
+
 int SKRSearchTreeListProxyModel::findVisualIndex(int projectId, int treeItemId)
 {
     int rowCount = this->rowCount(QModelIndex());
@@ -3,6 +3,8 @@
 
 #include <QObject>
 #include <QSortFilterProxyModel>
+#include <QSet>
+#include <QHash>
 #include "skrtreeitem.h"
 #include "skrtreelistmodel.h"
 #include "./skribisto_data_global.h"
@@ -19,6 +21,8 @@ class EXPORT SKRSearchTreeListProxyModel : public QSortFilterProxyModel {
         bool navigateByBranchesEnabled MEMBER m_navigateByBranchesEnabled WRITE setNavigateByBranchesEnabled NOTIFY navigateByBranchesEnabledChanged)
     Q_PROPERTY(
         QString textFilter MEMBER m_textFilter WRITE setTextFilter NOTIFY textFilterChanged)
+    Q_PROPERTY(
+        QString fullTextFilter MEMBER m_fullTextFilter WRITE setFullTextFilter NOTIFY fullTextFilterChanged)
     Q_PROPERTY(
         QList<int>treeItemIdListFilter MEMBER m_treeItemIdListFilter WRITE setTreeItemIdListFilter NOTIFY treeItemIdListFilterChanged)
     Q_PROPERTY(
@@ -92,6 +96,7 @@ public:
     void                  setNavigateByBranchesEnabled(bool navigateByBranches);
 
     void                  setTextFilter(const QString& value);
+    void                  setFullTextFilter(const QString& value);
     void                  setParentIdFilter(int parentIdFilter);
     void                  setShowParentWhenParentIdFilter(bool showParent);
 
@@ -165,6 +170,7 @@ signals:
 
     void projectIdFilterChanged(int projectIdFilter);
     void textFilterChanged(const QString& value);
+    void fullTextFilterChanged(const QString& value);
     void showTrashedFilterChanged(bool value);
     void showNotTrashedFilterChanged(bool value);
     void navigateByBranchesEnabledChanged(bool value);
@@ -192,6 +198,10 @@ private:
 
     SKRTreeItem* getItem(int projectId,
                          int treeItemId);
+    void         updateFullTextFilterIds();
+    bool         isChildStateShown(int childState) const;
+    void         updateTagFilterCache() const;
+    void         updateAttributeFilterCache() const;
 
 private slots:
 
@@ -206,6 +216,9 @@ private:
     bool m_showNotTrashedFilter;
     bool m_navigateByBranchesEnabled;
     QString m_textFilter;
+    QString m_fullTextFilter;
+    QHash<int, QSet<int> >m_fullTextFilterIdsByProject; // by project id
+    bool m_isFullTextFilterRefreshPlanned;
     int m_projectIdFilter;
     int m_parentIdFilter;
     bool m_showParentWhenParentIdFilter;
@@ -215,6 +228,12 @@ private:
     QList<int>m_tagIdListFilter;
     QStringList m_showOnlyWithAttributesFilter;
     QStringList m_hideThoseWithAttributesFilter;
+
+    // filled once per filter change instead of querying for each row
+    mutable QSet<int>m_idsWithAllFilterTags;
+    mutable bool m_isTagFilterCacheOutdated;
+    mutable QHash<int, QStringList>m_attributesByTreeItemHash;
+    mutable bool m_isAttributeFilterCacheOutdated;
     QHash<int, Qt::CheckState>m_checkedIdsHash;
     QHash<int, QList<int> >m_historyList;
 };
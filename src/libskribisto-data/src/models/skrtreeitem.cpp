@@ -23,7 +23,8 @@
 #include "plmdata.h"
 
 SKRTreeItem::SKRTreeItem() :
-    m_invalidatedRoles(), m_isRootItem(false)
+    m_invalidatedRoles(), m_isRootItem(false), m_isStructureCached(false), m_parentItem(nullptr), m_row(0),
+    m_childrenCount(0)
 {
     m_treeHub     = plmdata->treeHub();
     m_propertyHub = plmdata->treePropertyHub();
@@ -40,7 +41,8 @@ SKRTreeItem::SKRTreeItem(int projectId,
                          int indent,
                          int sortOrder) :
 
-    m_invalidatedRoles(), m_isRootItem(false)
+    m_invalidatedRoles(), m_isRootItem(false), m_isStructureCached(false), m_parentItem(nullptr), m_row(0),
+    m_childrenCount(0)
 {
     m_treeHub     = plmdata->treeHub();
     m_propertyHub = plmdata->treePropertyHub();
@@ -51,6 +53,10 @@ SKRTreeItem::SKRTreeItem(int projectId,
     m_data.insert(Roles::SortOrderRole,  sortOrder);
 
     this->invalidateAllData();
+
+    // given fresh, no need to query them again
+    m_invalidatedRoles.removeAll(Roles::IndentRole);
+    m_invalidatedRoles.removeAll(Roles::SortOrderRole);
 }
 
 SKRTreeItem::~SKRTreeItem()
@@ -166,6 +172,10 @@ QVariant SKRTreeItem::data(int role)
                                                      "word_count_with_children"));
             break;
 
+        case Roles::HasChildrenRole:
+            m_data.insert(role, m_treeHub->hasChildren(projectId, treeItemId, true, true));
+            break;
+
 
         case Roles::ProjectIsBackupRole:
             m_data.insert(role, plmdata->projectHub()->isThisProjectABackup(projectId));
@@ -244,12 +254,78 @@ QList<int>SKRTreeItem::dataRoles() const
     return m_data.keys();
 }
 
+///
+/// \brief SKRTreeItem::prefilledPropertyNames
+/// \return the properties read by data(), see prefillPropertyData()
+QStringList SKRTreeItem::prefilledPropertyNames()
+{
+    return QStringList() << "label" << "char_count" << "word_count"
+                         << "char_count_with_children" << "word_count_with_children"
+                         << "is_renamable" << "is_movable" << "can_add_sibling_paper"
+                         << "can_add_child_paper" << "is_trashable" << "is_openable"
+                         << "is_copyable" << "attributes";
+}
+
+///
+/// \brief SKRTreeItem::prefillPropertyData
+/// \param properties name -> value of this item, from
+/// SKRPropertyHub::getPropertiesForAllItems()
+/// Fills the property roles the same way data() would, without a query for
+/// each of them.
+void SKRTreeItem::prefillPropertyData(const QHash<QString, QString>& properties)
+{
+    auto setValue = [this](int role, const QVariant& value) {
+                        m_data.insert(role, value);
+                        m_invalidatedRoles.removeAll(role);
+                    };
+    auto boolValue = [&properties](const QString& name) {
+                         QString value = properties.value(name);
+
+                         if (value.isNull()) {
+                             value = "true";
+                         }
+
+                         return value == "true" ? true : false;
+                     };
+
+    setValue(Roles::LabelRole,                 properties.value("label"));
+    setValue(Roles::CharCountRole,             properties.value("char_count"));
+    setValue(Roles::WordCountRole,             properties.value("word_count"));
+    setValue(Roles::CharCountWithChildrenRole, properties.value("char_count_with_children"));
+    setValue(Roles::WordCountWithChildrenRole, properties.value("word_count_with_children"));
+    setValue(Roles::IsRenamableRole,           boolValue("is_renamable"));
+    setValue(Roles::IsMovableRole,             boolValue("is_movable"));
+    setValue(Roles::CanAddSiblingTreeItemRole, boolValue("can_add_sibling_paper"));
+    setValue(Roles::CanAddChildTreeItemRole,   boolValue("can_add_child_paper"));
+    setValue(Roles::IsTrashableRole,           boolValue("is_trashable"));
+    setValue(Roles::IsOpenableRole,            boolValue("is_openable"));
+    setValue(Roles::IsCopyableRole,            boolValue("is_copyable"));
+
+    QString attributes = properties.value("attributes");
+
+    setValue(Roles::AttributesRole, attributes.isNull() ? QString("") : attributes);
+}
+
+///
+/// \brief SKRTreeItem::prefillChildState
+/// \param childState SKRTreeTopology::ChildState flags, from
+/// SKRTreeHub::getAllChildStates()
+void SKRTreeItem::prefillChildState(int childState)
+{
+    m_data.insert(Roles::HasChildrenRole, childState != SKRTreeTopology::NoChild);
+    m_invalidatedRoles.removeAll(Roles::HasChildrenRole);
+}
+
 SKRTreeItem * SKRTreeItem::parent(const QList<SKRTreeItem *>& itemList)
 {
     if (this->isRootItem()) {
         return nullptr;
     }
 
+    if (m_isStructureCached) {
+        return m_parentItem;
+    }
+
     // for project items
     if (this->indent() == 0) {
         return nullptr;
@@ -285,6 +361,10 @@ int SKRTreeItem::row(const QList<SKRTreeItem *>& itemList)
         return 0;
     }
 
+    if (m_isStructureCached) {
+        return m_row;
+    }
+
     if (itemList.first() == this) {
         return 0;
     }
@@ -358,6 +438,10 @@ int SKRTreeItem::childrenCount(const QList<SKRTreeItem *>& itemList) {
         return childrenCount;
     }
 
+    if (m_isStructureCached) {
+        return m_childrenCount;
+    }
+
     if (itemList.last() == this) {
         return 0;
     }
@@ -479,6 +563,68 @@ SKRTreeItem * SKRTreeItem::child(const QList<SKRTreeItem *>& itemList, int row)
     return childItem;
 }
 
+///
+/// \brief SKRTreeItem::cacheStructure
+/// \param itemList
+/// parent, row and children count of every item of the flat list in one pass,
+/// with the same results as the scans done without cache
+void SKRTreeItem::cacheStructure(const QList<SKRTreeItem *>& itemList)
+{
+    if (itemList.isEmpty()) {
+        return;
+    }
+
+    // last item seen at each indent
+    QVector<SKRTreeItem *> lastItemByIndent;
+
+    // items not yet followed by an item with a lower or same indent
+    QVector<SKRTreeItem *> openItemByIndent;
+
+    // siblings seen since the last item with a lower indent
+    QVector<int> siblingCountByIndent;
+
+    for (SKRTreeItem *item : itemList) {
+        int indent = qMax(item->indent(), 0);
+
+        if (lastItemByIndent.count() <= indent) {
+            lastItemByIndent.resize(indent + 1);
+        }
+
+        // parent
+        if ((item->indent() == 0) || (item == itemList.first())) {
+            item->m_parentItem = nullptr;
+        }
+        else if (lastItemByIndent.at(indent - 1)) {
+            item->m_parentItem = lastItemByIndent.at(indent - 1);
+        }
+        else {
+            item->m_parentItem = itemList.first();
+        }
+        lastItemByIndent[indent] = item;
+
+        // row
+        siblingCountByIndent.resize(indent + 1);
+        item->m_row = siblingCountByIndent.at(indent);
+        siblingCountByIndent[indent] += 1;
+
+        // children count
+        openItemByIndent.resize(indent);
+
+        if ((indent > 0) && openItemByIndent.at(indent - 1)) {
+            openItemByIndent.at(indent - 1)->m_childrenCount += 1;
+        }
+        openItemByIndent.append(item);
+
+        item->m_childrenCount     = 0;
+        item->m_isStructureCached = true;
+    }
+}
+
+void SKRTreeItem::invalidateStructure()
+{
+    m_isStructureCached = false;
+}
+
 bool SKRTreeItem::isRootItem() const
 {
     return m_isRootItem;
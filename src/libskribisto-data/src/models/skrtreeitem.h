@@ -2,6 +2,7 @@
 #define SKRTREEITEM_H
 
 #include <QObject>
+#include <QStringList>
 #include "skrtreehub.h"
 #include "./skribisto_data_global.h"
 
@@ -65,6 +66,9 @@ public:
 
     QVariant            data(int role);
     QList<int>          dataRoles() const;
+    void                prefillPropertyData(const QHash<QString, QString>& properties);
+    void                prefillChildState(int childState);
+    static QStringList  prefilledPropertyNames();
 
     SKRTreeItem       * parent(const QList<SKRTreeItem *>& itemList);
     int                 row(const QList<SKRTreeItem *>& itemList);
@@ -78,6 +82,9 @@ public:
     bool                isRootItem() const;
     void                setIsRootItem();
 
+    static void         cacheStructure(const QList<SKRTreeItem *>& itemList);
+    void                invalidateStructure();
+
 signals:
 
 public slots:
@@ -89,6 +96,12 @@ private:
     QHash<int, QVariant>m_data;
     QList<int>m_invalidatedRoles;
     bool m_isRootItem;
+
+    // set by cacheStructure, valid for the list it was computed from
+    bool m_isStructureCached;
+    SKRTreeItem *m_parentItem;
+    int m_row;
+    int m_childrenCount;
 };
 
 #endif // SKRTREEITEM_H
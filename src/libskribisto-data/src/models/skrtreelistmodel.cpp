@@ -47,6 +47,12 @@ SKRTreeListModel::SKRTreeListModel(QObject *parent)
             this,
             &SKRTreeListModel::refreshAfterDataAddition);
 
+    // bulk additions, one reset instead of one insertion per item
+    connect(m_treeHub,
+            &SKRTreeHub::treeItemsAdded,
+            this,
+            &SKRTreeListModel::populate);
+
     connect(m_treeHub,
             &SKRTreeHub::treeItemMoved,
             this,
@@ -286,6 +292,9 @@ bool SKRTreeListModel::setData(const QModelIndex& index, const QVariant& value,
         int treeItemId    = item->treeItemId();
         SKRResult result(this);
 
+        // after a reset, item and index are gone
+        bool isReset = false;
+
         this->disconnectFromPLMDataSignals();
 
         switch (role) {
@@ -326,10 +335,8 @@ bool SKRTreeListModel::setData(const QModelIndex& index, const QVariant& value,
             result = m_treeHub->setSortOrder(projectId, treeItemId, value.toInt());
             IFOKDO(result, m_treeHub->renumberSortOrders(projectId));
 
-            for (SKRTreeItem *item : qAsConst(m_allTreeItems)) {
-                item->invalidateData(role);
-            }
             this->populate();
+            isReset = true;
 
             break;
 
@@ -384,6 +391,10 @@ bool SKRTreeListModel::setData(const QModelIndex& index, const QVariant& value,
         if (!result.isSuccess()) {
             return false;
         }
+
+        if (isReset) {
+            return true;
+        }
         item->invalidateData(role);
 
 
@@ -440,19 +451,31 @@ void SKRTreeListModel::populate()
 {
     this->beginResetModel();
 
+    // also called on each bulk addition, the previous items are owned here
+    qDeleteAll(m_allTreeItems);
     m_allTreeItems.clear();
 
     for (int projectId : plmdata->projectHub()->getProjectIdList()) {
         auto idList         = m_treeHub->getAllIds(projectId);
         auto sortOrdersHash = m_treeHub->getAllSortOrders(projectId);
         auto indentsHash    = m_treeHub->getAllIndents(projectId);
+        auto childStateHash = m_treeHub->getAllChildStates(projectId);
+
+        // one query for the properties of all items
+        auto propertiesHash = m_propertyHub->getPropertiesForAllItems(projectId,
+                                                                      SKRTreeItem::prefilledPropertyNames());
 
         for (int treeItemId : qAsConst(idList)) {
-            m_allTreeItems.append(new SKRTreeItem(projectId, treeItemId,
-                                                  indentsHash.value(treeItemId),
-                                                  sortOrdersHash.value(treeItemId)));
+            SKRTreeItem *item = new SKRTreeItem(projectId, treeItemId,
+                                                indentsHash.value(treeItemId),
+                                                sortOrdersHash.value(treeItemId));
+
+            item->prefillPropertyData(propertiesHash.value(treeItemId));
+            item->prefillChildState(childStateHash.value(treeItemId, SKRTreeTopology::NoChild));
+            m_allTreeItems.append(item);
         }
     }
+    this->rebuildIndexes();
     this->endResetModel();
 }
 
@@ -460,6 +483,8 @@ void SKRTreeListModel::clear()
 {
     this->beginResetModel();
     qDeleteAll(m_allTreeItems);
+    m_allTreeItems.clear();
+    m_rowByIdHash.clear();
     this->endResetModel();
 }
 
@@ -499,6 +524,7 @@ void SKRTreeListModel::refreshAfterDataAddition(int projectId, int treeItemId)
                               new SKRTreeItem(projectId, treeItemId,
                                               indentsHash.value(treeItemId),
                                               sortOrdersHash.value(treeItemId)));
+        this->rebuildIndexes();
         this->index(itemIndex, 0, QModelIndex());
         endInsertRows();
 
@@ -582,13 +608,19 @@ void SKRTreeListModel::refreshAfterDataRemove(int projectId, int treeItemId)
     Q_UNUSED(projectId)
     Q_UNUSED(treeItemId)
 
-    QModelIndex modelIndex = this->getModelIndex(projectId, treeItemId).first();
+    QModelIndexList modelIndexList = this->getModelIndex(projectId, treeItemId);
+
+    if (modelIndexList.isEmpty()) {
+        return;
+    }
+    QModelIndex modelIndex = modelIndexList.first();
 
     beginRemoveRows(QModelIndex(), modelIndex.row(), modelIndex.row());
 
     SKRTreeItem *item = this->getItem(projectId, treeItemId);
 
     m_allTreeItems.removeAll(item);
+    item->invalidateStructure();
     this->sortAllTreeItemItems();
 
     endRemoveRows();
@@ -736,6 +768,14 @@ void SKRTreeListModel::refreshAfterIndentChanged(int projectId, int treeItemId,
         item->invalidateData(SKRTreeItem::Roles::ProjectIsActiveRole);
         item->invalidateData(SKRTreeItem::Roles::HasChildrenRole);
     }
+
+    // the structure depends on the new indent
+    SKRTreeItem *item = this->getItem(projectId, treeItemId);
+
+    if (item) {
+        item->invalidateData(SKRTreeItem::Roles::IndentRole);
+    }
+    SKRTreeItem::cacheStructure(m_allTreeItems);
 }
 
 // --------------------------------------------------------------------
@@ -747,6 +787,26 @@ void SKRTreeListModel::sortAllTreeItemItems() {
         return item1->sortOrder() < item2->sortOrder();
     }
               );
+    this->rebuildIndexes();
+}
+
+// --------------------------------------------------------------------
+///
+/// \brief SKRTreeListModel::rebuildIndexes
+/// to be called after each change of m_allTreeItems, rows and parents are
+/// computed in one pass over the list
+void SKRTreeListModel::rebuildIndexes()
+{
+    m_rowByIdHash.clear();
+    m_rowByIdHash.reserve(m_allTreeItems.count());
+
+    for (int row = 0; row < m_allTreeItems.count(); row++) {
+        SKRTreeItem *item = m_allTreeItems.at(row);
+
+        m_rowByIdHash.insert(qMakePair(item->projectId(), item->treeItemId()), row);
+    }
+
+    SKRTreeItem::cacheStructure(m_allTreeItems);
 }
 
 // --------------------------------------------------------------------
@@ -763,23 +823,7 @@ void SKRTreeListModel::exploitSignalFromPLMData(int                projectId,
 
     item->invalidateData(role);
 
-    // search for index
-    QModelIndex index;
-    QModelIndexList list =  this->match(this->index(0, 0,
-                                                    QModelIndex()),
-                                        SKRTreeItem::Roles::TreeItemIdRole,
-                                        treeItemId,
-                                        -1,
-                                        Qt::MatchFlag::MatchRecursive |
-                                        Qt::MatchFlag::MatchExactly |
-                                        Qt::MatchFlag::MatchWrap);
-
-    for (const QModelIndex& modelIndex : qAsConst(list)) {
-        SKRTreeItem *t = static_cast<SKRTreeItem *>(modelIndex.internalPointer());
-
-        if (t)
-            if (t->projectId() == projectId) index = modelIndex;
-    }
+    QModelIndex index = this->index(m_rowByIdHash.value(qMakePair(projectId, treeItemId)), 0, QModelIndex());
 
     if (index.isValid()) {
         emit dataChanged(index, index, QVector<int>() << role);
@@ -1062,21 +1106,10 @@ void SKRTreeListModel::disconnectFromPLMDataSignals()
 QModelIndexList SKRTreeListModel::getModelIndex(int projectId, int treeItemId)
 {
     QModelIndexList list;
-    QModelIndexList modelList =  this->match(this->index(0, 0,
-                                                         QModelIndex()),
-                                             SKRTreeItem::Roles::ProjectIdRole,
-                                             projectId,
-                                             -1,
-                                             Qt::MatchFlag::MatchExactly |
-                                             Qt::MatchFlag::MatchWrap |
-                                             Qt::MatchFlag::MatchRecursive);
-
-    for (const QModelIndex& modelIndex : qAsConst(modelList)) {
-        int indexTreeItemId = modelIndex.data(SKRTreeItem::Roles::TreeItemIdRole).toInt();
-
-        if (indexTreeItemId == treeItemId) {
-            list.append(modelIndex);
-        }
+    int row = m_rowByIdHash.value(qMakePair(projectId, treeItemId), -1);
+
+    if (row != -1) {
+        list.append(this->index(row, 0, QModelIndex()));
     }
 
     return list;
@@ -1092,20 +1125,13 @@ SKRTreeItem * SKRTreeListModel::getParentTreeItem(SKRTreeItem *childItem)
 // -----------------------------------------------------------------------------------
 SKRTreeItem * SKRTreeListModel::getItem(int projectId, int treeItemId)
 {
-    SKRTreeItem *result_item = nullptr;
-
-    for (SKRTreeItem *item : qAsConst(m_allTreeItems)) {
-        if ((item->projectId() == projectId) && (item->treeItemId() == treeItemId)) {
-            result_item = item;
-            break;
-        }
-    }
+    int row = m_rowByIdHash.value(qMakePair(projectId, treeItemId), -1);
 
-    if (!result_item) {
-        //    qDebug() << "result_item is null";
+    if (row == -1) {
+        return nullptr;
     }
 
-    return result_item;
+    return m_allTreeItems.at(row);
 }
 
 // -----------------------------------------------------------------------------------
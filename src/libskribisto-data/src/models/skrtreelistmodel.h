@@ -107,6 +107,7 @@ private:
 
     void connectToPLMDataSignals();
     void disconnectFromPLMDataSignals();
+    void rebuildIndexes();
 
 private:
 
@@ -115,6 +116,9 @@ private:
     SKRTreeItem *m_rootItem;
     QVariant m_headerData;
     QList<SKRTreeItem *>m_allTreeItems;
+
+    // (projectId, treeItemId) -> row in m_allTreeItems
+    QHash<QPair<int, int>, int>m_rowByIdHash;
     QList<QMetaObject::Connection>m_dataConnectionsList;
 };
 
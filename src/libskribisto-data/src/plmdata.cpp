@@ -19,6 +19,7 @@ PLMData::PLMData(QObject *parent) : QObject(parent)
     m_projectDictHub = new SKRProjectDictHub(this);
     m_pluginHub      = new SKRPluginHub(this);
     m_statHub        = new SKRStatHub(this);
+    m_searchHub      = new SKRSearchHub(this);
 
     connect(m_treeHub,
             &SKRTreeHub::projectModified,
@@ -33,6 +34,16 @@ PLMData::PLMData(QObject *parent) : QObject(parent)
             m_projectHub,
             &PLMProjectHub::setProjectNotSavedAnymore);
 
+    // project ids are reused, drop the cached tree structure
+    connect(m_projectHub,
+            &PLMProjectHub::projectLoaded,
+            m_treeHub,
+            &SKRTreeHub::invalidateTreeTopology);
+    connect(m_projectHub,
+            &PLMProjectHub::projectClosed,
+            m_treeHub,
+            &SKRTreeHub::invalidateTreeTopology);
+
 
     // connect errors :
 
@@ -48,6 +59,10 @@ PLMData::PLMData(QObject *parent) : QObject(parent)
             &SKRTagHub::errorSent,
             m_errorHub,
             &SKRErrorHub::addError);
+    connect(m_searchHub,
+            &SKRSearchHub::errorSent,
+            m_errorHub,
+            &SKRErrorHub::addError);
     connect(m_projectHub,
             &PLMProjectHub::errorSent,
             m_errorHub,
@@ -127,3 +142,10 @@ SKRStatHub * PLMData::statHub()
 {
     return m_statHub;
 }
+
+// -----------------------------------------------------------------------------
+
+SKRSearchHub * PLMData::searchHub()
+{
+    return m_searchHub;
+}
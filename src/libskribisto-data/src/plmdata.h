@@ -33,6 +33,7 @@
 #include "skrprojectdicthub.h"
 #include "skribisto_data_global.h"
 #include "skrstathub.h"
+#include "skrsearchhub.h"
 #include "tasks/plmprojectmanager.h"
 
 #define plmdata PLMData::instance()
@@ -60,6 +61,7 @@ public:
     Q_INVOKABLE SKRTagHub        * tagHub();
     Q_INVOKABLE SKRProjectDictHub* projectDictHub();
     Q_INVOKABLE SKRStatHub       * statHub();
+    Q_INVOKABLE SKRSearchHub     * searchHub();
     SKRPluginHub                 * pluginHub();
 
 signals:
@@ -80,6 +82,7 @@ private:
     SKRPluginHub *m_pluginHub;
     SKRProjectDictHub *m_projectDictHub;
     SKRStatHub *m_statHub;
+    SKRSearchHub *m_searchHub;
 };
 
 #endif // PLMDATA_H
@@ -2,6 +2,7 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
 #include <QRegularExpression>
 #include <QUrl>
@@ -20,6 +21,21 @@ PLMProjectHub::PLMProjectHub(QObject *parent) : QObject(parent),
             this,
             &PLMProjectHub::setError,
             Qt::DirectConnection);
+
+    connect(plmProjectManager,
+            &PLMProjectManager::projectSaveFinished,
+            this,
+            &PLMProjectHub::setProjectSaveFinished);
+
+    // a recovered project is kept aside until saved at its own path
+    connect(this, &PLMProjectHub::projectSaved, this, [this](int projectId) {
+        if (m_recoveredPathByProjectId.contains(projectId)) {
+            QFile::remove(m_recoveredPathByProjectId.take(projectId).toLocalFile());
+        }
+    });
+    connect(this, &PLMProjectHub::projectClosed, this, [this](int projectId) {
+        m_recoveredPathByProjectId.remove(projectId);
+    });
 }
 
 SKRResult PLMProjectHub::loadProject(const QUrl& urlFilePath, bool hidden)
@@ -47,6 +63,12 @@ SKRResult PLMProjectHub::loadProject(const QUrl& urlFilePath, bool hidden)
             if (urlFilePath.isEmpty()) {
                 this->setProjectNotSavedAnymore(projectId);
             }
+
+            QUrl recoveredPath = plmProjectManager->project(projectId)->getRecoveredPath();
+
+            if (!recoveredPath.isEmpty()) {
+                emit projectRecoverable(projectId, recoveredPath);
+            }
         }
     }
 
@@ -115,11 +137,40 @@ SKRResult PLMProjectHub::saveProject(int projectId)
 {
     SKRResult result(this);
 
+    emit projectToBeSaved(projectId);
+
     result = plmProjectManager->saveProject(projectId);
     IFOK(result) {
         m_projectsNotModifiedOnceList.removeAll(projectId);
         m_projectsNotSavedList.removeAll(projectId);
-        emit projectSaved(projectId);
+
+        if (!result.getData("deferred", false).toBool()) {
+            emit projectSaved(projectId);
+        }
+    }
+
+
+    IFKO(result) {
+        emit errorSent(result);
+    }
+
+    return result;
+}
+
+SKRResult PLMProjectHub::compactProject(int projectId)
+{
+    SKRResult result(this);
+
+    emit projectToBeSaved(projectId);
+
+    result = plmProjectManager->compactProject(projectId);
+    IFOK(result) {
+        m_projectsNotModifiedOnceList.removeAll(projectId);
+        m_projectsNotSavedList.removeAll(projectId);
+
+        if (!result.getData("deferred", false).toBool()) {
+            emit projectSaved(projectId);
+        }
     }
 
 
@@ -144,6 +195,31 @@ void PLMProjectHub::setProjectNotSavedAnymore(int projectId)
     emit projectNotSavedAnymore(projectId);
 }
 
+///
+/// \brief PLMProjectHub::setProjectSaveFinished
+/// \param projectId
+/// \param path
+/// \param result
+/// end of a save done by the worker thread of a project in WAL mode. The
+/// project was considered saved when asked, a failed save changes it back.
+/// Copies and backups don't go to the project path.
+void PLMProjectHub::setProjectSaveFinished(int projectId, const QUrl& path, const SKRResult& result)
+{
+    bool isProjectPath = plmProjectManager->projectIdList().contains(projectId) && this->getPath(projectId) == path;
+
+    IFOK(result) {
+        if (isProjectPath) {
+            emit projectSaved(projectId);
+        }
+    }
+    IFKO(result) {
+        if (isProjectPath) {
+            this->setProjectNotSavedAnymore(projectId);
+        }
+        emit errorSent(result);
+    }
+}
+
 QList<int>PLMProjectHub::projectsNotModifiedOnce() {
     return m_projectsNotModifiedOnceList;
 }
@@ -173,6 +249,7 @@ SKRResult PLMProjectHub::saveProjectAs(int            projectId,
 
 
     // save
+    emit projectToBeSaved(projectId);
     result = plmProjectManager->saveProjectAs(projectId, type, path);
     IFOK(result) {
         m_projectsNotModifiedOnceList.removeAll(projectId);
@@ -182,7 +259,9 @@ SKRResult PLMProjectHub::saveProjectAs(int            projectId,
             emit projectIsBackupChanged(projectId, false);
         }
 
-        emit projectSaved(projectId);
+        if (!result.getData("deferred", false).toBool()) {
+            emit projectSaved(projectId);
+        }
     }
     IFKO(result) {
         emit errorSent(result);
@@ -386,6 +465,49 @@ SKRResult PLMProjectHub::closeProject(int projectId)
 
 // ----------------------------------------------------------------------------
 
+///
+/// \brief PLMProjectHub::recoverProject
+/// \param projectId
+/// \param recoveredPath
+/// \return
+/// replaces the project by the one recovered after a crash, which takes its
+/// path and waits to be saved. The recovered file is removed at the first save.
+SKRResult PLMProjectHub::recoverProject(int projectId, const QUrl& recoveredPath)
+{
+    QUrl path        = this->getPath(projectId);
+    SKRResult result = this->closeProject(projectId);
+
+    IFOKDO(result, this->loadProject(recoveredPath));
+    IFOK(result) {
+        int recoveredProjectId = result.getData("projectId", -1).toInt();
+
+        IFOKDO(result, this->setPath(recoveredProjectId, path));
+        IFOK(result) {
+            m_recoveredPathByProjectId.insert(recoveredProjectId, recoveredPath);
+            this->setProjectNotSavedAnymore(recoveredProjectId);
+        }
+    }
+
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+SKRResult PLMProjectHub::discardRecoveredProject(const QUrl& recoveredPath)
+{
+    SKRResult result(this);
+
+    if (!QFile::remove(recoveredPath.toLocalFile())) {
+        result = SKRResult(SKRResult::Warning, this, "recovered_project_not_removed");
+        result.addData("filePath", recoveredPath);
+        emit errorSent(result);
+    }
+
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
 SKRResult PLMProjectHub::closeAllProjects()
 {
     SKRResult result(this);
@@ -22,7 +22,9 @@
 #define PLMPROJECTHUB_H
 
 #include <QObject>
+#include <QHash>
 #include <QString>
+#include <QUrl>
 #include "skrresult.h"
 #include "skribisto_data_global.h"
 
@@ -44,6 +46,7 @@ public:
     SKRResult             createSilentlyNewSpecificEmptyProject(const QUrl   & path,
                                                                 const QString& sqlFile);
     Q_INVOKABLE SKRResult saveProject(int projectId);
+    Q_INVOKABLE SKRResult compactProject(int projectId);
     Q_INVOKABLE SKRResult saveProjectAs(int            projectId,
                                         const QString& type,
                                         const QUrl   & path);
@@ -56,6 +59,9 @@ public:
     Q_INVOKABLE bool      doesBackupOfTheDayExistAtPath(int         projectId,
                                                         const QUrl& folderPath);
     Q_INVOKABLE SKRResult closeProject(int projectId);
+    Q_INVOKABLE SKRResult recoverProject(int         projectId,
+                                         const QUrl& recoveredPath);
+    Q_INVOKABLE SKRResult discardRecoveredProject(const QUrl& recoveredPath);
     Q_INVOKABLE SKRResult closeAllProjects();
     Q_INVOKABLE bool      isProjectToBeClosed(int projectId) const;
     Q_INVOKABLE QList<int>getProjectIdList();
@@ -128,6 +134,11 @@ signals:
                             const QString& newProjectName);
     void langCodeChanged(int            projectId,
                          const QString& newProjectName);
+    ///
+    /// \brief projectToBeSaved
+    /// \param projectId
+    /// To be used with a direct connection
+    void projectToBeSaved(int projectId);
     void projectSaved(int projectId);
     void projectNotSavedAnymore(int projectId);
     void projectCountChanged(int count);
@@ -135,6 +146,15 @@ signals:
     void projectIsBackupChanged(int  projectId,
                                 bool isThisABackup);
 
+    ///
+    /// \brief projectRecoverable
+    /// \param projectId
+    /// \param recoveredPath
+    /// the working copy of this project was left by a crash, it's kept at
+    /// recoveredPath until recovered or discarded
+    void projectRecoverable(int         projectId,
+                            const QUrl& recoveredPath);
+
 public slots:
 
     void setProjectNotSavedAnymore(int projectId);
@@ -142,11 +162,15 @@ public slots:
 private slots:
 
     void setError(const SKRResult& result);
+    void setProjectSaveFinished(int              projectId,
+                                const QUrl     & path,
+                                const SKRResult& result);
 
 private:
 
     SKRResult m_error;
     QList<int>m_projectsNotModifiedOnceList, m_projectsNotSavedList;
+    QHash<int, QUrl>m_recoveredPathByProjectId;
     QString m_tableName;
     int m_activeProject;
     int m_isProjectToBeClosed;
@@ -0,0 +1,424 @@
+/***************************************************************************
+*   Copyright (C) 2021 by Cyril Jacquet                                 *
+*   cyril.jacquet@skribisto.eu                                        *
+*                                                                         *
+*  Filename: skrcontentjournal.cpp                                                   *
+*  This file is part of Skribisto.                                    *
+*                                                                         *
+*  Skribisto is free software: you can redistribute it and/or modify  *
+*  it under the terms of the GNU General Public License as published by   *
+*  the Free Software Foundation, either version 3 of the License, or      *
+*  (at your option) any later version.                                    *
+*                                                                         *
+*  Skribisto is distributed in the hope that it will be useful,       *
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+*  GNU General Public License for more details.                           *
+*                                                                         *
+*  You should have received a copy of the GNU General Public License      *
+*  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
+***************************************************************************/
+#include "skrcontentjournal.h"
+#include "tasks/plmprojectmanager.h"
+#include "tasks/plmsqlqueries.h"
+#include "tasks/sql/skrsqlstatementcache.h"
+
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTimer>
+
+namespace {
+// compaction once typing pauses for this long
+const int idleInterval = 2000;
+
+// or once an item gathered that many deltas, about 40 s of typing
+const int maxDeltaCount = 200;
+
+const QString insertDeltaStr =
+    "INSERT INTO temp.tbl_content_journal (l_tree_code, t_field, l_position, l_removed_length, m_inserted)"
+    " VALUES (:treeItemId, :field, :position, :removedLength, :inserted)";
+
+SKRResult sqlError(const QObject *origin, const QSqlQuery& query, const QString& queryStr)
+{
+    SKRResult result(SKRResult::Critical, origin, "sql_error");
+
+    result.addData("SQLError",   query.lastError().text());
+    result.addData("SQL string", queryStr);
+    return result;
+}
+}
+
+SKRContentJournal::SKRContentJournal(QObject *parent) : QObject(parent), m_idleTimer(new QTimer(this))
+{
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(idleInterval);
+    connect(m_idleTimer, &QTimer::timeout, this, &SKRContentJournal::compactAll);
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRContentJournal::record
+/// \param projectId
+/// \param treeItemId
+/// \param fieldName m_primary_content or m_secondary_content
+/// \param newContent the whole new content
+/// \return
+/// Journals the range differing from the previous content. tbl_tree is only
+/// written at compaction.
+SKRResult SKRContentJournal::record(int projectId, int treeItemId, const QString& fieldName, const QString& newContent)
+{
+    SKRResult result(this);
+
+    if (!isJournaledField(fieldName)) {
+        result = SKRResult(SKRResult::Critical, this, "field_not_journaled");
+        result.addData("fieldName", fieldName);
+        return result;
+    }
+
+    PLMProject *project = plmProjectManager->project(projectId);
+
+    if (!project) {
+        result = SKRResult(SKRResult::Critical, this, "no_project");
+        result.addData("projectId", projectId);
+        return result;
+    }
+
+    QHash<ContentKey, PendingContent>& pendingHash = m_pendingByProjectHash[projectId];
+    const ContentKey key(treeItemId, fieldName);
+    QString oldContent;
+
+    if (pendingHash.contains(key)) {
+        oldContent = pendingHash.value(key).content;
+    }
+    else {
+        PLMSqlQueries queries(projectId, "tbl_tree");
+        QVariant out;
+
+        result = queries.get(treeItemId, fieldName, out);
+        IFKO(result) {
+            return result;
+        }
+        oldContent = out.toString();
+    }
+
+    int     position;
+    int     removedLength;
+    QString inserted;
+
+    diff(oldContent, newContent, position, removedLength, inserted);
+
+    Stats& stats = m_statsByProjectHash[projectId];
+
+    stats.requestedCharacters += newContent.size();
+
+    if ((removedLength == 0) && inserted.isEmpty()) {
+        return result;
+    }
+
+    QSqlDatabase sqlDb = project->getSqlDb();
+
+    if (pendingHash.isEmpty()) {
+        QSqlQuery query(sqlDb);
+        QString   queryStr = "CREATE TEMP TABLE IF NOT EXISTS tbl_content_journal"
+                             " (l_journal_id INTEGER PRIMARY KEY, l_tree_code INTEGER, t_field TEXT,"
+                             " l_position INTEGER, l_removed_length INTEGER, m_inserted TEXT)";
+
+        if (!query.exec(queryStr)) {
+            return sqlError(this, query, queryStr);
+        }
+    }
+
+    QSqlQuery *query = SKRSqlStatementCache::acquire(sqlDb, insertDeltaStr);
+
+    query->bindValue(":treeItemId",    treeItemId);
+    query->bindValue(":field",         fieldName);
+    query->bindValue(":position",      position);
+    query->bindValue(":removedLength", removedLength);
+    query->bindValue(":inserted",      inserted);
+    query->exec();
+
+    if (query->lastError().isValid()) {
+        result = sqlError(this, *query, insertDeltaStr);
+    }
+    SKRSqlStatementCache::release(sqlDb, insertDeltaStr, query);
+
+    IFKO(result) {
+        return result;
+    }
+
+    PendingContent& pending = pendingHash[key];
+
+    pending.content     = newContent;
+    pending.deltaCount += 1;
+
+    stats.journaledCharacters += inserted.size();
+    stats.deltaCount          += 1;
+
+    if (pending.deltaCount >= maxDeltaCount) {
+        result = this->compactTreeItem(projectId, treeItemId, fieldName);
+    }
+    else {
+        m_idleTimer->start();
+    }
+
+    return result;
+}
+
+// ----------------------------------------------------------------------------------------
+
+bool SKRContentJournal::hasPendingContent(int projectId, int treeItemId, const QString& fieldName) const
+{
+    return m_pendingByProjectHash.value(projectId).contains(ContentKey(treeItemId, fieldName));
+}
+
+// ----------------------------------------------------------------------------------------
+
+QString SKRContentJournal::pendingContent(int projectId, int treeItemId, const QString& fieldName) const
+{
+    return m_pendingByProjectHash.value(projectId).value(ContentKey(treeItemId, fieldName)).content;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRContentJournal::discard
+/// \param projectId
+/// \param treeItemId
+/// \param fieldName
+/// \return
+/// Drops the deltas of a content about to be written as a whole
+SKRResult SKRContentJournal::discard(int projectId, int treeItemId, const QString& fieldName)
+{
+    SKRResult result(this);
+
+    if (!this->hasPendingContent(projectId, treeItemId, fieldName)) {
+        return result;
+    }
+
+    m_pendingByProjectHash[projectId].remove(ContentKey(treeItemId, fieldName));
+
+    PLMProject *project = plmProjectManager->project(projectId);
+
+    if (!project) {
+        return result;
+    }
+
+    QSqlQuery query(project->getSqlDb());
+    QString   queryStr = "DELETE FROM temp.tbl_content_journal WHERE l_tree_code = :treeItemId AND t_field = :field";
+
+    query.prepare(queryStr);
+    query.bindValue(":treeItemId", treeItemId);
+    query.bindValue(":field",      fieldName);
+
+    if (!query.exec()) {
+        result = sqlError(this, query, queryStr);
+    }
+
+    return result;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRContentJournal::compact
+/// \param projectId
+/// \return
+/// Writes the journaled contents of the project into tbl_tree
+SKRResult SKRContentJournal::compact(int projectId)
+{
+    SKRResult result(this);
+
+    const QList<ContentKey> keys = m_pendingByProjectHash.value(projectId).keys();
+
+    for (const ContentKey& key : keys) {
+        IFOKDO(result, this->compactTreeItem(projectId, key.first, key.second));
+    }
+
+    return result;
+}
+
+// ----------------------------------------------------------------------------------------
+
+SKRContentJournal::Stats SKRContentJournal::stats(int projectId) const
+{
+    return m_statsByProjectHash.value(projectId);
+}
+
+// ----------------------------------------------------------------------------------------
+
+bool SKRContentJournal::isJournaledField(const QString& fieldName)
+{
+    return fieldName == "m_primary_content" || fieldName == "m_secondary_content";
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRContentJournal::diff
+/// \param oldContent
+/// \param newContent
+/// \param position
+/// \param removedLength
+/// \param inserted
+/// The single range replacing oldContent by newContent, found by trimming the
+/// common prefix and suffix. Surrogate pairs are never split, the inserted text
+/// has to survive its conversion to UTF-8.
+void SKRContentJournal::diff(const QString& oldContent,
+                             const QString& newContent,
+                             int          & position,
+                             int          & removedLength,
+                             QString      & inserted)
+{
+    const QChar *oldData = oldContent.constData();
+    const QChar *newData = newContent.constData();
+    const int    oldSize = oldContent.size();
+    const int    newSize = newContent.size();
+
+    int prefix = 0;
+    int commonSize = qMin(oldSize, newSize);
+
+    while (prefix < commonSize && oldData[prefix] == newData[prefix]) {
+        ++prefix;
+    }
+
+    if ((prefix > 0) && oldData[prefix - 1].isHighSurrogate()) {
+        --prefix;
+    }
+
+    int suffix = 0;
+    int maxSuffix = commonSize - prefix;
+
+    while (suffix < maxSuffix && oldData[oldSize - 1 - suffix] == newData[newSize - 1 - suffix]) {
+        ++suffix;
+    }
+
+    if ((suffix > 0) && newData[newSize - suffix].isLowSurrogate()) {
+        --suffix;
+    }
+
+    position      = prefix;
+    removedLength = oldSize - prefix - suffix;
+    inserted      = newContent.mid(prefix, newSize - prefix - suffix);
+}
+
+// ----------------------------------------------------------------------------------------
+
+void SKRContentJournal::forgetProject(int projectId)
+{
+    m_pendingByProjectHash.remove(projectId);
+    m_statsByProjectHash.remove(projectId);
+}
+
+// ----------------------------------------------------------------------------------------
+
+void SKRContentJournal::compactAll()
+{
+    const QList<int> projectIds = m_pendingByProjectHash.keys();
+
+    for (int projectId : projectIds) {
+        SKRResult result = this->compact(projectId);
+
+        IFKO(result) {
+            emit errorSent(result);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRContentJournal::compactTreeItem
+/// \param projectId
+/// \param treeItemId
+/// \param fieldName
+/// \return
+/// Replays the deltas on the stored content, writes it and empties the journal
+/// of this content, in one transaction.
+SKRResult SKRContentJournal::compactTreeItem(int projectId, int treeItemId, const QString& fieldName)
+{
+    SKRResult result(this);
+    const ContentKey key(treeItemId, fieldName);
+
+    if (!this->hasPendingContent(projectId, treeItemId, fieldName)) {
+        return result;
+    }
+
+    PLMProject *project = plmProjectManager->project(projectId);
+
+    if (!project) {
+        m_pendingByProjectHash[projectId].remove(key);
+        return result;
+    }
+
+    QSqlDatabase  sqlDb = project->getSqlDb();
+    PLMSqlQueries queries(projectId, "tbl_tree");
+    QVariant out;
+    QString  content;
+
+    queries.beginTransaction();
+    result = queries.get(treeItemId, fieldName, out);
+
+    IFOK(result) {
+        content = out.toString();
+
+        QSqlQuery query(sqlDb);
+        QString   queryStr = "SELECT l_position, l_removed_length, m_inserted FROM temp.tbl_content_journal"
+                             " WHERE l_tree_code = :treeItemId AND t_field = :field"
+                             " ORDER BY l_journal_id";
+
+        query.prepare(queryStr);
+        query.bindValue(":treeItemId", treeItemId);
+        query.bindValue(":field",      fieldName);
+        query.exec();
+
+        while (query.next()) {
+            content.replace(query.value(0).toInt(), query.value(1).toInt(), query.value(2).toString());
+        }
+
+        if (query.lastError().isValid()) {
+            result = sqlError(this, query, queryStr);
+        }
+    }
+
+    IFOK(result) {
+        const QString latestContent = this->pendingContent(projectId, treeItemId, fieldName);
+
+        if (content != latestContent) {
+            qWarning() << Q_FUNC_INFO << "replayed content differs, latest content kept" << projectId << treeItemId;
+            content = latestContent;
+        }
+    }
+
+    IFOKDO(result, queries.set(treeItemId, fieldName, content));
+    IFOKDO(result, queries.setCurrentDate(treeItemId, "dt_updated"));
+
+    IFOK(result) {
+        QSqlQuery query(sqlDb);
+        QString   queryStr = "DELETE FROM temp.tbl_content_journal WHERE l_tree_code = :treeItemId AND t_field = :field";
+
+        query.prepare(queryStr);
+        query.bindValue(":treeItemId", treeItemId);
+        query.bindValue(":field",      fieldName);
+
+        if (!query.exec()) {
+            result = sqlError(this, query, queryStr);
+        }
+    }
+
+    IFKO(result) {
+        queries.rollback();
+        return result;
+    }
+    queries.commit();
+
+    m_pendingByProjectHash[projectId].remove(key);
+
+    Stats& stats = m_statsByProjectHash[projectId];
+
+    stats.compactedCharacters += content.size();
+    stats.compactionCount     += 1;
+
+    return result;
+}
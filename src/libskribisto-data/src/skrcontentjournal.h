@@ -0,0 +1,112 @@
+/***************************************************************************
+*   Copyright (C) 2021 by Cyril Jacquet                                 *
+*   cyril.jacquet@skribisto.eu                                        *
+*                                                                         *
+*  Filename: skrcontentjournal.h                                                   *
+*  This file is part of Skribisto.                                    *
+*                                                                         *
+*  Skribisto is free software: you can redistribute it and/or modify  *
+*  it under the terms of the GNU General Public License as published by   *
+*  the Free Software Foundation, either version 3 of the License, or      *
+*  (at your option) any later version.                                    *
+*                                                                         *
+*  Skribisto is distributed in the hope that it will be useful,       *
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+*  GNU General Public License for more details.                           *
+*                                                                         *
+*  You should have received a copy of the GNU General Public License      *
+*  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
+***************************************************************************/
+#ifndef SKRCONTENTJOURNAL_H
+#define SKRCONTENTJOURNAL_H
+
+#include <QObject>
+#include <QHash>
+#include <QPair>
+#include <QString>
+
+#include "skribisto_data_global.h"
+#include "skrresult.h"
+
+class QTimer;
+
+///
+/// \brief The SKRContentJournal class
+/// Write path of the contents while typing. Instead of rewriting the whole
+/// content each time, only the edited range is appended to a journal table in
+/// the temporary schema of the project connection. The journal is replayed
+/// into tbl_tree when typing pauses, when it grows too long and before the
+/// project is saved, so the project file format is unchanged. Until then, the
+/// latest content is kept in memory for the readers of the tree hub.
+class EXPORT SKRContentJournal : public QObject {
+    Q_OBJECT
+
+public:
+
+    struct Stats {
+        qint64 requestedCharacters = 0; // what full rewrites would have written
+        qint64 journaledCharacters = 0;
+        qint64 compactedCharacters = 0;
+        int    deltaCount          = 0;
+        int    compactionCount     = 0;
+    };
+
+    explicit SKRContentJournal(QObject *parent);
+
+    SKRResult      record(int            projectId,
+                          int            treeItemId,
+                          const QString& fieldName,
+                          const QString& newContent);
+    bool           hasPendingContent(int            projectId,
+                                     int            treeItemId,
+                                     const QString& fieldName) const;
+    QString        pendingContent(int            projectId,
+                                  int            treeItemId,
+                                  const QString& fieldName) const;
+    SKRResult      discard(int            projectId,
+                           int            treeItemId,
+                           const QString& fieldName);
+    SKRResult      compact(int projectId);
+    Stats          stats(int projectId) const;
+
+    static bool    isJournaledField(const QString& fieldName);
+    static void    diff(const QString& oldContent,
+                        const QString& newContent,
+                        int          & position,
+                        int          & removedLength,
+                        QString      & inserted);
+
+public slots:
+
+    void forgetProject(int projectId);
+
+signals:
+
+    void errorSent(const SKRResult& result) const;
+
+private slots:
+
+    void compactAll();
+
+private:
+
+    SKRResult compactTreeItem(int            projectId,
+                              int            treeItemId,
+                              const QString& fieldName);
+
+private:
+
+    struct PendingContent {
+        QString content;
+        int     deltaCount = 0;
+    };
+
+    typedef QPair<int, QString>ContentKey; // tree item id, field name
+
+    QHash<int, QHash<ContentKey, PendingContent> >m_pendingByProjectHash;
+    QHash<int, Stats>m_statsByProjectHash;
+    QTimer *m_idleTimer;
+};
+
+#endif // SKRCONTENTJOURNAL_H
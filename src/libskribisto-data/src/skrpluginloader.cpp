@@ -2,10 +2,16 @@
 #include "plmutils.h"
 #include <QSettings>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QTranslator>
 
 // #include "textconverter/converterinterface.h"
 
-SKRPluginLoader::SKRPluginLoader(QObject *parent) : QObject(parent)
+SKRPluginLoader::SKRPluginLoader(QObject *parent) : QObject(parent),
+    m_arePluginsDiscovered(false), m_loadingTime(0)
 {
     qRegisterMetaType<QList<SKRPlugin> >("QList<SKRPlugin>");
 
@@ -91,6 +97,12 @@ SKRPluginLoader::~SKRPluginLoader()
 
 QList<SKRPlugin>SKRPluginLoader::listAll()
 {
+    const QStringList names = m_pluginsListHash.keys();
+
+    for (const QString& name : names) {
+        this->pluginObject(name);
+    }
+
     return m_pluginsListHash.values();
 }
 
@@ -99,15 +111,15 @@ QList<SKRPlugin>SKRPluginLoader::listAll()
 QList<SKRPlugin>SKRPluginLoader::listActivated()
 {
     QList<SKRPlugin> list;
-    QHash<QString, SKRPlugin>::const_iterator i = m_pluginsListHash.constBegin();
+    const QStringList names = m_pluginsListHash.keys();
 
-    while (i != m_pluginsListHash.constEnd()) {
-        SKRPlugin plugin = i.value();
+    for (const QString& name : names) {
+        QObject *object = this->pluginObject(name);
 
-        if (qobject_cast<SKRCoreInterface *>(plugin.object)->pluginEnabled()) {
-            list << plugin;
+        if (object && qobject_cast<SKRCoreInterface *>(object) &&
+            qobject_cast<SKRCoreInterface *>(object)->pluginEnabled()) {
+            list << m_pluginsListHash.value(name);
         }
-        ++i;
     }
 
     return list;
@@ -115,59 +127,309 @@ QList<SKRPlugin>SKRPluginLoader::listActivated()
 
 // ---------------------------------------------------------------------------
 
+///
+/// \brief SKRPluginLoader::discoverPlugins
+/// Lists the Skribisto plugins of the library paths without loading them,
+/// from the metadata of plugin_info.json. The metadata read from the files are
+/// kept in the settings with the modification date and size of each file, so
+/// an unchanged library isn't read again at the next start.
+void SKRPluginLoader::discoverPlugins()
+{
+    if (m_arePluginsDiscovered) {
+        return;
+    }
+    m_arePluginsDiscovered = true;
+
+    QElapsedTimer timer;
+
+    timer.start();
+
+    QSettings settings;
+    const QVariantMap cache = settings.value("PluginCache/metaData").toMap();
+    QVariantMap newCache;
+    int cachedCount = 0;
+    int readCount   = 0;
+
+    QStringList filter;
+
+    filter << "*.so" << "*.dll" << "*.dylib";
+    QDir::Filters filterFlags(QDir::Files& ~QDir::Executable);
+
+    for (const QString& path : QCoreApplication::libraryPaths()) {
+        QDir plugDir = QDir(path);
+
+        for (const QString& file : plugDir.entryList(filter, filterFlags, QDir::NoSort)) {
+            QFileInfo   info(plugDir.absoluteFilePath(file));
+            QString     fileName     = info.absoluteFilePath();
+            qint64      lastModified = info.lastModified().toMSecsSinceEpoch();
+            QVariantMap entry        = cache.value(fileName).toMap();
+            QVariantMap metaData;
+
+            if (!entry.isEmpty() && (entry.value("lastModified").toLongLong() == lastModified) &&
+                (entry.value("size").toLongLong() == info.size())) {
+                metaData = entry.value("metaData").toMap();
+                cachedCount++;
+            }
+            else {
+                // reads the metadata section, the library isn't loaded
+                QPluginLoader loader(fileName);
+
+                metaData = loader.metaData().value("MetaData").toObject().toVariantMap();
+                entry.clear();
+                entry.insert("lastModified", lastModified);
+                entry.insert("size",         info.size());
+                entry.insert("metaData",     metaData);
+                readCount++;
+            }
+            newCache.insert(fileName, entry);
+
+            // not a Skribisto plugin
+            QString shortName = metaData.value("shortname").toString();
+
+            if (shortName.isEmpty()) {
+                continue;
+            }
+
+            if ((metaData.value("type").toString() == "page") && metaData.value("pagetype").toString().isEmpty()) {
+                qWarning() << "Plugin" << shortName << "has no \"pagetype\" in its metadata, ignoring it";
+                continue;
+            }
+
+            if (!m_pluginsListHash.contains(shortName)) {
+                qDebug() << "plugin found : " << shortName;
+                m_pluginsListHash.insert(shortName, SKRPlugin(shortName, fileName, metaData));
+            }
+        }
+    }
+
+    if (newCache != cache) {
+        settings.setValue("PluginCache/metaData", newCache);
+    }
+
+    m_loadingTime += timer.elapsed();
+    qDebug() << "plugins discovered in" << timer.elapsed() << "ms," << cachedCount << "from cache," << readCount <<
+        "read";
+}
 
-QObject * SKRPluginLoader::pluginObjectByName(const QString& fileName)
+// ---------------------------------------------------------------------------
+
+///
+/// \brief SKRPluginLoader::pluginObject
+/// \param name
+/// \return the plugin instance, loaded on the first call
+QObject * SKRPluginLoader::pluginObject(const QString& name)
 {
-    QPluginLoader loader(fileName);
+    auto it = m_pluginsListHash.find(name);
+
+    if (it == m_pluginsListHash.end()) {
+        return nullptr;
+    }
+
+    if (it->object || it->fileName.isEmpty()) {
+        return it->object;
+    }
+
+    QElapsedTimer timer;
+
+    timer.start();
+
+    QPluginLoader loader(it->fileName);
     QObject *plugin = loader.instance();
 
     if (!plugin) {
-        qDebug() << "loader.instance() FOR : " + fileName;
+        qDebug() << "loader.instance() FOR : " + it->fileName;
         qDebug() << "loader.instance() : " + loader.errorString();
-    } else {
-        plugin->setProperty("fileName", fileName);
-        plugin->setProperty("activatedbydefault",
-                            loader.metaData().value("MetaData").toObject().value(
-                                "activatedbydefault").toBool());
-        plugin->setProperty("version",
-                            loader.metaData().value("MetaData").toObject().value(
-                                "version").toString());
-        plugin->setProperty("mandatory",
-                            loader.metaData().value("MetaData").toObject().value(
-                                "mandatory").toBool());
-        plugin->setProperty("shortname",
-                            loader.metaData().value("MetaData").toObject().value(
-                                "shortname").toString());
-        plugin->setProperty("longname",
-                            loader.metaData().value("MetaData").toObject().value(
-                                "longname").toString());
-        plugin->setProperty("type",
-                            loader.metaData().value("MetaData").toObject().value(
-                                "type").toString());
+
+        // not tried again
+        m_pluginsListHash.erase(it);
+
+        return nullptr;
     }
 
+    const QVariantMap& metaData = it->metaData;
+
+    plugin->setProperty("fileName",           it->fileName);
+    plugin->setProperty("activatedbydefault", metaData.value("activatedbydefault").toBool());
+    plugin->setProperty("version",            metaData.value("version").toString());
+    plugin->setProperty("mandatory",          metaData.value("mandatory").toBool());
+    plugin->setProperty("shortname",          metaData.value("shortname").toString());
+    plugin->setProperty("longname",           metaData.value("longname").toString());
+    plugin->setProperty("type",               metaData.value("type").toString());
+
+    it->object    = plugin;
+    it->className = plugin->metaObject()->className();
+
+    this->installPluginTranslation(it->className);
+
+    m_loadingTime += timer.elapsed();
+    qDebug() << "plugin" << name << "loaded in" << timer.elapsed() << "ms, plugins took" << m_loadingTime <<
+        "ms until now";
+
     return plugin;
 }
 
 // ---------------------------------------------------------------------------
 
+///
+/// \brief SKRPluginLoader::usablePluginObjects
+/// \param type
+/// \param includeDisabled
+/// \return
+/// The candidates are chosen from their metadata, only them are loaded.
+QList<QObject *>SKRPluginLoader::usablePluginObjects(const QString& type, bool includeDisabled)
+{
+    QList<QObject *> list;
+    QStringList names;
+
+    for (auto it = m_pluginsListHash.constBegin(); it != m_pluginsListHash.constEnd(); ++it) {
+        if ((it->metaData.value("type").toString() == type) && this->isUsable(it.value(), includeDisabled)) {
+            names << it.key();
+        }
+    }
+
+    for (const QString& name : qAsConst(names)) {
+        QObject *object = this->pluginObject(name);
+
+        if (object && this->isUsable(object, includeDisabled)) {
+            list << object;
+        }
+    }
+
+    return list;
+}
+
+// ---------------------------------------------------------------------------
+
+///
+/// \brief SKRPluginLoader::pageTypes
+/// \param constructibleOnly
+/// \return the page types of the enabled page plugins, read from their
+/// metadata without loading them
+QStringList SKRPluginLoader::pageTypes(bool constructibleOnly)
+{
+    QStringList list;
+
+    for (auto it = m_pluginsListHash.constBegin(); it != m_pluginsListHash.constEnd(); ++it) {
+        if (it->pageType.isEmpty() || !this->isUsable(it.value(), false)) {
+            continue;
+        }
+
+        if (constructibleOnly && !it->metaData.value("constructible", true).toBool()) {
+            continue;
+        }
+
+        list << it->pageType;
+    }
+
+    return list;
+}
+
+// ---------------------------------------------------------------------------
+
+QObject * SKRPluginLoader::usablePluginObjectByPageType(const QString& pageType)
+{
+    QStringList names;
+
+    for (auto it = m_pluginsListHash.constBegin(); it != m_pluginsListHash.constEnd(); ++it) {
+        if (!pageType.isEmpty() && (it->pageType == pageType) && this->isUsable(it.value(), false)) {
+            names << it.key();
+        }
+    }
+
+    for (const QString& name : qAsConst(names)) {
+        QObject *object = this->pluginObject(name);
+
+        if (object && this->isUsable(object, false)) {
+            return object;
+        }
+    }
+
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
+///
+/// \brief SKRPluginLoader::isUsable
+/// \param plugin
+/// \param includeDisabled
+/// \return
+/// Same as for a loaded plugin, from the metadata and the settings only. The
+/// setting is named after the shortname, which is the name() of the plugin.
+bool SKRPluginLoader::isUsable(const SKRPlugin& plugin, bool includeDisabled) const
+{
+    if (plugin.object) {
+        return this->isUsable(plugin.object, includeDisabled);
+    }
+
+    QSettings settings;
+    QVariant  enabled = settings.value("Plugins/" + plugin.name + "-enabled");
+
+    if (!enabled.isValid()) {
+        return plugin.metaData.value("activatedbydefault").toBool();
+    }
+
+    return enabled.toBool() || includeDisabled;
+}
+
+// ---------------------------------------------------------------------------
+
+bool SKRPluginLoader::isUsable(QObject *object, bool includeDisabled) const
+{
+    SKRCoreInterface *corePlugin = qobject_cast<SKRCoreInterface *>(object);
+
+    if (!corePlugin) {
+        qWarning() << "Plugin" << object->property("shortname").toString() <<
+            "is not SKRCoreInterface, ignoring it";
+        return false;
+    }
+
+    if (!corePlugin->isPluginEnabledSettingExisting()) {
+        if (!object->property("activatedbydefault").toBool()) {
+            return false;
+        }
+    }
+
+    bool pluginEnabled = corePlugin->pluginEnabled();
+
+    if (!pluginEnabled && !includeDisabled) {
+        return false;
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 
 void SKRPluginLoader::installPluginTranslations()
 {
-    // install translation of plugins:
+    // install translation of the loaded plugins:
     QHash<QString, SKRPlugin>::const_iterator i = m_pluginsListHash.constBegin();
 
     while (i != m_pluginsListHash.constEnd()) {
-        QString className = i.value().object->metaObject()->className();
-
-        // qDebug() << className;
-        QTranslator *translator = new QTranslator(qApp);
-
-        if (translator->load(QLocale(PLMUtils::Lang::getUserLang()), className.toLower(),
-                             "_", ":/translations")) {
-            qApp->installTranslator(translator);
+        if (i.value().object) {
+            this->installPluginTranslation(i.value().object->metaObject()->className());
         }
 
         ++i;
     }
 }
+
+// ---------------------------------------------------------------------------
+
+void SKRPluginLoader::installPluginTranslation(const QString& className)
+{
+    // once per plugin
+    if (m_translatedClassNames.contains(className)) {
+        return;
+    }
+    m_translatedClassNames << className;
+
+    QTranslator *translator = new QTranslator(qApp);
+
+    if (translator->load(QLocale(PLMUtils::Lang::getUserLang()), className.toLower(),
+                         "_", ":/translations")) {
+        qApp->installTranslator(translator);
+    }
+}
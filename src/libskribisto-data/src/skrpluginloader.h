@@ -3,6 +3,7 @@
 
 
 #include <QList>
+#include <QHash>
 #include <QPluginLoader>
 #include <QObject>
 #include <QString>
@@ -10,6 +11,7 @@
 #include <QObject>
 #include <QDebug>
 #include <QCoreApplication>
+#include <QVariantMap>
 #include "skribisto_data_global.h"
 #include "skrcoreinterface.h"
 
@@ -18,7 +20,7 @@
 // #include <cxxabi.h>
 
 struct EXPORT SKRPlugin {
-    SKRPlugin() {}
+    SKRPlugin() : object(nullptr) {}
 
     SKRPlugin(const QString& pluginName, const QString& file, QObject *pluginObject)
     {
@@ -28,19 +30,22 @@ struct EXPORT SKRPlugin {
         className = pluginObject->metaObject()->className();
     }
 
-    SKRPlugin(const SKRPlugin& other)
+    // found from its metadata, not loaded yet
+    SKRPlugin(const QString& pluginName, const QString& file, const QVariantMap& pluginMetaData)
     {
-        name      = other.name;
-        fileName  = other.fileName;
-        object    = other.object;
-        className = other.object->metaObject()->className();
+        name     = pluginName;
+        fileName = file;
+        metaData = pluginMetaData;
+        pageType = pluginMetaData.value("pagetype").toString();
+        object   = nullptr;
     }
 
     ~SKRPlugin() {}
 
 
-    QString  name, fileName, className;
-    QObject *object;
+    QString     name, fileName, className, pageType;
+    QVariantMap metaData;
+    QObject    *object;
 };
 Q_DECLARE_METATYPE(SKRPlugin)
 
@@ -61,6 +66,10 @@ public:
     QList<SKRPlugin>         listActivated();
 
 
+    ///
+    /// \brief addPluginType
+    /// The libraries are only read for their metadata, cached between runs.
+    /// A plugin is loaded when first asked for.
     template<typename T>void addPluginType()
     {
         for (QObject *obj : QPluginLoader::staticInstances()) {
@@ -76,54 +85,20 @@ public:
             }
         }
 
-        for (const QString& path : QCoreApplication::libraryPaths()) {
-            QList<QObject *> objects = this->pluginObjectsByDir<T>(path);
-
-            for (QObject *obj : objects) {
-                T *instance = qobject_cast<T *>(obj);
-
-                if (instance) {
-                    SKRPlugin plugin(obj->property("shortname").toString(), obj->property(
-                                         "fileName").toString(), obj);
-
-                    if (!m_pluginsListHash.contains(plugin.name)) {
-                        qDebug() << "plugin found : " << plugin.name;
-                        m_pluginsListHash.insert(plugin.name, plugin);
-                    }
-                }
-            }
-        }
+        this->discoverPlugins();
     }
 
-    template<typename T>QList<T *>pluginsByType(bool includeDisabled = false)
+    ///
+    /// \brief pluginsByType
+    /// \param type "type" of the metadata, like "page"
+    /// \param includeDisabled
+    /// \return the plugins of this type, only them being loaded
+    template<typename T>QList<T *>pluginsByType(const QString& type, bool includeDisabled = false)
     {
         QList<T *> list;
+        const QList<QObject *> objects = this->usablePluginObjects(type, includeDisabled);
 
-        for (SKRPlugin p : m_pluginsListHash.values()) {
-            QObject *object = p.object;
-
-
-            SKRCoreInterface *corePlugin = qobject_cast<SKRCoreInterface *>(object);
-
-            if (!corePlugin) {
-                qWarning() << "Plugin" << object->property("shortname").toString() <<
-                    "is not SKRCoreInterface, ignoring it";
-                continue;
-            }
-
-            if (!corePlugin->isPluginEnabledSettingExisting()) {
-                if (!object->property("activatedbydefault").toBool()) {
-                    continue;
-                }
-            }
-
-            bool pluginEnabled = corePlugin->pluginEnabled();
-
-            if (!pluginEnabled && !includeDisabled) {
-                continue;
-            }
-
-
+        for (QObject *object : objects) {
             if (T *plugin = qobject_cast<T *>(object)) {
                 list.push_back(plugin);
             }
@@ -132,73 +107,40 @@ public:
         return list;
     }
 
-    void installPluginTranslations();
-
-private:
-
-    template<typename T>T* pluginByName(const QString& fileName)
+    ///
+    /// \brief pluginByPageType
+    /// \param pageType
+    /// \return the enabled plugin declaring this "pagetype" in its metadata,
+    /// only this one being loaded
+    template<typename T>T* pluginByPageType(const QString& pageType)
     {
-        QPluginLoader loader(fileName);
-        QObject *plugin = loader.instance();
-
-        if (!plugin) {
-            //            qDebug() << "loader.instance() AT : " + fileName;
-            //            qDebug() << "loader.instance() : " +
-            // loader.errorString();
-
-            // to clean up if wrong libs loaded :
-            plugin->deleteLater();
-        }
-        else {
-            this->installPluginTranslations();
-        }
-
-
-        return qobject_cast<T *>(plugin);
+        return qobject_cast<T *>(this->usablePluginObjectByPageType(pageType));
     }
 
-    template<typename T>QList<T *>pluginByDir(const QString& dir)
-    {
-        QList<T *> ls;
-        QDir plugDir = QDir(dir);
+    QStringList pageTypes(bool constructibleOnly);
 
-        for (const QString& file : plugDir.entryList(QDir::Files)) {
-            if (T *plugin =
-                    SKRPluginLoader::pluginByName<T>(plugDir.absoluteFilePath(file))) {
-                ls.push_back(plugin);
-            }
-        }
-
-        return ls;
-    }
+    void        installPluginTranslations();
 
-    QObject                           * pluginObjectByName(const QString& fileName);
-
-    template<typename T>QList<QObject *>pluginObjectsByDir(const QString& dir)
-    {
-        QList<QObject *> ls;
-        QDir plugDir = QDir(dir);
-        QStringList filter;
-
-        filter << "*.so" << "*.dll" << "*.dylib";
-        QDir::Filters filterFlags(QDir::Files& ~QDir::Executable);
-        QStringList   list = plugDir.entryList(filter, filterFlags, QDir::NoSort);
-
-        for (const QString& file : plugDir.entryList(filter, filterFlags, QDir::NoSort)) {
-            if (T *plugin =
-                    SKRPluginLoader::pluginByName<T>(plugDir.absoluteFilePath(file)))
-                if (plugin) {
-                    ls.push_back(pluginObjectByName(plugDir.absoluteFilePath(file)));
-                }
-        }
+private:
 
-        return ls;
-    }
+    void            discoverPlugins();
+    QObject       * pluginObject(const QString& name);
+    QList<QObject *>usablePluginObjects(const QString& type,
+                                        bool           includeDisabled);
+    QObject       * usablePluginObjectByPageType(const QString& pageType);
+    bool            isUsable(const SKRPlugin& plugin,
+                             bool             includeDisabled) const;
+    bool            isUsable(QObject *object,
+                             bool     includeDisabled) const;
+    void            installPluginTranslation(const QString& className);
 
 private:
 
     QHash<QString, SKRPlugin>m_pluginsListHash;
     QStringList m_pluginTypesList;
+    QStringList m_translatedClassNames;
+    bool m_arePluginsDiscovered;
+    qint64 m_loadingTime; // discovery and loading, in ms
 };
 
 
@@ -659,6 +659,51 @@ QString SKRPropertyHub::getProperty(int            projectId,
 
 // ---------------------------------------------------------------------
 
+///
+/// \brief SKRPropertyHub::getPropertiesForAllItems
+/// \param projectId
+/// \param names
+/// \return tree item code -> property name -> value
+/// All the wanted properties of every item in one query, used to fill the
+/// models at once. Missing properties are absent from the inner hash.
+QHash<int, QHash<QString, QString> >SKRPropertyHub::getPropertiesForAllItems(int                projectId,
+                                                                             const QStringList& names) const
+{
+    SKRResult result(this);
+
+    QHash<int, QHash<QString, QString> > hash;
+    QHash<int, QHash<QString, QVariant> > out;
+    PLMSqlQueries queries(projectId, m_tableName);
+
+    result = queries.getPivotedValues(m_codeFieldName, "t_name", "m_value", names, out);
+
+    IFOK(result) {
+        hash.reserve(out.count());
+
+        QHash<int, QHash<QString, QVariant> >::const_iterator i = out.constBegin();
+
+        while (i != out.constEnd()) {
+            QHash<QString, QString> properties;
+            QHash<QString, QVariant>::const_iterator j = i.value().constBegin();
+
+            while (j != i.value().constEnd()) {
+                properties.insert(j.key(), j.value().toString());
+                ++j;
+            }
+
+            hash.insert(i.key(), properties);
+            ++i;
+        }
+    }
+
+    IFKO(result) {
+        emit errorSent(result);
+    }
+    return hash;
+}
+
+// ---------------------------------------------------------------------
+
 QString SKRPropertyHub::getPropertyById(int projectId, int propertyId) const
 {
     SKRResult result(this);
@@ -24,6 +24,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QHash>
 #include <QList>
 #include <QVariant>
@@ -115,6 +116,8 @@ public:
     QHash<int, bool>   getAllIsSystems(int projectId) const;
     QHash<int, int>    getAllPaperCodes(int projectId) const;
     QList<int>         getAllIds(int projectId) const;
+    QHash<int, QHash<QString, QString> >getPropertiesForAllItems(int                projectId,
+                                                                 const QStringList& names) const;
 
 signals:
 
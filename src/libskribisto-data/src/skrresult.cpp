@@ -20,41 +20,29 @@
 ***************************************************************************/
 #include "skrresult.h"
 
-SKRResult::SKRResult() :  m_status(SKRResult::OK)
-{
-    this->addErrorCode("OK");
-}
+SKRResult::SKRResult() :  m_status(SKRResult::OK), m_origin(nullptr)
+{}
 
-SKRResult::SKRResult(const QObject *object) :  m_status(SKRResult::OK)
-{
-    QString className = object->metaObject()->className();
+SKRResult::SKRResult(const QObject *object) :  m_status(SKRResult::OK),
+    m_origin(object->metaObject()->className())
+{}
 
-    *this = SKRResult(className);
-}
+SKRResult::SKRResult(const char *className) :  m_status(SKRResult::OK), m_origin(className)
+{}
 
-SKRResult::SKRResult(const QString& className) :  m_status(SKRResult::OK)
+SKRResult::SKRResult(const QString& className) :  m_status(SKRResult::OK), m_origin(nullptr)
 {
+    // not static, can't be kept as a pointer
     this->addErrorCode("OK_" + className.toUpper());
 }
 
-SKRResult::SKRResult(const SKRResult& result)
-{
-    m_status        = result.getStatus();
-    m_errorCodeList = result.getErrorCodeList();
-    m_dataHashList  = result.getDataHashList();
-}
+SKRResult::SKRResult(SKRResult::Status status, const QObject *object, const QString& errorCodeEnd) :
+    SKRResult(status, QString::fromLatin1(object->metaObject()->className()), errorCodeEnd)
+{}
 
-SKRResult::SKRResult(SKRResult::Status status, const QObject *object, const QString& errorCodeEnd)
+SKRResult::SKRResult(SKRResult::Status status, const QString& className, const QString& errorCodeEnd) :
+    m_status(status), m_origin(nullptr)
 {
-    QString className = object->metaObject()->className();
-
-    *this = SKRResult(status, className, errorCodeEnd);
-}
-
-SKRResult::SKRResult(SKRResult::Status status, const QString& className, const QString& errorCodeEnd)
-{
-    m_status = status;
-
     // whole errorCode:
     QString errorCode;
 
@@ -94,30 +82,46 @@ SKRResult::operator bool() const
     return !isSuccess();
 }
 
+///
+/// \brief SKRResult::operator =
+/// \param iResult
+/// \return
+/// The status is replaced, the error codes and data are appended. Between two
+/// successes without data, only the origin is replaced.
 SKRResult& SKRResult::operator=(const SKRResult& iResult)
 {
-    if (Q_LIKELY(&iResult != this)) {
-        m_status = iResult.getStatus();
-        m_errorCodeList.append(iResult.getErrorCodeList());
-        m_dataHashList.append(iResult.getDataHashList());
+    if (Q_UNLIKELY(&iResult == this)) {
+        return *this;
+    }
+
+    m_status = iResult.m_status;
+
+    if (Q_LIKELY(!m_payload && !iResult.m_payload)) {
+        m_origin = iResult.m_origin;
+
+        return *this;
     }
 
-    // m_success = iError.isSuccess();
+    // copies first, both may share the same payload
+    const QStringList errorCodeList                     = iResult.getErrorCodeList();
+    const QList<QHash<QString, QVariant> > dataHashList = iResult.getDataHashList();
+
+    this->materialize();
+    m_payload->errorCodeList.append(errorCodeList);
+    m_payload->dataHashList.append(dataHashList);
+
     return *this;
 }
 
 bool SKRResult::operator==(const SKRResult& otherSKRResult) const {
     return m_status == otherSKRResult.getStatus()
-           && m_errorCodeList == otherSKRResult.getErrorCodeList()
-           && m_dataHashList == otherSKRResult.getDataHashList()
+           && this->getErrorCodeList() == otherSKRResult.getErrorCodeList()
+           && this->getDataHashList() == otherSKRResult.getDataHashList()
     ;
 }
 
 bool SKRResult::operator!=(const SKRResult& otherSKRResult) const {
-    return m_status != otherSKRResult.getStatus()
-           || m_errorCodeList != otherSKRResult.getErrorCodeList()
-           || m_dataHashList != otherSKRResult.getDataHashList()
-    ;
+    return !(*this == otherSKRResult);
 }
 
 bool SKRResult::isSuccess() const
@@ -127,12 +131,18 @@ bool SKRResult::isSuccess() const
 
 bool SKRResult::containsErrorCode(const QString& value) const
 {
-    return m_errorCodeList.contains(value);
+    if (!m_payload) {
+        return value == this->successErrorCode();
+    }
+
+    return m_payload->errorCodeList.contains(value);
 }
 
 bool SKRResult::containsErrorCodeDetail(const QString& value) const
 {
-    for (const QString& codeString : m_errorCodeList) {
+    const QStringList errorCodeList = this->getErrorCodeList();
+
+    for (const QString& codeString : errorCodeList) {
         if (codeString.split("__").last() == value) {
             return true;
         }
@@ -143,21 +153,30 @@ bool SKRResult::containsErrorCodeDetail(const QString& value) const
 
 QString SKRResult::getLastErrorCode() const
 {
-    if (m_errorCodeList.isEmpty()) {
+    if (!m_payload) {
+        return this->successErrorCode();
+    }
+
+    if (m_payload->errorCodeList.isEmpty()) {
         return "";
     }
 
-    return m_errorCodeList.last();
+    return m_payload->errorCodeList.last();
 }
 
 QStringList SKRResult::getErrorCodeList() const
 {
-    return m_errorCodeList;
+    if (!m_payload) {
+        return QStringList(this->successErrorCode());
+    }
+
+    return m_payload->errorCodeList;
 }
 
 void SKRResult::setErrorCodeList(const QStringList& value)
 {
-    m_errorCodeList = value;
+    this->materialize();
+    m_payload->errorCodeList = value;
 }
 
 SKRResult::Status SKRResult::getStatus() const
@@ -170,51 +189,76 @@ void SKRResult::setStatus(const SKRResult::Status& status)
     m_status = status;
 }
 
-void SKRResult::addErrorCode(const QString& value)
+QString SKRResult::successErrorCode() const
 {
-    m_errorCodeList.append(value);
+    if (!m_origin) {
+        return "OK";
+    }
+
+    return "OK_" + QString::fromLatin1(m_origin).toUpper();
+}
+
+///
+/// \brief SKRResult::materialize
+/// turns the success into a payload holding its error code, before anything
+/// is added to it
+void SKRResult::materialize()
+{
+    if (m_payload) {
+        return;
+    }
 
-    QHash<QString, QVariant> emptyHash;
+    m_payload = new SKRResultPayload;
+    m_payload->errorCodeList.append(this->successErrorCode());
+    m_payload->dataHashList.append(QHash<QString, QVariant>());
+}
+
+void SKRResult::addErrorCode(const QString& value)
+{
+    if (!m_payload) {
+        m_payload = new SKRResultPayload;
+    }
 
-    m_dataHashList.append(emptyHash);
+    m_payload->errorCodeList.append(value);
+    m_payload->dataHashList.append(QHash<QString, QVariant>());
 }
 
 QList<QHash<QString, QVariant> >SKRResult::getDataHashList() const
 {
-    return m_dataHashList;
+    if (!m_payload) {
+        return QList<QHash<QString, QVariant> >() << QHash<QString, QVariant>();
+    }
+
+    return m_payload->dataHashList;
 }
 
 void SKRResult::setDataHashList(const QList<QHash<QString, QVariant> >& dataHashList)
 {
-    m_dataHashList = dataHashList;
+    this->materialize();
+    m_payload->dataHashList = dataHashList;
 }
 
 void SKRResult::addData(const QString& key, const QVariant& value)
 {
-    QHash<QString, QVariant> lastHash = m_dataHashList.takeLast();
-
-    lastHash.insert(key, value);
-    m_dataHashList.append(lastHash);
+    this->materialize();
+    m_payload->dataHashList.last().insert(key, value);
 }
 
 QVariant SKRResult::getData(const QString& key, const QVariant& defaultValue) const
 {
-    QVariant final = -2;
+    if (!m_payload) {
+        return defaultValue;
+    }
 
     QList<QHash<QString, QVariant> >::const_reverse_iterator i;
 
-    for (i = m_dataHashList.crbegin(); i != m_dataHashList.crend(); ++i) {
-        QHash<QString, QVariant> hash = *i;
-        final = hash.value(key, -2);
+    for (i = m_payload->dataHashList.crbegin(); i != m_payload->dataHashList.crend(); ++i) {
+        QHash<QString, QVariant>::const_iterator it = i->constFind(key);
 
-        if (final != -2) {
-            break;
+        if (it != i->constEnd()) {
+            return it.value();
         }
     }
 
-    if (final == -2) {
-        final = defaultValue;
-    }
-
-    return final;
+    return defaultValue;
 }
@@ -22,7 +22,10 @@
 #define SKRRESULT_H
 
 #include <QObject>
+#include <QHash>
+#include <QSharedData>
 #include <QString>
+#include <QStringList>
 #include <QVariantList>
 #include "skribisto_data_global.h"
 
@@ -46,6 +49,21 @@
         RESULT = ACTION;       \
     }
 
+///
+/// \brief The SKRResultPayload struct
+/// error codes and data of a result, only allocated when there is something
+/// more than a success to tell
+struct SKRResultPayload : public QSharedData {
+    QStringList                     errorCodeList;
+    QList<QHash<QString, QVariant> >dataHashList;
+};
+
+///
+/// \brief The SKRResult struct
+/// A success without data is only a status and the class name of its origin,
+/// copied and assigned without any allocation. Its "OK_CLASSNAME" error code
+/// is only built when asked. The error codes and data are kept in an
+/// implicitly shared payload, created on the first failure or data.
 struct EXPORT SKRResult
 {
     Q_GADGET
@@ -64,8 +82,9 @@ public:
 
     explicit SKRResult();
     SKRResult(const QObject *object);
+    SKRResult(const char *className);
     SKRResult(const QString& className);
-    SKRResult(const SKRResult& result);
+    SKRResult(const SKRResult& result) = default;
 
     SKRResult(SKRResult::Status status,
               const QObject    *object,
@@ -98,16 +117,20 @@ public:
 
 private:
 
-    void addErrorCode(const QString& value);
-    void setDataHashList(const  QList<QHash<QString, QVariant> >& dataHashList);
-    void setErrorCodeList(const QStringList& value);
-    void setStatus(const SKRResult::Status& status);
+    QString successErrorCode() const;
+    void    materialize();
+    void    addErrorCode(const QString& value);
+    void    setDataHashList(const  QList<QHash<QString, QVariant> >& dataHashList);
+    void    setErrorCodeList(const QStringList& value);
+    void    setStatus(const SKRResult::Status& status);
 
 private:
 
-    QStringList                     m_errorCodeList;
-    QList<QHash<QString, QVariant> >m_dataHashList;
-    SKRResult::Status               m_status;
+    SKRResult::Status m_status;
+
+    // static class name given by the meta object or a literal, nullptr for a plain "OK"
+    const char *m_origin;
+    QSharedDataPointer<SKRResultPayload>m_payload;
 };
 
 #endif // SKRRESULT_H
@@ -0,0 +1,413 @@
+/***************************************************************************
+*   Copyright (C) 2021 by Cyril Jacquet                                 *
+*   cyril.jacquet@skribisto.eu                                        *
+*                                                                         *
+*  Filename: skrsearchhub.cpp                                                   *
+*  This file is part of Skribisto.                                    *
+*                                                                         *
+*  Skribisto is free software: you can redistribute it and/or modify  *
+*  it under the terms of the GNU General Public License as published by   *
+*  the Free Software Foundation, either version 3 of the License, or      *
+*  (at your option) any later version.                                    *
+*                                                                         *
+*  Skribisto is distributed in the hope that it will be useful,       *
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+*  GNU General Public License for more details.                           *
+*                                                                         *
+*  You should have received a copy of the GNU General Public License      *
+*  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
+***************************************************************************/
+#include "skrsearchhub.h"
+#include "plmdata.h"
+#include "tasks/plmprojectmanager.h"
+
+#include <QRegularExpression>
+#include <QSqlError>
+#include <QSqlQuery>
+
+namespace {
+const QString tagsOfTreeItemStr =
+    "(SELECT group_concat(tbl_tag.t_name, ' ')"
+    " FROM main.tbl_tag_relationship"
+    " JOIN main.tbl_tag ON tbl_tag.l_tag_id = tbl_tag_relationship.l_tag_code"
+    " WHERE tbl_tag_relationship.l_tree_code = %1)";
+
+QStringList splitSearchText(const QString& text)
+{
+    static const QRegularExpression blankRegex("\\s+");
+
+    return text.split(blankRegex, Qt::SkipEmptyParts);
+}
+}
+
+SKRSearchHub::SKRSearchHub(QObject *parent) : QObject(parent)
+{
+    // the temporary index dies with the connection
+    connect(plmdata->projectHub(), &PLMProjectHub::projectLoaded,
+            this, &SKRSearchHub::forgetIndex);
+    connect(plmdata->projectHub(), &PLMProjectHub::projectClosed,
+            this, &SKRSearchHub::forgetIndex);
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRSearchHub::getRankedIds
+/// \param projectId
+/// \param text
+/// \param limit
+/// \return ids of the tree items holding every word of text, best match first
+QList<int>SKRSearchHub::getRankedIds(int projectId, const QString& text, int limit)
+{
+    QList<int> list;
+    QString    matchExpression = toMatchExpression(text);
+
+    if (matchExpression.isEmpty()) {
+        return list;
+    }
+
+    PLMProject *project = plmProjectManager->project(projectId);
+
+    if (!project) {
+        return list;
+    }
+
+    // contents still in the journal are not in tbl_tree yet
+    plmdata->treeHub()->compactContentJournal(projectId);
+
+    if (!this->isFullTextIndexAvailable(projectId)) {
+        return this->getIdsWithoutIndex(projectId, text, limit);
+    }
+
+    SKRResult result(this);
+    QSqlQuery query(project->getSqlDb());
+    QString   queryStr = "SELECT rowid FROM temp.tbl_tree_search"
+                         " WHERE tbl_tree_search MATCH :match"
+                         " ORDER BY rank"
+                         " LIMIT :limit"
+    ;
+
+    query.prepare(queryStr);
+    query.bindValue(":match", matchExpression);
+    query.bindValue(":limit", limit);
+    query.exec();
+
+    while (query.next()) {
+        list.append(query.value(0).toInt());
+    }
+
+    if (query.lastError().isValid()) {
+        result = SKRResult(SKRResult::Critical, this, "sql_error");
+        result.addData("SQLError",   query.lastError().text());
+        result.addData("SQL string", queryStr);
+        emit errorSent(result);
+    }
+
+    return list;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRSearchHub::getMatches
+/// \param projectId
+/// \param text
+/// \param limit
+/// \return one map per matching tree item, best match first, with treeItemId,
+/// rank, a plain snippet and the start and length of each match in it
+QVariantList SKRSearchHub::getMatches(int projectId, const QString& text, int limit)
+{
+    QVariantList list;
+    QString matchExpression = toMatchExpression(text);
+
+    PLMProject *project = plmProjectManager->project(projectId);
+
+    if (matchExpression.isEmpty() || !project) {
+        return list;
+    }
+
+    plmdata->treeHub()->compactContentJournal(projectId);
+
+    if (!this->isFullTextIndexAvailable(projectId)) {
+        const QList<int> ids = this->getIdsWithoutIndex(projectId, text, limit);
+
+        for (int id : ids) {
+            QVariantMap map;
+            map.insert("treeItemId", id);
+            map.insert("rank",       0.0);
+            map.insert("snippet",    QString());
+            map.insert("matches",    QVariantList());
+            list.append(map);
+        }
+
+        return list;
+    }
+
+    SKRResult result(this);
+    QSqlQuery query(project->getSqlDb());
+
+    // char(2) and char(3) mark the matches, they can't be typed
+    QString queryStr = "SELECT rowid, rank,"
+                       " snippet(tbl_tree_search, -1, char(2), char(3), '...', 24)"
+                       " FROM temp.tbl_tree_search"
+                       " WHERE tbl_tree_search MATCH :match"
+                       " ORDER BY rank"
+                       " LIMIT :limit"
+    ;
+
+    query.prepare(queryStr);
+    query.bindValue(":match", matchExpression);
+    query.bindValue(":limit", limit);
+    query.exec();
+
+    while (query.next()) {
+        QString markedSnippet = query.value(2).toString();
+        QString snippet;
+        QVariantList matches;
+        int matchStart = -1;
+
+        snippet.reserve(markedSnippet.size());
+
+        for (const QChar& c : qAsConst(markedSnippet)) {
+            if (c.unicode() == 2) {
+                matchStart = snippet.size();
+            }
+            else if ((c.unicode() == 3) && (matchStart != -1)) {
+                QVariantMap match;
+                match.insert("start",  matchStart);
+                match.insert("length", snippet.size() - matchStart);
+                matches.append(match);
+                matchStart = -1;
+            }
+            else {
+                snippet.append(c);
+            }
+        }
+
+        QVariantMap map;
+        map.insert("treeItemId", query.value(0).toInt());
+        map.insert("rank",       query.value(1).toDouble());
+        map.insert("snippet",    snippet);
+        map.insert("matches",    matches);
+        list.append(map);
+    }
+
+    if (query.lastError().isValid()) {
+        result = SKRResult(SKRResult::Critical, this, "sql_error");
+        result.addData("SQLError",   query.lastError().text());
+        result.addData("SQL string", queryStr);
+        emit errorSent(result);
+    }
+
+    return list;
+}
+
+// ----------------------------------------------------------------------------------------
+
+bool SKRSearchHub::isFullTextIndexAvailable(int projectId)
+{
+    IndexState state = m_indexStateByProjectHash.value(projectId, NotBuilt);
+
+    if (state == NotBuilt) {
+        SKRResult result = this->buildIndex(projectId);
+
+        state = result.isSuccess() ? Built : Unavailable;
+        m_indexStateByProjectHash.insert(projectId, state);
+
+        // told once, the state stays Unavailable until the project is reloaded
+        IFKO(result) {
+            SKRResult warning(SKRResult::Warning, this, "full_text_index_unavailable");
+            warning.addData("projectId", projectId);
+            warning.addData("SQLError",  result.getData("SQLError", "").toString());
+            emit errorSent(warning);
+        }
+    }
+
+    return state == Built;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRSearchHub::toMatchExpression
+/// \param text
+/// \return text typed by the user as an FTS5 query : every word quoted, as a
+/// prefix, all needed
+QString SKRSearchHub::toMatchExpression(const QString& text)
+{
+    QStringList phrases;
+
+    const QStringList words = splitSearchText(text);
+
+    for (QString word : words) {
+        phrases << "\"" + word.replace("\"", "\"\"") + "\"*";
+    }
+
+    return phrases.join(" ");
+}
+
+// ----------------------------------------------------------------------------------------
+
+void SKRSearchHub::forgetIndex(int projectId)
+{
+    m_indexStateByProjectHash.remove(projectId);
+}
+
+// ----------------------------------------------------------------------------------------
+
+SKRResult SKRSearchHub::buildIndex(int projectId)
+{
+    SKRResult result(this);
+
+    PLMProject *project = plmProjectManager->project(projectId);
+
+    if (!project) {
+        result = SKRResult(SKRResult::Critical, this, "project_not_found");
+        result.addData("projectId", projectId);
+        return result;
+    }
+
+    QSqlDatabase sqlDb = project->getSqlDb();
+    QStringList  queryStrList;
+
+    queryStrList
+        << "CREATE VIRTUAL TABLE IF NOT EXISTS temp.tbl_tree_search USING fts5("
+           "t_title, m_primary_content, m_secondary_content, t_tags,"
+           " tokenize = 'unicode61 remove_diacritics 1')"
+        << "DELETE FROM temp.tbl_tree_search"
+        << "INSERT INTO temp.tbl_tree_search (rowid, t_title, m_primary_content, m_secondary_content, t_tags)"
+           " SELECT l_tree_id, t_title, m_primary_content, m_secondary_content, "
+           + tagsOfTreeItemStr.arg("tbl_tree.l_tree_id")
+           + " FROM main.tbl_tree"
+
+        // tree
+        << "CREATE TEMP TRIGGER IF NOT EXISTS trg_tree_search_insert AFTER INSERT ON main.tbl_tree"
+           " BEGIN"
+           " INSERT INTO tbl_tree_search (rowid, t_title, m_primary_content, m_secondary_content, t_tags)"
+           " VALUES (new.l_tree_id, new.t_title, new.m_primary_content, new.m_secondary_content, '');"
+           " END"
+        << "CREATE TEMP TRIGGER IF NOT EXISTS trg_tree_search_update"
+           " AFTER UPDATE OF l_tree_id, t_title, m_primary_content, m_secondary_content ON main.tbl_tree"
+           " BEGIN"
+           " UPDATE tbl_tree_search SET rowid = new.l_tree_id, t_title = new.t_title,"
+           " m_primary_content = new.m_primary_content, m_secondary_content = new.m_secondary_content"
+           " WHERE rowid = old.l_tree_id;"
+           " END"
+        << "CREATE TEMP TRIGGER IF NOT EXISTS trg_tree_search_delete AFTER DELETE ON main.tbl_tree"
+           " BEGIN"
+           " DELETE FROM tbl_tree_search WHERE rowid = old.l_tree_id;"
+           " END"
+
+        // tags
+        << "CREATE TEMP TRIGGER IF NOT EXISTS trg_tree_search_tag_relationship_insert"
+           " AFTER INSERT ON main.tbl_tag_relationship"
+           " BEGIN"
+           " UPDATE tbl_tree_search SET t_tags = " + tagsOfTreeItemStr.arg("new.l_tree_code")
+           + " WHERE rowid = new.l_tree_code;"
+             " END"
+        << "CREATE TEMP TRIGGER IF NOT EXISTS trg_tree_search_tag_relationship_delete"
+           " AFTER DELETE ON main.tbl_tag_relationship"
+           " BEGIN"
+           " UPDATE tbl_tree_search SET t_tags = " + tagsOfTreeItemStr.arg("old.l_tree_code")
+           + " WHERE rowid = old.l_tree_code;"
+             " END"
+        << "CREATE TEMP TRIGGER IF NOT EXISTS trg_tree_search_tag_update"
+           " AFTER UPDATE OF t_name ON main.tbl_tag"
+           " BEGIN"
+           " UPDATE tbl_tree_search SET t_tags = " + tagsOfTreeItemStr.arg("tbl_tree_search.rowid")
+           + " WHERE rowid IN (SELECT l_tree_code FROM main.tbl_tag_relationship WHERE l_tag_code = new.l_tag_id);"
+             " END"
+
+        // the relationships of a removed tag are left behind, its name is not
+        << "CREATE TEMP TRIGGER IF NOT EXISTS trg_tree_search_tag_delete"
+           " AFTER DELETE ON main.tbl_tag"
+           " BEGIN"
+           " UPDATE tbl_tree_search SET t_tags = " + tagsOfTreeItemStr.arg("tbl_tree_search.rowid")
+           + " WHERE rowid IN (SELECT l_tree_code FROM main.tbl_tag_relationship WHERE l_tag_code = old.l_tag_id);"
+             " END";
+
+    QSqlQuery query(sqlDb);
+
+    for (const QString& queryStr : qAsConst(queryStrList)) {
+        query.exec(queryStr);
+
+        if (query.lastError().isValid()) {
+            result = SKRResult(SKRResult::Critical, this, "sql_error");
+            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQL string", queryStr);
+
+            // leave nothing half built
+            query.exec("DROP TRIGGER IF EXISTS temp.trg_tree_search_insert");
+            query.exec("DROP TRIGGER IF EXISTS temp.trg_tree_search_update");
+            query.exec("DROP TRIGGER IF EXISTS temp.trg_tree_search_delete");
+            query.exec("DROP TRIGGER IF EXISTS temp.trg_tree_search_tag_relationship_insert");
+            query.exec("DROP TRIGGER IF EXISTS temp.trg_tree_search_tag_relationship_delete");
+            query.exec("DROP TRIGGER IF EXISTS temp.trg_tree_search_tag_update");
+            query.exec("DROP TRIGGER IF EXISTS temp.trg_tree_search_tag_delete");
+            query.exec("DROP TABLE IF EXISTS temp.tbl_tree_search");
+            break;
+        }
+    }
+
+    return result;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRSearchHub::getIdsWithoutIndex
+/// slow path : every word must be in the title, the contents or the tags
+QList<int>SKRSearchHub::getIdsWithoutIndex(int projectId, const QString& text, int limit) const
+{
+    QList<int> list;
+    SKRResult  result(this);
+    PLMProject *project = plmProjectManager->project(projectId);
+
+    if (!project) {
+        return list;
+    }
+
+    const QStringList words = splitSearchText(text);
+    QStringList whereList;
+
+    for (int i = 0; i < words.count(); i++) {
+        QString bindStr = QString(":word%1").arg(i);
+
+        whereList << "(t_title LIKE " + bindStr + " ESCAPE '\\'"
+                     " OR m_primary_content LIKE " + bindStr + " ESCAPE '\\'"
+                     " OR m_secondary_content LIKE " + bindStr + " ESCAPE '\\'"
+                     " OR " + tagsOfTreeItemStr.arg("tbl_tree.l_tree_id") + " LIKE " + bindStr + " ESCAPE '\\')";
+    }
+
+    QSqlQuery query(project->getSqlDb());
+    QString   queryStr = "SELECT l_tree_id FROM main.tbl_tree"
+                         " WHERE " + whereList.join(" AND ")
+                         + " ORDER BY l_sort_order"
+                           " LIMIT :limit"
+    ;
+
+    query.prepare(queryStr);
+
+    for (int i = 0; i < words.count(); i++) {
+        QString word = words.at(i);
+
+        word.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+        query.bindValue(QString(":word%1").arg(i), "%" + word + "%");
+    }
+    query.bindValue(":limit", limit);
+    query.exec();
+
+    while (query.next()) {
+        list.append(query.value(0).toInt());
+    }
+
+    if (query.lastError().isValid()) {
+        result = SKRResult(SKRResult::Critical, this, "sql_error");
+        result.addData("SQLError",   query.lastError().text());
+        result.addData("SQL string", queryStr);
+        emit errorSent(result);
+    }
+
+    return list;
+}
@@ -0,0 +1,80 @@
+/***************************************************************************
+*   Copyright (C) 2021 by Cyril Jacquet                                 *
+*   cyril.jacquet@skribisto.eu                                        *
+*                                                                         *
+*  Filename: skrsearchhub.h                                                   *
+*  This file is part of Skribisto.                                    *
+*                                                                         *
+*  Skribisto is free software: you can redistribute it and/or modify  *
+*  it under the terms of the GNU General Public License as published by   *
+*  the Free Software Foundation, either version 3 of the License, or      *
+*  (at your option) any later version.                                    *
+*                                                                         *
+*  Skribisto is distributed in the hope that it will be useful,       *
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+*  GNU General Public License for more details.                           *
+*                                                                         *
+*  You should have received a copy of the GNU General Public License      *
+*  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
+***************************************************************************/
+#ifndef SKRSEARCHHUB_H
+#define SKRSEARCHHUB_H
+
+#include <QObject>
+#include <QHash>
+#include <QVariant>
+#include "skrresult.h"
+#include "skribisto_data_global.h"
+
+///
+/// \brief The SKRSearchHub class
+/// Full-text search over the titles, the primary and secondary contents and the
+/// tag names of the tree items. The FTS5 index lives in the temporary schema of
+/// the project connection, it is built on the first search and kept up to date
+/// by temporary triggers, so the project file itself is left untouched. Without
+/// FTS5, searches fall back to LIKE queries.
+class EXPORT SKRSearchHub : public QObject {
+    Q_OBJECT
+
+public:
+
+    explicit SKRSearchHub(QObject *parent);
+
+    Q_INVOKABLE QList<int>  getRankedIds(int            projectId,
+                                         const QString& text,
+                                         int            limit = -1);
+    Q_INVOKABLE QVariantList getMatches(int            projectId,
+                                        const QString& text,
+                                        int            limit = 50);
+    Q_INVOKABLE bool        isFullTextIndexAvailable(int projectId);
+
+    static QString          toMatchExpression(const QString& text);
+
+signals:
+
+    void errorSent(const SKRResult& result) const;
+
+private slots:
+
+    void forgetIndex(int projectId);
+
+private:
+
+    SKRResult buildIndex(int projectId);
+    QList<int>getIdsWithoutIndex(int            projectId,
+                                 const QString& text,
+                                 int            limit) const;
+
+private:
+
+    enum IndexState {
+        NotBuilt,
+        Built,
+        Unavailable
+    };
+
+    QHash<int, IndexState>m_indexStateByProjectHash;
+};
+
+#endif // SKRSEARCHHUB_H
@@ -1,42 +1,172 @@
 #include "skrstathub.h"
 #include "plmdata.h"
 
+#include <QDebug>
+#include <QElapsedTimer>
+
+namespace {
+const QString countPropertyNames[]             = { "char_count", "word_count" };
+const QString countWithChildrenPropertyNames[] = { "char_count_with_children", "word_count_with_children" };
+const SKRStatHub::StatType statTypes[]         = { SKRStatHub::Character, SKRStatHub::Word };
+const QString fingerprintPropertyName          = "count_fingerprint";
+
+void markToPersist(QHash<int, bool>& toPersistHash, int treeItemId, bool triggerProjectModifiedSignal)
+{
+    toPersistHash[treeItemId] = toPersistHash.value(treeItemId, false) || triggerProjectModifiedSignal;
+}
+}
+
 SKRStatHub::SKRStatHub(QObject *parent) : QObject(parent)
 {
+    // properties are written in batches, not on each count
+    m_persistTimer = new QTimer(this);
+    m_persistTimer->setSingleShot(true);
+    m_persistTimer->setInterval(300);
+    connect(m_persistTimer, &QTimer::timeout, this, &SKRStatHub::persistAllStats);
+
     connect(plmdata->treeHub(), &SKRTreeHub::trashedChanged,
             this, &SKRStatHub::setTreeItemTrashed);
 
     connect(plmdata->treeHub(), &SKRTreeHub::treeItemRemoved,
             this, &SKRStatHub::removeTreeItemFromStat);
+
+    // the structure changed, the counts with children will be recomputed once
+    connect(plmdata->treeHub(), &SKRTreeHub::treeItemAdded,
+            this, &SKRStatHub::setStructureOutdated);
+    connect(plmdata->treeHub(), &SKRTreeHub::treeItemsAdded,
+            this, &SKRStatHub::setStructureOutdated);
+    connect(plmdata->treeHub(), &SKRTreeHub::treeItemMoved,
+            this, &SKRStatHub::setStructureOutdated);
+    connect(plmdata->treeHub(), &SKRTreeHub::indentChanged,
+            this, &SKRStatHub::setStructureOutdated);
+
+    connect(plmdata->projectHub(), &PLMProjectHub::projectToBeSaved,
+            this, &SKRStatHub::persistStats, Qt::DirectConnection);
+    connect(plmdata->projectHub(), &PLMProjectHub::projectToBeClosed,
+            this, &SKRStatHub::clearProjectStats, Qt::DirectConnection);
 }
 
 int SKRStatHub::getTreeItemTotalCount(SKRStatHub::StatType type, int project)
 {
-    int totalCount                                = 0;
-    QHash<int, QHash<QString, int> > treeItemHash = m_treeItemHashByProjectHash.value(project,
-                                                                                      QHash<int,
-                                                                                            QHash<QString, int> >());
+    return m_statsByProjectHash.value(project).totalCounts[type];
+}
+
+// ---------------------------------------------------------------------------------
+
+///
+/// \brief SKRStatHub::getTreeItemCountWithChildren
+/// \param type
+/// \param projectId
+/// \param treeItemId
+/// \return the count of the item and of its not trashed descendants
+int SKRStatHub::getTreeItemCountWithChildren(SKRStatHub::StatType type, int projectId, int treeItemId)
+{
+    if (!m_statsByProjectHash.contains(projectId)) {
+        return 0;
+    }
+
+    return this->projectStats(projectId).countsWithChildren[type].value(treeItemId, 0);
+}
+
+// ---------------------------------------------------------------------------------
+
+///
+/// \brief SKRStatHub::getFingerprints
+/// \param projectId
+/// \return tree item id -> fingerprint of the content the stored counts come from
+QHash<int, QString>SKRStatHub::getFingerprints(int projectId) const
+{
+    return m_statsByProjectHash.value(projectId).fingerprints;
+}
+
+// ---------------------------------------------------------------------------------
+
+QVariantMap SKRStatHub::getCountingStats(int projectId) const
+{
+    CountingStats countingStats = m_statsByProjectHash.value(projectId).countingStats;
+    QVariantMap   map;
+
+    map.insert("storedCount",  countingStats.storedCount);
+    map.insert("countedCount", countingStats.countedCount);
+    map.insert("skippedCount", countingStats.skippedCount);
+    map.insert("loadingTime",  countingStats.loadingTime);
+    map.insert("countingTime", countingStats.countingTime);
+
+    return map;
+}
+
+// ---------------------------------------------------------------------------------
+
+///
+/// \brief SKRStatHub::loadStats
+/// \param projectId
+/// The counts stored in the properties are taken as they are, in one query.
+/// Only the contents whose fingerprint changed have to be counted again.
+void SKRStatHub::loadStats(int projectId)
+{
+    QElapsedTimer timer;
+
+    timer.start();
+
+    // nothing waiting to be written is lost
+    this->persistStats(projectId);
+
+    QStringList names;
+
+    for (SKRStatHub::StatType type : statTypes) {
+        names << countPropertyNames[type] << countWithChildrenPropertyNames[type];
+    }
+    names << fingerprintPropertyName;
+
+    const QHash<int, QHash<QString, QString> > properties =
+        plmdata->treePropertyHub()->getPropertiesForAllItems(projectId, names);
+
+    ProjectStats stats;
+
+    stats.trashedStates = plmdata->treeHub()->getAllTrashedStates(projectId);
+
+    for (auto it = properties.constBegin(); it != properties.constEnd(); ++it) {
+        int treeItemId                                = it.key();
+        const QHash<QString, QString>& itemProperties = it.value();
+        bool isTrashed                                = stats.trashedStates.value(treeItemId, false);
 
-    QHash<int, QHash<QString, int> >::const_iterator i = treeItemHash.constBegin();
+        for (SKRStatHub::StatType type : statTypes) {
+            auto countIt = itemProperties.constFind(countPropertyNames[type]);
 
-    while (i != treeItemHash.constEnd()) {
-        QHash<QString, int> hash = i.value();
+            if (countIt != itemProperties.constEnd()) {
+                int count = countIt.value().toInt();
 
-        if (!hash.value("isTrashed", 0)) {
-            switch (type) {
-            case SKRStatHub::Character:
-                totalCount += hash.value("characterCount", 0);
-                break;
+                stats.counts[type].insert(treeItemId, count);
 
-            case SKRStatHub::Word:
-                totalCount += hash.value("wordCount", 0);
-                break;
+                if (!isTrashed) {
+                    stats.totalCounts[type] += count;
+                }
             }
+
+            auto countWithChildrenIt = itemProperties.constFind(countWithChildrenPropertyNames[type]);
+
+            if (countWithChildrenIt != itemProperties.constEnd()) {
+                stats.countsWithChildren[type].insert(treeItemId, countWithChildrenIt.value().toInt());
+            }
+        }
+
+        auto fingerprintIt = itemProperties.constFind(fingerprintPropertyName);
+
+        if (fingerprintIt != itemProperties.constEnd()) {
+            stats.fingerprints.insert(treeItemId, fingerprintIt.value());
+            stats.countingStats.storedCount++;
         }
-        ++i;
     }
 
-    return totalCount;
+    // checked against the loaded counts with children once, only what moved is written
+    stats.isStructureOutdated = true;
+
+    stats.countingStats.loadingTime = timer.elapsed();
+    m_statsByProjectHash.insert(projectId, stats);
+
+    for (SKRStatHub::StatType type : statTypes) {
+        emit statsChanged(type, projectId, stats.totalCounts[type]);
+    }
 }
 
 // ---------------------------------------------------------------------------------
@@ -46,191 +176,367 @@ void SKRStatHub::updateWordStats(int  projectId,
                                  int  wordCount,
                                  bool triggerProjectModifiedSignal)
 {
-    QHash<int, QHash<QString, int> > projectHash = m_treeItemHashByProjectHash.value(projectId);
-    SKRPropertyHub *propertyHub                  = plmdata->treePropertyHub();
-    SKRTreeHub     *treeHub                      = plmdata->treeHub();
+    this->updateStats(SKRStatHub::Word, projectId, treeItemId, wordCount, triggerProjectModifiedSignal);
+}
 
+// ---------------------------------------------------------------------------------
 
-    // ------------- get trashed
-    bool isTrashed = treeHub->getTrashed(projectId, treeItemId);
+void SKRStatHub::updateCharacterStats(int  projectId,
+                                      int  treeItemId,
+                                      int  characterCount,
+                                      bool triggerProjectModifiedSignal)
+{
+    this->updateStats(SKRStatHub::Character, projectId, treeItemId, characterCount, triggerProjectModifiedSignal);
+}
 
-    // ------------- update word_count
+// ---------------------------------------------------------------------------------
 
-    if (wordCount != -1) {
-        propertyHub->setProperty(projectId,
-                                 treeItemId,
-                                 "word_count",
-                                 QString::number(wordCount),
-                                 true,
-                                 triggerProjectModifiedSignal);
-    }
+void SKRStatHub::updateFingerprint(int projectId, int treeItemId, const QString& fingerprint)
+{
+    ProjectStats& stats = this->projectStats(projectId);
 
-    // ------------- update general stats
+    if (stats.fingerprints.value(treeItemId) == fingerprint) {
+        return;
+    }
 
-    QHash<QString, int> treeItemHash = projectHash.value(treeItemId);
+    stats.fingerprints.insert(treeItemId, fingerprint);
+    stats.fingerprintsToPersist.insert(treeItemId);
 
-    if (wordCount != -1) {
-        treeItemHash.insert("wordCount", wordCount);
+    if (!m_persistTimer->isActive()) {
+        m_persistTimer->start();
     }
-    treeItemHash.insert("isTrashed", isTrashed);
-    projectHash.insert(treeItemId, treeItemHash);
-
-    int totalCount = 0;
+}
 
-    m_treeItemHashByProjectHash.insert(projectId, projectHash);
-    totalCount = getTreeItemTotalCount(SKRStatHub::Word, projectId);
+// ---------------------------------------------------------------------------------
 
-    emit statsChanged(SKRStatHub::Word, projectId, totalCount);
+void SKRStatHub::recordCountingRun(int projectId, int countedCount, int skippedCount, qint64 elapsedTime)
+{
+    if (!m_statsByProjectHash.contains(projectId)) {
+        return;
+    }
 
+    CountingStats& countingStats = m_statsByProjectHash[projectId].countingStats;
 
-    // -------------update parents' charCountWithChildren:
+    countingStats.countedCount = countedCount;
+    countingStats.skippedCount = skippedCount;
+    countingStats.countingTime = elapsedTime;
 
-    // get all ancestors
-    QList<int> ancestors = treeHub->getAllAncestors(projectId, treeItemId);
+    qDebug() << "counts loaded in" << countingStats.loadingTime << "ms," << countedCount << "items counted and" <<
+        skippedCount << "unchanged skipped in" << elapsedTime << "ms";
+}
 
-    ancestors.prepend(treeItemId);
+// ---------------------------------------------------------------------------------
 
-    // for each ancestor, get all children
+///
+/// \brief SKRStatHub::updateStats
+/// \param type
+/// \param projectId
+/// \param treeItemId
+/// \param count
+/// \param triggerProjectModifiedSignal
+/// Only the difference with the previous count is added to the item and to its
+/// ancestors, so the cost depends on the depth and not on the size of the tree.
+void SKRStatHub::updateStats(SKRStatHub::StatType type,
+                             int                  projectId,
+                             int                  treeItemId,
+                             int                  count,
+                             bool                 triggerProjectModifiedSignal)
+{
+    ProjectStats& stats = this->projectStats(projectId);
+    bool isTrashed      = this->getTrashed(stats, projectId, treeItemId);
 
-    for (int ancestorId : qAsConst(ancestors)) {
-        QList<int> children = treeHub->getAllChildren(projectId, ancestorId);
+    if (count != -1) {
+        int difference = count - stats.counts[type].value(treeItemId, 0);
 
-        // remove trashed
-        QMutableListIterator<int> i(children);
+        stats.counts[type].insert(treeItemId, count);
+        markToPersist(stats.countsToPersist[type], treeItemId, triggerProjectModifiedSignal);
 
-        while (i.hasNext()) {
-            int childId                   = i.next();
-            QHash<QString, int> childHash = projectHash.value(childId, QHash<QString, int>());
+        if (difference != 0) {
+            stats.countsWithChildren[type][treeItemId] += difference;
 
-            if (childHash.value("isTrashed", 0)) {
-                i.remove();
+            if (!isTrashed) {
+                stats.totalCounts[type] += difference;
+                this->addToAncestors(type, stats, projectId, treeItemId, difference, triggerProjectModifiedSignal);
             }
         }
+    }
 
-        int totalChildrenCount = 0;
+    markToPersist(stats.countsWithChildrenToPersist[type], treeItemId, triggerProjectModifiedSignal);
 
-        for (int childId : qAsConst(children)) {
-            QHash<QString, int> childHash = projectHash.value(childId, QHash<QString, int>());
+    emit statsChanged(type, projectId, stats.totalCounts[type]);
 
-            totalChildrenCount += childHash.value("wordCount", 0);
-        }
+    if (!m_persistTimer->isActive()) {
+        m_persistTimer->start();
+    }
+}
 
-        // add ancestor count
-        QHash<QString, int> ancestorHash = projectHash.value(ancestorId, QHash<QString, int>());
-        totalChildrenCount += ancestorHash.value("wordCount", 0);
+// ---------------------------------------------------------------------------------
 
-        // set property
+void SKRStatHub::addToAncestors(SKRStatHub::StatType type,
+                                ProjectStats       & stats,
+                                int                  projectId,
+                                int                  treeItemId,
+                                int                  difference,
+                                bool                 triggerProjectModifiedSignal)
+{
+    const QList<int> ancestors = plmdata->treeHub()->getAllAncestors(projectId, treeItemId);
 
-        propertyHub->setProperty(projectId, ancestorId, "word_count_with_children",
-                                 QString::number(totalChildrenCount), true, triggerProjectModifiedSignal);
+    for (int ancestorId : ancestors) {
+        stats.countsWithChildren[type][ancestorId] += difference;
+        markToPersist(stats.countsWithChildrenToPersist[type], ancestorId, triggerProjectModifiedSignal);
     }
 }
 
 // ---------------------------------------------------------------------------------
 
-void SKRStatHub::updateCharacterStats(int  projectId,
-                                      int  treeItemId,
-                                      int  characterCount,
-                                      bool triggerProjectModifiedSignal)
+bool SKRStatHub::getTrashed(ProjectStats& stats, int projectId, int treeItemId)
 {
-    QHash<int, QHash<QString, int> > projectHash = m_treeItemHashByProjectHash.value(projectId);
-    SKRPropertyHub *propertyHub                  = plmdata->treePropertyHub();
-    SKRTreeHub     *treeHub                      = plmdata->treeHub();
+    auto it = stats.trashedStates.constFind(treeItemId);
 
-    // ------------- get trashed
-    bool isTrashed = treeHub->getTrashed(projectId, treeItemId);
+    if (it != stats.trashedStates.constEnd()) {
+        return it.value();
+    }
 
-    // ------------- update char_count
+    bool isTrashed = plmdata->treeHub()->getTrashed(projectId, treeItemId);
 
-    if (characterCount != -1) {
-        propertyHub->setProperty(projectId,
-                                 treeItemId,
-                                 "char_count",
-                                 QString::number(characterCount),
-                                 true,
-                                 triggerProjectModifiedSignal);
-    }
+    stats.trashedStates.insert(treeItemId, isTrashed);
 
-    // ------------- update general stats
+    return isTrashed;
+}
 
-    QHash<QString, int> treeItemHash = projectHash.value(treeItemId);
+// ---------------------------------------------------------------------------------
+
+SKRStatHub::ProjectStats& SKRStatHub::projectStats(int projectId)
+{
+    ProjectStats& stats = m_statsByProjectHash[projectId];
 
-    if (characterCount != -1) {
-        treeItemHash.insert("characterCount", characterCount);
+    if (stats.isStructureOutdated) {
+        this->recomputeCountsWithChildren(stats, projectId);
     }
 
-    treeItemHash.insert("isTrashed", isTrashed);
-    projectHash.insert(treeItemId, treeItemHash);
+    return stats;
+}
 
-    int totalCount = 0;
+// ---------------------------------------------------------------------------------
 
-    m_treeItemHashByProjectHash.insert(projectId, projectHash);
-    totalCount = getTreeItemTotalCount(SKRStatHub::Character, projectId);
+///
+/// \brief SKRStatHub::recomputeCountsWithChildren
+/// \param stats
+/// \param projectId
+/// full pass, only needed after the tree structure changed
+void SKRStatHub::recomputeCountsWithChildren(ProjectStats& stats, int projectId)
+{
+    stats.isStructureOutdated = false;
 
-    emit statsChanged(SKRStatHub::Character, projectId, totalCount);
+    SKRTreeHub *treeHub = plmdata->treeHub();
 
-    // -------------update parents' charCountWithChildren:
+    for (SKRStatHub::StatType type : statTypes) {
+        QHash<int, int> countsWithChildren;
 
-    // get all ancerstors
-    QList<int> ancestors = treeHub->getAllAncestors(projectId, treeItemId);
+        countsWithChildren.reserve(stats.counts[type].count());
 
-    ancestors.prepend(treeItemId);
+        for (auto it = stats.counts[type].constBegin(); it != stats.counts[type].constEnd(); ++it) {
+            int treeItemId = it.key();
+            int count      = it.value();
 
-    // for each ancestor, get all children
+            countsWithChildren[treeItemId] += count;
 
-    for (int ancestorId : qAsConst(ancestors)) {
-        QList<int> children = treeHub->getAllChildren(projectId, ancestorId);
+            if ((count == 0) || stats.trashedStates.value(treeItemId, false)) {
+                continue;
+            }
 
-        // remove trashed
-        QMutableListIterator<int> i(children);
+            const QList<int> ancestors = treeHub->getAllAncestors(projectId, treeItemId);
 
-        while (i.hasNext()) {
-            int childId                   = i.next();
-            QHash<QString, int> childHash = projectHash.value(childId, QHash<QString, int>());
+            for (int ancestorId : ancestors) {
+                countsWithChildren[ancestorId] += count;
+            }
+        }
 
-            if (childHash.value("isTrashed", 0)) {
-                i.remove();
+        // write only what moved
+        for (auto it = countsWithChildren.constBegin(); it != countsWithChildren.constEnd(); ++it) {
+            if (stats.countsWithChildren[type].value(it.key(), -1) != it.value()) {
+                markToPersist(stats.countsWithChildrenToPersist[type], it.key(), false);
             }
         }
 
-        int totalChildrenCount = 0;
+        for (auto it = stats.countsWithChildren[type].constBegin(); it != stats.countsWithChildren[type].constEnd();
+             ++it) {
+            if (!countsWithChildren.contains(it.key())) {
+                countsWithChildren.insert(it.key(), 0);
+                markToPersist(stats.countsWithChildrenToPersist[type], it.key(), false);
+            }
+        }
 
-        for (int childId : qAsConst(children)) {
-            QHash<QString, int> childHash = projectHash.value(childId, QHash<QString, int>());
+        stats.countsWithChildren[type] = countsWithChildren;
+    }
 
-            totalChildrenCount += childHash.value("characterCount", 0);
+    if (!m_persistTimer->isActive()) {
+        m_persistTimer->start();
+    }
+}
+
+// ---------------------------------------------------------------------------------
+
+void SKRStatHub::setTreeItemTrashed(int projectId, int treeItemId, bool isTrashed)
+{
+    ProjectStats& stats = this->projectStats(projectId);
+
+    // never counted, nothing to move
+    if (!stats.trashedStates.contains(treeItemId)) {
+        return;
+    }
+
+    if (stats.trashedStates.value(treeItemId) == isTrashed) {
+        return;
+    }
+
+    stats.trashedStates.insert(treeItemId, isTrashed);
+
+    for (SKRStatHub::StatType type : statTypes) {
+        int difference = stats.counts[type].value(treeItemId, 0) * (isTrashed ? -1 : 1);
+
+        if (difference != 0) {
+            stats.totalCounts[type] += difference;
+            this->addToAncestors(type, stats, projectId, treeItemId, difference, true);
         }
 
-        // add ancestor count
-        QHash<QString, int> ancestorHash = projectHash.value(ancestorId, QHash<QString, int>());
-        totalChildrenCount += ancestorHash.value("characterCount", 0);
+        emit statsChanged(type, projectId, stats.totalCounts[type]);
+    }
+
+    if (!m_persistTimer->isActive()) {
+        m_persistTimer->start();
+    }
+}
 
-        // set property
+// ---------------------------------------------------------------------------------
 
-        propertyHub->setProperty(projectId, ancestorId, "char_count_with_children",
-                                 QString::number(totalChildrenCount), true, triggerProjectModifiedSignal);
+void SKRStatHub::removeTreeItemFromStat(int projectId, int treeItemId)
+{
+    if (!m_statsByProjectHash.contains(projectId)) {
+        return;
+    }
+
+    ProjectStats& stats = m_statsByProjectHash[projectId];
+    bool isTrashed      = stats.trashedStates.value(treeItemId, true);
+
+    for (SKRStatHub::StatType type : statTypes) {
+        if (!isTrashed) {
+            stats.totalCounts[type] -= stats.counts[type].value(treeItemId, 0);
+        }
+
+        // delete ref to treeItemId
+        stats.counts[type].remove(treeItemId);
+        stats.countsWithChildren[type].remove(treeItemId);
+        stats.countsToPersist[type].remove(treeItemId);
+        stats.countsWithChildrenToPersist[type].remove(treeItemId);
+    }
+    stats.trashedStates.remove(treeItemId);
+    stats.fingerprints.remove(treeItemId);
+    stats.fingerprintsToPersist.remove(treeItemId);
+
+    // the item is already out of the tree, its ancestors can't be found anymore
+    stats.isStructureOutdated = true;
+
+    for (SKRStatHub::StatType type : statTypes) {
+        emit statsChanged(type, projectId, stats.totalCounts[type]);
+    }
+
+    if (!m_persistTimer->isActive()) {
+        m_persistTimer->start();
     }
 }
 
 // ---------------------------------------------------------------------------------
 
-void SKRStatHub::setTreeItemTrashed(int projectId, int treeItemId, bool isTrashed)
+void SKRStatHub::setStructureOutdated(int projectId)
 {
-    Q_UNUSED(isTrashed)
-    updateCharacterStats(projectId, treeItemId);
-    updateWordStats(projectId, treeItemId);
+    if (m_statsByProjectHash.contains(projectId)) {
+        m_statsByProjectHash[projectId].isStructureOutdated = true;
+
+        if (!m_persistTimer->isActive()) {
+            m_persistTimer->start();
+        }
+    }
 }
 
 // ---------------------------------------------------------------------------------
 
-void SKRStatHub::removeTreeItemFromStat(int projectId, int treeItemId)
+void SKRStatHub::clearProjectStats(int projectId)
+{
+    m_statsByProjectHash.remove(projectId);
+}
+
+// ---------------------------------------------------------------------------------
+
+///
+/// \brief SKRStatHub::persistStats
+/// \param projectId
+/// write the waiting counts to the properties
+void SKRStatHub::persistStats(int projectId)
 {
-    // if not done, trash it, needed for cleaner calculation
-    setTreeItemTrashed(projectId, treeItemId, true);
+    if (!m_statsByProjectHash.contains(projectId)) {
+        return;
+    }
+
+    ProjectStats& stats = this->projectStats(projectId);
+
+    // copies, writing properties emits signals
+    QHash<int, bool> countsToPersist[2];
+    QHash<int, bool> countsWithChildrenToPersist[2];
+    QHash<int, int>  counts[2];
+    QHash<int, int>  countsWithChildren[2];
+
+    QSet<int> fingerprintsToPersist;
+    QHash<int, QString> fingerprints = stats.fingerprints;
+
+    for (SKRStatHub::StatType type : statTypes) {
+        countsToPersist[type].swap(stats.countsToPersist[type]);
+        countsWithChildrenToPersist[type].swap(stats.countsWithChildrenToPersist[type]);
+        counts[type]             = stats.counts[type];
+        countsWithChildren[type] = stats.countsWithChildren[type];
+    }
+    fingerprintsToPersist.swap(stats.fingerprintsToPersist);
+
+    SKRPropertyHub *propertyHub = plmdata->treePropertyHub();
+
+    for (SKRStatHub::StatType type : statTypes) {
+        for (auto it = countsToPersist[type].constBegin(); it != countsToPersist[type].constEnd(); ++it) {
+            propertyHub->setProperty(projectId,
+                                     it.key(),
+                                     countPropertyNames[type],
+                                     QString::number(counts[type].value(it.key(), 0)),
+                                     true,
+                                     it.value());
+        }
+
+        for (auto it = countsWithChildrenToPersist[type].constBegin();
+             it != countsWithChildrenToPersist[type].constEnd(); ++it) {
+            propertyHub->setProperty(projectId,
+                                     it.key(),
+                                     countWithChildrenPropertyNames[type],
+                                     QString::number(countsWithChildren[type].value(it.key(), 0)),
+                                     true,
+                                     it.value());
+        }
+    }
 
-    // delete ref to treeItemId
-    QHash<int, QHash<QString, int> > projectHash = m_treeItemHashByProjectHash.value(projectId);
+    for (int treeItemId : qAsConst(fingerprintsToPersist)) {
+        propertyHub->setProperty(projectId,
+                                 treeItemId,
+                                 fingerprintPropertyName,
+                                 fingerprints.value(treeItemId),
+                                 true,
+                                 false);
+    }
+}
 
-    projectHash.remove(treeItemId);
-    m_treeItemHashByProjectHash.insert(projectId, projectHash);
+// ---------------------------------------------------------------------------------
+
+void SKRStatHub::persistAllStats()
+{
+    const QList<int> projectIds = m_statsByProjectHash.keys();
+
+    for (int projectId : projectIds) {
+        this->persistStats(projectId);
+    }
 }
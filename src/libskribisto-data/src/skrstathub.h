@@ -2,6 +2,10 @@
 #define SKRSTATHUB_H
 
 #include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QVariantMap>
 #include "skr.h"
 #include "skribisto_data_global.h"
 
@@ -20,9 +24,16 @@ public:
 
     Q_INVOKABLE int getTreeItemTotalCount(SKRStatHub::StatType type,
                                           int                  project);
+    int             getTreeItemCountWithChildren(SKRStatHub::StatType type,
+                                                 int                  projectId,
+                                                 int                  treeItemId);
+    QHash<int, QString>     getFingerprints(int projectId) const;
+    Q_INVOKABLE QVariantMap getCountingStats(int projectId) const;
 
 public slots:
 
+    void loadStats(int projectId);
+
     void updateWordStats(int  projectId,
                          int  treeItemId,
                          int  wordCount                    = -1,
@@ -31,6 +42,14 @@ public slots:
                               int  treeItemId,
                               int  characterCount               = -1,
                               bool triggerProjectModifiedSignal = true);
+    void updateFingerprint(int            projectId,
+                           int            treeItemId,
+                           const QString& fingerprint);
+    void recordCountingRun(int    projectId,
+                           int    countedCount,
+                           int    skippedCount,
+                           qint64 elapsedTime);
+    void persistStats(int projectId);
 
 private slots:
 
@@ -39,6 +58,9 @@ private slots:
                             bool isTrashed);
     void removeTreeItemFromStat(int projectId,
                                 int treeItemId);
+    void setStructureOutdated(int projectId);
+    void clearProjectStats(int projectId);
+    void persistAllStats();
 
 signals:
 
@@ -48,7 +70,56 @@ signals:
 
 private:
 
-    QHash<int, QHash<int, QHash<QString, int> > >m_treeItemHashByProjectHash;
+    // what the last opening of the project cost
+    struct CountingStats {
+        int    storedCount  = 0;
+        int    countedCount = 0;
+        int    skippedCount = 0;
+        qint64 loadingTime  = 0;
+        qint64 countingTime = 0;
+    };
+
+    // one per project. Counts are indexed by StatType. The counts with children
+    // are kept up to date by propagating differences along the ancestors only.
+    struct ProjectStats {
+        ProjectStats() : totalCounts{0, 0}, isStructureOutdated(false) {}
+
+        QHash<int, int>  counts[2];
+        QHash<int, int>  countsWithChildren[2];
+        QHash<int, bool> trashedStates;
+        int              totalCounts[2];
+        bool             isStructureOutdated;
+
+        // tree item id -> triggerProjectModifiedSignal, waiting to be written
+        QHash<int, bool> countsToPersist[2];
+        QHash<int, bool> countsWithChildrenToPersist[2];
+
+        // fingerprints of the counted contents, see SKRWordMeter::fingerprint
+        QHash<int, QString> fingerprints;
+        QSet<int>           fingerprintsToPersist;
+        CountingStats       countingStats;
+    };
+
+    ProjectStats& projectStats(int projectId);
+    void          recomputeCountsWithChildren(ProjectStats& stats,
+                                              int           projectId);
+    void          updateStats(SKRStatHub::StatType type,
+                              int                  projectId,
+                              int                  treeItemId,
+                              int                  count,
+                              bool                 triggerProjectModifiedSignal);
+    void          addToAncestors(SKRStatHub::StatType type,
+                                 ProjectStats       & stats,
+                                 int                  projectId,
+                                 int                  treeItemId,
+                                 int                  difference,
+                                 bool                 triggerProjectModifiedSignal);
+    bool          getTrashed(ProjectStats& stats,
+                             int           projectId,
+                             int           treeItemId);
+
+    QHash<int, ProjectStats>m_statsByProjectHash;
+    QTimer *m_persistTimer;
 };
 
 #endif // SKRSTATHUB_H
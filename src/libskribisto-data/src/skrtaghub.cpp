@@ -451,6 +451,44 @@ QList<int>SKRTagHub::getTagsFromItemId(int projectId,
 
 // --------------------------------------------------------------------------------
 
+///
+/// \brief SKRTagHub::getTagsForAllItems
+/// \param projectId
+/// \return tree item id -> tag ids, only the tagged items are present
+QHash<int, QList<int> >SKRTagHub::getTagsForAllItems(int projectId) const
+{
+    SKRResult result(this);
+
+    QHash<int, QList<int> > hash;
+    QHash<int, QVariant>    treeCodes;
+    QHash<int, QVariant>    tagCodes;
+
+    PLMSqlQueries queries(projectId, "tbl_tag_relationship");
+
+    result = queries.getValueByIds("l_tree_code", treeCodes);
+    IFOKDO(result, queries.getValueByIds("l_tag_code", tagCodes));
+
+    IFOK(result) {
+        // both are keyed by relationship id
+        QHash<int, QVariant>::const_iterator i = treeCodes.constBegin();
+
+        while (i != treeCodes.constEnd()) {
+            const QVariant tagCode = tagCodes.value(i.key());
+
+            if (!i.value().isNull() && !tagCode.isNull()) {
+                hash[i.value().toInt()].append(tagCode.toInt());
+            }
+            ++i;
+        }
+    }
+    IFKO(result) {
+        emit errorSent(result);
+    }
+    return hash;
+}
+
+// --------------------------------------------------------------------------------
+
 
 SKRResult SKRTagHub::setTagRelationship(int projectId,
                                         int treeItemId,
@@ -86,6 +86,7 @@ public:
                                             int tagId) const;
     Q_INVOKABLE QList<int>getTagsFromItemId(int projectId,
                                             int treeItemId) const;
+    QHash<int, QList<int> >getTagsForAllItems(int projectId) const;
     Q_INVOKABLE SKRResult setTagRelationship(int projectId,
                                              int treeItemId,
                                              int tagId);
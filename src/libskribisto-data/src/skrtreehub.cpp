@@ -19,13 +19,29 @@
 *  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
 ***************************************************************************/
 #include "skrtreehub.h"
+#include "skrcontentjournal.h"
+#include "plmdata.h"
 #include "tasks/plmsqlqueries.h"
 #include "tools.h"
 #include "tasks/plmprojectmanager.h"
 
-SKRTreeHub::SKRTreeHub(QObject *parent) : QObject(parent), m_tableName("tbl_tree"), m_last_added_id(-1)
+SKRTreeHub::SKRTreeHub(QObject *parent) : QObject(parent), m_tableName("tbl_tree"), m_last_added_id(-1),
+    m_contentJournal(new SKRContentJournal(this))
 {
     connect(this, &SKRTreeHub::errorSent, this, &SKRTreeHub::setError, Qt::DirectConnection);
+
+    connect(m_contentJournal, &SKRContentJournal::errorSent, this, &SKRTreeHub::errorSent);
+
+    // the journal lives in the temporary schema, it must be in tbl_tree before the file is written
+    connect(plmdata->projectHub(), &PLMProjectHub::projectToBeSaved, this, [this](int projectId) {
+        SKRResult result = this->compactContentJournal(projectId);
+
+        IFKO(result) {
+            emit errorSent(result);
+        }
+    }, Qt::DirectConnection);
+    connect(plmdata->projectHub(), &PLMProjectHub::projectClosed,
+            m_contentJournal, &SKRContentJournal::forgetProject);
 }
 
 // ----------------------------------------------------------------------------------------
@@ -70,6 +86,92 @@ QHash<int, int>SKRTreeHub::getAllIndents(int projectId) const
 
 // ----------------------------------------------------------------------------------------
 
+QHash<int, bool>SKRTreeHub::getAllTrashedStates(int projectId) const
+{
+    SKRResult result(this);
+
+    QHash<int, bool> hash;
+    QHash<int, QVariant> out;
+    PLMSqlQueries queries(projectId, m_tableName);
+
+    result = queries.getValueByIds("b_trashed", out, "", QVariant(), true);
+    IFOK(result) {
+        hash = HashIntQVariantConverter::convertToIntBool(out);
+    }
+    IFKO(result) {
+        emit errorSent(result);
+    }
+    return hash;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeHub::getAllChildStates
+/// \param projectId
+/// \return
+/// SKRTreeTopology::ChildState flags of every item, -1 being the invisible root.
+/// Computed in one pass when the topology is built, so models can read them
+/// in bulk instead of querying each row.
+QHash<int, int>SKRTreeHub::getAllChildStates(int projectId) const
+{
+    return this->treeTopology(projectId).allChildStates();
+}
+
+// ----------------------------------------------------------------------------------------
+
+QHash<int, QString>SKRTreeHub::getAllTypes(int projectId) const
+{
+    SKRResult result(this);
+
+    QHash<int, QString> hash;
+    QHash<int, QVariant> out;
+    PLMSqlQueries queries(projectId, m_tableName);
+
+    result = queries.getValueByIds("t_type", out, "", QVariant(), true);
+    IFOK(result) {
+        hash = HashIntQVariantConverter::convertToIntQString(out);
+    }
+    IFKO(result) {
+        emit errorSent(result);
+    }
+    return hash;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeHub::getAllPrimaryContents
+/// \param projectId
+/// \return
+/// One query for every content, the journaled contents not yet compacted
+/// replacing the stored ones
+QHash<int, QString>SKRTreeHub::getAllPrimaryContents(int projectId) const
+{
+    SKRResult result(this);
+
+    QHash<int, QString> hash;
+    QHash<int, QVariant> out;
+    PLMSqlQueries queries(projectId, m_tableName);
+
+    result = queries.getValueByIds("m_primary_content", out, "", QVariant(), true);
+    IFOK(result) {
+        hash = HashIntQVariantConverter::convertToIntQString(out);
+
+        for (auto it = hash.begin(); it != hash.end(); ++it) {
+            if (m_contentJournal->hasPendingContent(projectId, it.key(), "m_primary_content")) {
+                it.value() = m_contentJournal->pendingContent(projectId, it.key(), "m_primary_content");
+            }
+        }
+    }
+    IFKO(result) {
+        emit errorSent(result);
+    }
+    return hash;
+}
+
+// ----------------------------------------------------------------------------------------
+
 ///
 /// \brief SKRTreeHub::getAllIds
 /// \param projectId
@@ -225,9 +327,26 @@ QString SKRTreeHub::getType(int projectId, int treeItemId) const
 
 // ----------------------------------------------------------------------------------------
 
+///
+/// \brief SKRTreeHub::setPrimaryContent
+/// \param projectId
+/// \param treeItemId
+/// \param newContent
+/// \return
+/// Used while typing: only the edited range is journaled, tbl_tree is written
+/// once the journal is compacted
 SKRResult SKRTreeHub::setPrimaryContent(int projectId, int treeItemId, const QString& newContent)
 {
-    return this->setPrimaryContent(projectId, treeItemId, newContent, true, true);
+    SKRResult result = m_contentJournal->record(projectId, treeItemId, "m_primary_content", newContent);
+
+    IFOK(result) {
+        emit primaryContentChanged(projectId, treeItemId, newContent);
+        emit projectModified(projectId);
+    }
+    IFKO(result) {
+        emit errorSent(result);
+    }
+    return result;
 }
 
 // ----------------------------------------------------------------------------------------
@@ -238,7 +357,9 @@ SKRResult SKRTreeHub::setPrimaryContent(int            projectId,
                                         bool           setCurrentdate,
                                         bool           commit)
 {
-    SKRResult result = set(projectId, treeItemId, "m_primary_content", newContent, setCurrentdate, commit);
+    SKRResult result = m_contentJournal->discard(projectId, treeItemId, "m_primary_content");
+
+    IFOKDO(result, set(projectId, treeItemId, "m_primary_content", newContent, setCurrentdate, commit));
 
     IFOK(result) {
         emit primaryContentChanged(projectId, treeItemId, newContent);
@@ -263,7 +384,16 @@ QString SKRTreeHub::getPrimaryContent(int projectId, int treeItemId) const
 
 SKRResult SKRTreeHub::setSecondaryContent(int projectId, int treeItemId, const QString& newContent)
 {
-    return this->setSecondaryContent(projectId, treeItemId, newContent, true, true);
+    SKRResult result = m_contentJournal->record(projectId, treeItemId, "m_secondary_content", newContent);
+
+    IFOK(result) {
+        emit secondaryContentChanged(projectId, treeItemId, newContent);
+        emit projectModified(projectId);
+    }
+    IFKO(result) {
+        emit errorSent(result);
+    }
+    return result;
 }
 
 // ----------------------------------------------------------------------------------------
@@ -274,7 +404,9 @@ SKRResult SKRTreeHub::setSecondaryContent(int            projectId,
                                           bool           setCurrentdate,
                                           bool           commit)
 {
-    SKRResult result = set(projectId, treeItemId, "m_secondary_content", newContent, setCurrentdate, commit);
+    SKRResult result = m_contentJournal->discard(projectId, treeItemId, "m_secondary_content");
+
+    IFOKDO(result, set(projectId, treeItemId, "m_secondary_content", newContent, setCurrentdate, commit));
 
     IFOK(result) {
         emit secondaryContentChanged(projectId, treeItemId, newContent);
@@ -297,6 +429,42 @@ QString SKRTreeHub::getSecondaryContent(int projectId, int treeItemId) const
 
 // ----------------------------------------------------------------------------------------
 
+///
+/// \brief SKRTreeHub::compactContentJournal
+/// \param projectId
+/// \return
+/// Writes the journaled contents into tbl_tree, for the readers going straight
+/// to the database
+SKRResult SKRTreeHub::compactContentJournal(int projectId)
+{
+    return m_contentJournal->compact(projectId);
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeHub::getContentJournalStats
+/// \param projectId
+/// \return characters asked to be written as whole contents, characters really
+/// journaled and compacted, and their ratio
+QVariantMap SKRTreeHub::getContentJournalStats(int projectId) const
+{
+    SKRContentJournal::Stats stats = m_contentJournal->stats(projectId);
+    QVariantMap map;
+
+    map.insert("requestedCharacters", stats.requestedCharacters);
+    map.insert("journaledCharacters", stats.journaledCharacters);
+    map.insert("compactedCharacters", stats.compactedCharacters);
+    map.insert("deltaCount",          stats.deltaCount);
+    map.insert("compactionCount",     stats.compactionCount);
+    map.insert("writeAmplification",  stats.requestedCharacters == 0 ? 0.0 :
+               double(stats.journaledCharacters + stats.compactedCharacters) / stats.requestedCharacters);
+
+    return map;
+}
+
+// ----------------------------------------------------------------------------------------
+
 SKRResult SKRTreeHub::setTrashedWithChildren(int projectId, int treeItemId, bool newTrashedState)
 {
     SKRResult result(this);
@@ -422,73 +590,14 @@ QDateTime SKRTreeHub::getUpdateDate(int projectId, int treeItemId) const
 
 bool SKRTreeHub::hasChildren(int projectId, int treeItemId, bool trashedAreIncluded, bool notTrashedAreIncluded) const
 {
-    SKRResult result(this);
-    PLMSqlQueries queries(projectId, m_tableName);
+    int childState = this->treeTopology(projectId).childState(treeItemId);
 
-    // if last of id list:
-    QList<int> idList;
-
-    IFOKDO(result, queries.getSortedIds(idList));
-
-    if (idList.isEmpty()) { // project item with nothing else
-        return false;
+    if (trashedAreIncluded && (childState & SKRTreeTopology::HasTrashedChild)) {
+        return true;
     }
 
-    if (treeItemId == idList.last()) {
-        return false;
-    }
-
-    int indent = getIndent(projectId, treeItemId);
-
-    int possibleFirstChildId;
-
-    if (treeItemId == -1) {                  // project item
-        possibleFirstChildId = idList.at(0); // first real treeItem in table
-    }
-    else {
-        possibleFirstChildId = idList.at(idList.indexOf(treeItemId) + 1);
-    }
-
-
-    int possibleFirstChildIndent = getIndent(projectId, possibleFirstChildId);
-
-    // verify indent of child
-    if (indent == possibleFirstChildIndent - 1) {
-        // verify if at least one child is not trashed
-        bool haveOneNotTrashedChild = false;
-        bool haveOneTrashedChild    = false;
-        int  firstChildIndex        = idList.indexOf(possibleFirstChildId);
-
-        for (int i = firstChildIndex; i < idList.count(); i++) {
-            int childId = idList.at(i);
-            int indent  = getIndent(projectId, childId);
-
-            if (indent < possibleFirstChildIndent) {
-                break;
-            }
-
-            if (indent == possibleFirstChildIndent) {
-                if (getTrashed(projectId, childId) == false) {
-                    haveOneNotTrashedChild = true;
-                }
-                else {
-                    haveOneTrashedChild = true;
-                }
-            }
-        }
-
-        if (haveOneTrashedChild && trashedAreIncluded) {
-            return true;
-        }
-
-        if (haveOneNotTrashedChild && notTrashedAreIncluded) {
-            return true;
-        }
-        return false;
-    }
-
-    IFKO(result) {
-        emit errorSent(result);
+    if (notTrashedAreIncluded && (childState & SKRTreeTopology::HasNotTrashedChild)) {
+        return true;
     }
 
     return false;
@@ -545,6 +654,25 @@ SKRResult SKRTreeHub::set(int             projectId,
         if (commit) {
             queries.commit();
         }
+
+        // keep the topology in line with the tree structure
+        if ((fieldName == "l_indent") && commit) {
+            SKRTreeTopology& topology = m_treeTopologyByProjectHash[projectId];
+
+            if (!topology.isValid() || !topology.setIndent(treeItemId, value.toInt())) {
+                this->invalidateTreeTopology(projectId);
+            }
+        }
+        else if ((fieldName == "b_trashed") && commit) {
+            SKRTreeTopology& topology = m_treeTopologyByProjectHash[projectId];
+
+            if (!topology.isValid() || !topology.setTrashed(treeItemId, value.toBool())) {
+                this->invalidateTreeTopology(projectId);
+            }
+        }
+        else if ((fieldName == "l_indent") || (fieldName == "l_sort_order") || (fieldName == "b_trashed")) {
+            this->invalidateTreeTopology(projectId);
+        }
     }
     IFKO(result) {
         emit errorSent(result);
@@ -556,6 +684,10 @@ SKRResult SKRTreeHub::set(int             projectId,
 
 QVariant SKRTreeHub::get(int projectId, int treeItemId, const QString& fieldName) const
 {
+    if (m_contentJournal->hasPendingContent(projectId, treeItemId, fieldName)) {
+        return m_contentJournal->pendingContent(projectId, treeItemId, fieldName);
+    }
+
     SKRResult result(this);
     QVariant  var;
     QVariant  value;
@@ -599,6 +731,7 @@ SKRResult SKRTreeHub::addTreeItem(const QHash<QString, QVariant>& values, int pr
         emit errorSent(result);
     }
     IFOK(result) {
+        this->invalidateTreeTopology(projectId);
         m_last_added_id = newId;
         result.addData("treeItemId", newId);
         emit treeItemAdded(projectId, newId);
@@ -753,6 +886,119 @@ SKRResult SKRTreeHub::addChildTreeItem(int projectId, int targetId, const QStrin
 
 // ----------------------------------------------------------------------------------------
 
+///
+/// \brief SKRTreeHub::addTreeItems
+/// \param projectId
+/// \param parentId
+/// \param valuesList tbl_tree values of the new items, in tree order.
+/// "l_indent" is relative to the parent: 1 for its direct children.
+/// \return "treeItemIdList", the new ids in the same order
+/// Adds a whole subtree after the last child of parentId. The room is made with
+/// a single UPDATE, the sort orders are precomputed and all is written in one
+/// transaction. treeItemsAdded() is emitted once instead of treeItemAdded() for
+/// each item.
+SKRResult SKRTreeHub::addTreeItems(int projectId, int parentId, const QList<QHash<QString, QVariant> >& valuesList)
+{
+    SKRResult result(this);
+
+    // for invalid parent ("root")
+    if (parentId == -2) {
+        result = SKRResult(SKRResult::Critical, this, "invalid_root_parent");
+        return result;
+    }
+
+    if (valuesList.isEmpty()) {
+        result.addData("treeItemIdList", QVariant::fromValue(QList<int>()));
+        return result;
+    }
+
+    PLMSqlQueries queries(projectId, m_tableName);
+
+    int parentIndent    = 0;
+    int parentSortOrder = 0;
+    QHash<int, QVariant> nextSortOrderHash;
+
+    // for project item as parent, the items go at the bottom
+    if (parentId != 0) {
+        parentIndent    = getIndent(projectId, parentId);
+        parentSortOrder = getSortOrder(projectId, parentId);
+
+        // find next node with the same indentation or lower
+        QHash<QString, QVariant> where;
+
+        where.insert("l_indent <=",    parentIndent);
+        where.insert("l_sort_order >", parentSortOrder);
+        result = queries.getValueByIdsWhere("l_sort_order", nextSortOrderHash, where, true);
+    }
+
+    int  firstSortOrder = 0;
+    bool hasNodeAfter   = !nextSortOrderHash.isEmpty();
+
+    if (hasNodeAfter) {
+        firstSortOrder = nextSortOrderHash.constBegin().value().toInt();
+
+        for (const QVariant& sortOrder : qAsConst(nextSortOrderHash)) {
+            firstSortOrder = qMin(sortOrder.toInt(), firstSortOrder);
+        }
+    }
+    else {
+        QHash<int, QVariant> sortOrderHash;
+        IFOKDO(result, queries.getValueByIds("l_sort_order", sortOrderHash, QString(), QVariant(), true));
+
+        for (const QVariant& sortOrder : qAsConst(sortOrderHash)) {
+            firstSortOrder = qMax(sortOrder.toInt() + 1, firstSortOrder);
+        }
+    }
+
+    QList<int> newIdList;
+
+    queries.beginTransaction();
+
+    // make room
+    if (hasNodeAfter) {
+        IFOKDO(result, queries.injectDirectSql(QString("UPDATE %1 SET l_sort_order = l_sort_order + %2"
+                                                       " WHERE l_sort_order >= %3")
+                                               .arg(m_tableName)
+                                               .arg(valuesList.count())
+                                               .arg(firstSortOrder)));
+    }
+
+    for (int i = 0; i < valuesList.count(); i++) {
+        QHash<QString, QVariant> values = valuesList.at(i);
+
+        values.insert("l_sort_order", firstSortOrder + i);
+        values.insert("l_indent",     parentIndent + values.value("l_indent", 1).toInt());
+
+        int newId = -1;
+        IFOKDO(result, queries.add(values, newId));
+        IFKO(result) {
+            break;
+        }
+        newIdList.append(newId);
+    }
+
+    IFOKDO(result, queries.renumberSortOrder());
+    IFKO(result) {
+        queries.rollback();
+    }
+    IFOK(result) {
+        queries.commit();
+    }
+    IFKO(result) {
+        emit errorSent(result);
+    }
+    IFOK(result) {
+        this->invalidateTreeTopology(projectId);
+        m_last_added_id = newIdList.last();
+        result.addData("treeItemIdList", QVariant::fromValue(newIdList));
+        emit treeItemsAdded(projectId, newIdList);
+        emit projectModified(projectId);
+    }
+    return result;
+}
+
+// ----------------------------------------------------------------------------------------
+
 SKRResult SKRTreeHub::removeTreeItem(int projectId, int targetId)
 {
     PLMSqlQueries queries(projectId, m_tableName);
@@ -774,6 +1020,12 @@ SKRResult SKRTreeHub::removeTreeItem(int projectId, int targetId)
         emit errorSent(result);
     }
     IFOK(result) {
+        SKRTreeTopology& topology = m_treeTopologyByProjectHash[projectId];
+
+        if (!topology.isValid() || !topology.remove(targetId)) {
+            this->invalidateTreeTopology(projectId);
+        }
+
         emit treeItemRemoved(projectId, targetId);
         emit projectModified(projectId);
     }
@@ -824,6 +1076,7 @@ SKRResult SKRTreeHub::moveTreeItem(int sourceProjectId, int sourceTreeItemId, in
 
     IFKO(result) {
         queries.rollback();
+        this->invalidateTreeTopology(sourceProjectId);
         emit errorSent(result);
     }
     IFOK(result) {
@@ -1003,38 +1256,7 @@ SKRResult SKRTreeHub::moveTreeItemAsChildOf(int projectId, int noteId, int targe
 
 int SKRTreeHub::getParentId(int projectId, int treeItemId)
 {
-    int parentId = -2;
-
-    // get indents
-    QHash<int, int> indentList = getAllIndents(projectId);
-    QList<int> sortedIdList    = getAllIds(projectId);
-
-
-    // determine direct ancestor
-
-    int indent = indentList.value(treeItemId);
-
-    if (indent == 0) {
-        return -1;
-    }
-
-    for (int i = sortedIdList.indexOf(treeItemId); i >= 0; i--) {
-        int id = sortedIdList.at(i);
-
-        //        if (id == treeItemId) {
-        //            continue;
-        //        }
-
-        int idIndent = indentList.value(id);
-
-        if (idIndent == indent - 1) {
-            parentId = id;
-            break;
-        }
-    }
-
-
-    return parentId;
+    return this->treeTopology(projectId).parentId(treeItemId);
 }
 
 // ----------------------------------------------------------------------------------------
@@ -1130,157 +1352,21 @@ int SKRTreeHub::getValidSortOrderAfterTree(int projectId, int treeItemId) const
 
 QList<int>SKRTreeHub::getAllChildren(int projectId, int treeItemId)
 {
-    QList<int> childrenList;
-
-    // get indents
-    QHash<int, int> indentList = getAllIndents(projectId);
-    QList<int> sortedIdList    = getAllIds(projectId);
-
-
-    // determine children
-
-    int  parentIndent = indentList.value(treeItemId);
-    bool parentPassed = false;
-
-    for (int id : qAsConst(sortedIdList)) {
-        if (id == treeItemId) {
-            parentPassed = true;
-            continue;
-        }
-
-        if (parentPassed) {
-            int idIndent = indentList.value(id);
-
-            if (idIndent > parentIndent) {
-                childrenList.append(id);
-            }
-
-            if (idIndent <= parentIndent) {
-                break;
-            }
-        }
-    }
-
-    return childrenList;
+    return this->treeTopology(projectId).allChildren(treeItemId);
 }
 
 // ----------------------------------------------------------------------------------------
 
 QList<int>SKRTreeHub::getAllAncestors(int projectId, int treeItemId)
 {
-    QList<int> ancestorsList;
-
-    // get indents
-    QHash<int, int> indentList = getAllIndents(projectId);
-    QList<int> sortedIdList    = getAllIds(projectId);
-
-
-    // determine ancestors
-
-    int indent = indentList.value(treeItemId);
-
-
-    for (int i = sortedIdList.indexOf(treeItemId); i >= 0; i--) {
-        int id = sortedIdList.at(i);
-
-        //        if (id == treeItemId) {
-        //            continue;
-        //        }
-
-        int idIndent = indentList.value(id);
-
-        if (idIndent == indent - 1) {
-            if (indent == -1) {
-                break;
-            }
-
-            ancestorsList.append(id);
-
-            indent = idIndent;
-        }
-    }
-
-    return ancestorsList;
+    return this->treeTopology(projectId).allAncestors(treeItemId);
 }
 
 // ----------------------------------------------------------------------------------------
 
 QList<int>SKRTreeHub::getAllSiblings(int projectId, int treeItemId)
 {
-    QList<int> siblingsList;
-
-    // get indents
-    QHash<int, int> indentList = getAllIndents(projectId);
-    QList<int> sortedIdList    = getAllIds(projectId);
-    int treeItemSortedIdIndex  = sortedIdList.indexOf(treeItemId);
-
-
-    // determine siblings
-
-    int indent = indentList.value(treeItemId);
-
-    // min sibling index
-    int minSiblingIndex = treeItemSortedIdIndex;
-
-    for (int i = treeItemSortedIdIndex; i >= 0; i--) {
-        int id = sortedIdList.at(i);
-
-        //        if (id == treeItemId) {
-        //            continue;
-        //        }
-
-        int idIndent = indentList.value(id);
-
-        if ((idIndent == indent - 1) || (indent == -1)) {
-            break;
-        }
-        minSiblingIndex = i;
-    }
-
-    // min sibling index
-    int maxSiblingIndex = treeItemSortedIdIndex;
-
-    for (int i = treeItemSortedIdIndex; i < sortedIdList.count(); i++) {
-        int id = sortedIdList.at(i);
-
-        //        if (id == treeItemId) {
-        //            continue;
-        //        }
-
-        int idIndent = indentList.value(id);
-
-        if ((idIndent == indent - 1) || (indent == -1)) {
-            break;
-        }
-        maxSiblingIndex = i;
-    }
-
-    // alone, so no siblings
-    if ((minSiblingIndex == treeItemSortedIdIndex) &&
-        (maxSiblingIndex == treeItemSortedIdIndex)) {
-        return siblingsList;
-    }
-
-    // same level
-
-    for (int i = minSiblingIndex; i <= maxSiblingIndex; i++) {
-        int id = sortedIdList.at(i);
-
-        //        if (id == treeItemId) {
-        //            continue;
-        //        }
-
-        int idIndent = indentList.value(id);
-
-        if (idIndent == indent) {
-            siblingsList.append(id);
-        }
-    }
-
-    siblingsList.removeAll(treeItemId);
-
-
-    return siblingsList;
+    return this->treeTopology(projectId).allSiblings(treeItemId);
 }
 
 // ----------------------------------------------------------------------------------------
@@ -1451,3 +1537,32 @@ void SKRTreeHub::setError(const SKRResult& result)
 }
 
 // ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeHub::treeTopology
+/// \param projectId
+/// \return
+/// Built from getAllIds, getAllIndents and getAllTrashedStates only when missing
+/// or invalidated. Every hub method changing the sort order, the indent, the
+/// trashed state or the rows keeps it up-to-date or invalidates it.
+const SKRTreeTopology &SKRTreeHub::treeTopology(int projectId) const
+{
+    SKRTreeTopology& topology = m_treeTopologyByProjectHash[projectId];
+
+    if (!topology.isValid()) {
+        topology.build(this->getAllIds(projectId),
+                       this->getAllIndents(projectId),
+                       this->getAllTrashedStates(projectId));
+    }
+
+    return topology;
+}
+
+// ----------------------------------------------------------------------------------------
+
+void SKRTreeHub::invalidateTreeTopology(int projectId)
+{
+    m_treeTopologyByProjectHash.remove(projectId);
+}
+
+// ----------------------------------------------------------------------------------------
@@ -31,6 +31,9 @@
 #include "skribisto_data_global.h"
 #include "skrresult.h"
 #include "skrpropertyhub.h"
+#include "skrtreetopology.h"
+
+class SKRContentJournal;
 
 class EXPORT SKRTreeHub : public QObject {
     Q_OBJECT
@@ -41,6 +44,10 @@ public:
     QHash<int, int>       getAllSortOrders(int projectId) const;
     QHash<int, int>       getAllIndents(int projectId) const;
     QList<int>            getAllIds(int projectId) const;
+    QHash<int, bool>      getAllTrashedStates(int projectId) const;
+    QHash<int, int>       getAllChildStates(int projectId) const;
+    QHash<int, QString>   getAllTypes(int projectId) const;
+    QHash<int, QString>   getAllPrimaryContents(int projectId) const;
 
     Q_INVOKABLE SKRResult setTitle(int            projectId,
                                    int            treeItemId,
@@ -98,6 +105,9 @@ public:
     Q_INVOKABLE QString   getSecondaryContent(int projectId,
                                               int treeItemId) const;
 
+    SKRResult               compactContentJournal(int projectId);
+    Q_INVOKABLE QVariantMap getContentJournalStats(int projectId) const;
+
     Q_INVOKABLE SKRResult setTrashedWithChildren(int  projectId,
                                                  int  treeItemId,
                                                  bool newTrashedState);
@@ -148,6 +158,9 @@ public:
     Q_INVOKABLE SKRResult addChildTreeItem(int            projectId,
                                            int            targetId,
                                            const QString& type);
+    SKRResult             addTreeItems(int                                    projectId,
+                                       int                                    parentId,
+                                       const QList<QHash<QString, QVariant> >& valuesList);
     SKRResult             removeTreeItem(int projectId,
                                          int targetId);
 
@@ -196,8 +209,14 @@ public:
                                                  int sourceTreeItemId,
                                                  int receiverTreeItemId);
 
+public slots:
+
+    void invalidateTreeTopology(int projectId);
+
 private:
 
+    const SKRTreeTopology& treeTopology(int projectId) const;
+
     SKRResult setTrashedDateToNow(int projectId,
                                   int treeItemId);
     SKRResult setTrashedDateToNull(int projectId,
@@ -246,6 +265,8 @@ signals:
                            const QDateTime& newDate);
     void treeItemAdded(int projectId,
                        int treeItemId);
+    void treeItemsAdded(int       projectId,
+                        QList<int>treeItemIds);
     void treeItemRemoved(int projectId,
                          int treeItemId);
     void treeItemMoved(int       sourceProjectId,
@@ -270,6 +291,12 @@ protected:
     QString m_tableName;
     int m_last_added_id;
     SKRPropertyHub *m_propertyHub;
+
+    // per project, rebuilt lazily after an invalidation
+    mutable QHash<int, SKRTreeTopology>m_treeTopologyByProjectHash;
+
+    // contents written while typing
+    SKRContentJournal *m_contentJournal;
 };
 
 #endif // SKRTREEHUB_H
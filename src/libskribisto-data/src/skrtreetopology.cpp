@@ -0,0 +1,486 @@
+/***************************************************************************
+*   Copyright (C) 2021 by Cyril Jacquet                                 *
+*   cyril.jacquet@skribisto.eu                                        *
+*                                                                         *
+*  Filename: skrtreetopology.cpp                                                   *
+*  This file is part of Skribisto.                                    *
+*                                                                         *
+*  Skribisto is free software: you can redistribute it and/or modify  *
+*  it under the terms of the GNU General Public License as published by   *
+*  the Free Software Foundation, either version 3 of the License, or      *
+*  (at your option) any later version.                                    *
+*                                                                         *
+*  Skribisto is distributed in the hope that it will be useful,       *
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+*  GNU General Public License for more details.                           *
+*                                                                         *
+*  You should have received a copy of the GNU General Public License      *
+*  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
+***************************************************************************/
+#include "skrtreetopology.h"
+
+SKRTreeTopology::SKRTreeTopology() : m_isValid(false), m_topLevelTrashedCount(0), m_topLevelNotTrashedCount(0)
+{}
+
+// ----------------------------------------------------------------------------------------
+
+void SKRTreeTopology::build(const QList<int>      & sortedIds,
+                            const QHash<int, int> & indents,
+                            const QHash<int, bool>& trashedStates)
+{
+    m_sortedIds = sortedIds;
+    m_indents.clear();
+    m_indents.reserve(sortedIds.count());
+    m_trashed.clear();
+    m_trashed.reserve(sortedIds.count());
+
+    for (int id : sortedIds) {
+        m_indents.append(indents.value(id));
+        m_trashed.append(trashedStates.value(id, false));
+    }
+
+    this->computeStructure();
+    m_isValid = true;
+}
+
+// ----------------------------------------------------------------------------------------
+
+void SKRTreeTopology::clear()
+{
+    m_isValid = false;
+    m_sortedIds.clear();
+    m_rowForId.clear();
+    m_indents.clear();
+    m_trashed.clear();
+    m_parentRows.clear();
+    m_subtreeEnds.clear();
+    m_depths.clear();
+    m_childRows.clear();
+    m_topLevelRows.clear();
+    m_trashedChildCounts.clear();
+    m_notTrashedChildCounts.clear();
+    m_topLevelTrashedCount    = 0;
+    m_topLevelNotTrashedCount = 0;
+}
+
+// ----------------------------------------------------------------------------------------
+
+bool SKRTreeTopology::isValid() const
+{
+    return m_isValid;
+}
+
+// ----------------------------------------------------------------------------------------
+
+bool SKRTreeTopology::contains(int treeItemId) const
+{
+    return m_rowForId.contains(treeItemId);
+}
+
+// ----------------------------------------------------------------------------------------
+
+int SKRTreeTopology::count() const
+{
+    return m_sortedIds.count();
+}
+
+// ----------------------------------------------------------------------------------------
+
+QList<int>SKRTreeTopology::sortedIds() const
+{
+    return m_sortedIds;
+}
+
+// ----------------------------------------------------------------------------------------
+
+int SKRTreeTopology::indent(int treeItemId) const
+{
+    int row = m_rowForId.value(treeItemId, -1);
+
+    if (row == -1) {
+        return -2;
+    }
+
+    return m_indents.at(row);
+}
+
+// ----------------------------------------------------------------------------------------
+
+int SKRTreeTopology::depth(int treeItemId) const
+{
+    int row = m_rowForId.value(treeItemId, -1);
+
+    if (row == -1) {
+        return -1;
+    }
+
+    return m_depths.at(row);
+}
+
+// ----------------------------------------------------------------------------------------
+
+int SKRTreeTopology::subtreeSize(int treeItemId) const
+{
+    int row = m_rowForId.value(treeItemId, -1);
+
+    if (row == -1) {
+        return 0;
+    }
+
+    return m_subtreeEnds.at(row) - row - 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeTopology::parentId
+/// \param treeItemId
+/// \return -1 for top items (indent 0), -2 if no parent can be found
+int SKRTreeTopology::parentId(int treeItemId) const
+{
+    int row = m_rowForId.value(treeItemId, -1);
+
+    if ((row == -1) || (m_indents.at(row) == 0)) {
+        return -1;
+    }
+
+    int parentRow = m_parentRows.at(row);
+
+    if (parentRow == -1) {
+        return -2;
+    }
+
+    return m_sortedIds.at(parentRow);
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeTopology::directChildren
+/// \param treeItemId
+/// \return
+/// -1 is the invisible root, its children are the items with indent 0
+QList<int>SKRTreeTopology::directChildren(int treeItemId) const
+{
+    QList<int> list;
+    QVector<int> rows;
+
+    if (treeItemId == -1) {
+        if (m_indents.isEmpty() || (m_indents.first() != 0)) {
+            return list;
+        }
+        rows = m_topLevelRows;
+    }
+    else {
+        int row = m_rowForId.value(treeItemId, -1);
+
+        if (row == -1) {
+            return list;
+        }
+
+        rows = m_childRows.at(row);
+    }
+
+    list.reserve(rows.count());
+
+    for (int childRow : qAsConst(rows)) {
+        list.append(m_sortedIds.at(childRow));
+    }
+
+    return list;
+}
+
+// ----------------------------------------------------------------------------------------
+
+QList<int>SKRTreeTopology::allChildren(int treeItemId) const
+{
+    QList<int> list;
+    int row = m_rowForId.value(treeItemId, -1);
+
+    if (row == -1) {
+        return list;
+    }
+
+    return m_sortedIds.mid(row + 1, m_subtreeEnds.at(row) - row - 1);
+}
+
+// ----------------------------------------------------------------------------------------
+
+QList<int>SKRTreeTopology::allAncestors(int treeItemId) const
+{
+    QList<int> list;
+    int row = m_rowForId.value(treeItemId, -1);
+
+    if (row == -1) {
+        return list;
+    }
+
+    list.reserve(m_depths.at(row));
+
+    for (int parentRow = m_parentRows.at(row); parentRow != -1; parentRow = m_parentRows.at(parentRow)) {
+        list.append(m_sortedIds.at(parentRow));
+    }
+
+    return list;
+}
+
+// ----------------------------------------------------------------------------------------
+
+QList<int>SKRTreeTopology::allSiblings(int treeItemId) const
+{
+    QList<int> list;
+    int row = m_rowForId.value(treeItemId, -1);
+
+    if (row == -1) {
+        return list;
+    }
+
+    int parentRow = m_parentRows.at(row);
+    int indent    = m_indents.at(row);
+
+    if (parentRow != -1) {
+        for (int siblingRow : m_childRows.at(parentRow)) {
+            if (siblingRow != row) {
+                list.append(m_sortedIds.at(siblingRow));
+            }
+        }
+    }
+    else {
+        for (int i = 0; i < m_sortedIds.count(); i++) {
+            if ((i != row) && (m_parentRows.at(i) == -1) && (m_indents.at(i) == indent)) {
+                list.append(m_sortedIds.at(i));
+            }
+        }
+    }
+
+    return list;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeTopology::childState
+/// \param treeItemId
+/// \return ChildState flags of the direct children, -1 is the invisible root
+int SKRTreeTopology::childState(int treeItemId) const
+{
+    int trashedCount    = 0;
+    int notTrashedCount = 0;
+
+    if (treeItemId == -1) {
+        trashedCount    = m_topLevelTrashedCount;
+        notTrashedCount = m_topLevelNotTrashedCount;
+    }
+    else {
+        int row = m_rowForId.value(treeItemId, -1);
+
+        if (row == -1) {
+            return NoChild;
+        }
+
+        trashedCount    = m_trashedChildCounts.at(row);
+        notTrashedCount = m_notTrashedChildCounts.at(row);
+    }
+
+    int state = NoChild;
+
+    if (notTrashedCount > 0) {
+        state |= HasNotTrashedChild;
+    }
+
+    if (trashedCount > 0) {
+        state |= HasTrashedChild;
+    }
+
+    return state;
+}
+
+// ----------------------------------------------------------------------------------------
+
+QHash<int, int>SKRTreeTopology::allChildStates() const
+{
+    QHash<int, int> hash;
+
+    hash.reserve(m_sortedIds.count() + 1);
+    hash.insert(-1, this->childState(-1));
+
+    for (int id : m_sortedIds) {
+        hash.insert(id, this->childState(id));
+    }
+
+    return hash;
+}
+
+// ----------------------------------------------------------------------------------------
+
+bool SKRTreeTopology::setIndent(int treeItemId, int newIndent)
+{
+    int row = m_rowForId.value(treeItemId, -1);
+
+    if (row == -1) {
+        return false;
+    }
+
+    m_indents[row] = newIndent;
+    this->computeStructure();
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeTopology::setTrashed
+/// \param treeItemId
+/// \param trashed
+/// \return
+/// only the counts of the parent move, the structure stays the same
+bool SKRTreeTopology::setTrashed(int treeItemId, bool trashed)
+{
+    int row = m_rowForId.value(treeItemId, -1);
+
+    if (row == -1) {
+        return false;
+    }
+
+    if (m_trashed.at(row) == trashed) {
+        return true;
+    }
+
+    int parentRow = this->listedParentRow(row);
+
+    if (parentRow != -2) {
+        this->countChild(parentRow, m_trashed.at(row), -1);
+        this->countChild(parentRow, trashed,           1);
+    }
+
+    m_trashed[row] = trashed;
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------
+
+bool SKRTreeTopology::remove(int treeItemId)
+{
+    int row = m_rowForId.value(treeItemId, -1);
+
+    if (row == -1) {
+        return false;
+    }
+
+    m_sortedIds.removeAt(row);
+    m_indents.remove(row);
+    m_trashed.remove(row);
+    this->computeStructure();
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeTopology::computeStructure
+/// one pass over the sorted rows. The parent of a row is the nearest previous
+/// row with indent - 1, a subtree ends on the first following row with an
+/// indent lower or equal.
+void SKRTreeTopology::computeStructure()
+{
+    int count = m_sortedIds.count();
+
+    m_rowForId.clear();
+    m_rowForId.reserve(count);
+    m_parentRows.fill(-1, count);
+    m_subtreeEnds.fill(count, count);
+    m_depths.fill(0, count);
+    m_childRows = QVector<QVector<int> >(count);
+    m_topLevelRows.clear();
+    m_trashedChildCounts.fill(0, count);
+    m_notTrashedChildCounts.fill(0, count);
+    m_topLevelTrashedCount    = 0;
+    m_topLevelNotTrashedCount = 0;
+
+    QHash<int, int> lastRowForIndentHash;
+    QVector<int>    openRows;
+
+    for (int row = 0; row < count; row++) {
+        int indent = m_indents.at(row);
+
+        m_rowForId.insert(m_sortedIds.at(row), row);
+
+        while (!openRows.isEmpty() && m_indents.at(openRows.last()) >= indent) {
+            m_subtreeEnds[openRows.last()] = row;
+            openRows.removeLast();
+        }
+        openRows.append(row);
+
+        int parentRow = lastRowForIndentHash.value(indent - 1, -1);
+
+        m_parentRows[row] = parentRow;
+
+        if (parentRow != -1) {
+            m_depths[row] = m_depths.at(parentRow) + 1;
+
+            // only if still inside the parent's subtree
+            if (m_subtreeEnds.at(parentRow) == count) {
+                m_childRows[parentRow].append(row);
+                this->countChild(parentRow, m_trashed.at(row), 1);
+            }
+        }
+
+        if (indent == 0) {
+            m_topLevelRows.append(row);
+
+            if (m_indents.first() == 0) {
+                this->countChild(-1, m_trashed.at(row), 1);
+            }
+        }
+
+        lastRowForIndentHash.insert(indent, row);
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+void SKRTreeTopology::countChild(int parentRow, bool trashed, int increment)
+{
+    if (parentRow == -1) {
+        if (trashed) {
+            m_topLevelTrashedCount += increment;
+        }
+        else {
+            m_topLevelNotTrashedCount += increment;
+        }
+        return;
+    }
+
+    if (trashed) {
+        m_trashedChildCounts[parentRow] += increment;
+    }
+    else {
+        m_notTrashedChildCounts[parentRow] += increment;
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRTreeTopology::listedParentRow
+/// \param row
+/// \return the row counting this one as a direct child, -1 for the invisible
+/// root, -2 if none
+int SKRTreeTopology::listedParentRow(int row) const
+{
+    int parentRow = m_parentRows.at(row);
+
+    if (parentRow != -1) {
+        return row < m_subtreeEnds.at(parentRow) ? parentRow : -2;
+    }
+
+    if ((m_indents.at(row) == 0) && (m_indents.first() == 0)) {
+        return -1;
+    }
+
+    return -2;
+}
@@ -0,0 +1,103 @@
+/***************************************************************************
+*   Copyright (C) 2021 by Cyril Jacquet                                 *
+*   cyril.jacquet@skribisto.eu                                        *
+*                                                                         *
+*  Filename: skrtreetopology.h                                                   *
+*  This file is part of Skribisto.                                    *
+*                                                                         *
+*  Skribisto is free software: you can redistribute it and/or modify  *
+*  it under the terms of the GNU General Public License as published by   *
+*  the Free Software Foundation, either version 3 of the License, or      *
+*  (at your option) any later version.                                    *
+*                                                                         *
+*  Skribisto is distributed in the hope that it will be useful,       *
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+*  GNU General Public License for more details.                           *
+*                                                                         *
+*  You should have received a copy of the GNU General Public License      *
+*  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
+***************************************************************************/
+#ifndef SKRTREETOPOLOGY_H
+#define SKRTREETOPOLOGY_H
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+#include "skribisto_data_global.h"
+
+///
+/// \brief The SKRTreeTopology class
+/// In-memory picture of the tree of one project, built from the sorted ids and
+/// the indents of tbl_tree. Rows are the positions in the sort order. Parent
+/// pointers, direct children and subtree ends are computed in one linear pass
+/// so structural queries don't need the database anymore.
+class EXPORT SKRTreeTopology {
+public:
+
+    enum ChildState {
+        NoChild            = 0x0,
+        HasNotTrashedChild = 0x1,
+        HasTrashedChild    = 0x2
+    };
+
+    SKRTreeTopology();
+
+    void       build(const QList<int>      & sortedIds,
+                     const QHash<int, int> & indents,
+                     const QHash<int, bool>& trashedStates);
+    void       clear();
+    bool       isValid() const;
+
+    bool       contains(int treeItemId) const;
+    int        count() const;
+    QList<int> sortedIds() const;
+    int        indent(int treeItemId) const;
+    int        depth(int treeItemId) const;
+    int        subtreeSize(int treeItemId) const;
+
+    int        parentId(int treeItemId) const;
+    QList<int> directChildren(int treeItemId) const;
+    QList<int> allChildren(int treeItemId) const;
+    QList<int> allAncestors(int treeItemId) const;
+    QList<int> allSiblings(int treeItemId) const;
+
+    int        childState(int treeItemId) const;
+    QHash<int, int>allChildStates() const;
+
+    bool       setIndent(int treeItemId,
+                         int newIndent);
+    bool       setTrashed(int  treeItemId,
+                          bool trashed);
+    bool       remove(int treeItemId);
+
+private:
+
+    void computeStructure();
+    void countChild(int  parentRow,
+                    bool trashed,
+                    int  increment);
+    int  listedParentRow(int row) const;
+
+private:
+
+    bool m_isValid;
+    QList<int>m_sortedIds;
+    QHash<int, int>m_rowForId;
+    QVector<int>m_indents;
+    QVector<bool>m_trashed;
+    QVector<int>m_parentRows;
+    QVector<int>m_subtreeEnds;
+    QVector<int>m_depths;
+    QVector<QVector<int> >m_childRows;
+    QVector<int>m_topLevelRows;
+
+    // direct children counts, the invisible root (-1) is kept apart
+    QVector<int>m_trashedChildCounts;
+    QVector<int>m_notTrashedChildCounts;
+    int m_topLevelTrashedCount;
+    int m_topLevelNotTrashedCount;
+};
+
+#endif // SKRTREETOPOLOGY_H
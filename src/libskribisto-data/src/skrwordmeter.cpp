@@ -1,106 +1,438 @@
 #include "skrwordmeter.h"
 
-#include <QTextDocument>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QPair>
+#include <QThreadPool>
 
-SKRWordMeterWorker::SKRWordMeterWorker(QObject       *parent,
-                                       int            projectId,
-                                       int            treeItemId,
-                                       const QString& text,
-                                       bool           triggerProjectModifiedSignal) :
-    QThread(parent), m_projectId(projectId), m_treeItemId(treeItemId), m_text(text),
-    m_triggerProjectModifiedSignal(triggerProjectModifiedSignal)
-{}
+// one pool shared by all the meters, no thread is created per count
+Q_GLOBAL_STATIC(QThreadPool, wordMeterThreadPool)
+
+///
+/// \brief The SKRWordMeterRun struct
+/// texts given to countTexts, shared by the batches counting them
+struct SKRWordMeterRun {
+    int                       projectId;
+    QList<SKRWordMeter::Text> texts;
+    QAtomicInt                remainingBatchCount;
+    QAtomicInt                countedCount;
+    QAtomicInt                skippedCount;
+    QElapsedTimer             timer;
+};
+
+namespace {
+// bumped each time the counting rules change, so that the stored counts are
+// no longer trusted
+const int countingVersion = 1;
+
+// a batch is given to the pool when one of these is reached
+const int batchMaxTextCount      = 64;
+const int batchMaxCharacterCount = 256 * 1024;
+
+// ASCII fast path, other characters go through QChar
+bool isBlank(QChar c)
+{
+    ushort u = c.unicode();
+
+    if (u < 128) {
+        return u == ' ' || u == '\t' || u == '\r' || u == '\f' || u == '\v';
+    }
+
+    return c.isSpace();
+}
 
-void SKRWordMeterWorker::countWords()
+bool isWordCharacter(QChar c)
 {
-    QTextDocument textDocument;
+    ushort u = c.unicode();
 
-    textDocument.setMarkdown(m_text);
-    QString plainText = textDocument.toPlainText();
+    if (u < 128) {
+        return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || (u >= '0' && u <= '9');
+    }
+
+    return c.isLetterOrNumber() || c.isMark();
+}
+
+bool isAsciiPunctuation(QChar c)
+{
+    ushort u = c.unicode();
+
+    return (u >= '!' && u <= '/') || (u >= ':' && u <= '@') || (u >= '[' && u <= '`') || (u >= '{' && u <= '~');
+}
 
-    plainText.replace(QRegularExpression("\\n+|\\t+"), " ");
-    plainText = plainText.trimmed();
-    int wordCount = plainText.count(" ");
+///
+/// \brief skipBlockMarkers
+/// \return the position of the first character after the quote, heading and
+/// list markers of the line, lineEnd if the whole line is markup
+qsizetype skipBlockMarkers(const QChar *data, qsizetype i, qsizetype lineEnd)
+{
+    // thematic break or setext underline : ---, ***, ___, ===
+    ushort first = data[i].unicode();
 
-    if (wordCount == 0) {
-        if (plainText.isEmpty()) {
-            wordCount = 0;
+    if ((first == '-') || (first == '*') || (first == '_') || (first == '=')) {
+        qsizetype j     = i;
+        int markerCount = 0;
+
+        while (j < lineEnd && (data[j].unicode() == first || isBlank(data[j]))) {
+            markerCount += data[j].unicode() == first ? 1 : 0;
+            ++j;
         }
-        else {
-            wordCount = 1;
+
+        if ((j == lineEnd) && ((markerCount >= 3) || (first == '='))) {
+            return lineEnd;
         }
     }
-    else {
-        wordCount += 1;
+
+    while (i < lineEnd) {
+        ushort u = data[i].unicode();
+
+        if (u == '>') {
+            ++i;
+        }
+        else if (u == '#') {
+            qsizetype j = i;
+
+            while (j < lineEnd && data[j].unicode() == '#') {
+                ++j;
+            }
+
+            if ((j - i > 6) || ((j < lineEnd) && !isBlank(data[j]))) {
+                return i;
+            }
+            i = j;
+        }
+        else if (((u == '-') || (u == '*') || (u == '+')) && (i + 1 < lineEnd) && isBlank(data[i + 1])) {
+            ++i;
+
+            // task list
+            if ((i + 3 < lineEnd) && (data[i + 1].unicode() == '[') && (data[i + 3].unicode() == ']')) {
+                i += 4;
+            }
+        }
+        else if ((u >= '0') && (u <= '9')) {
+            qsizetype j = i;
+
+            while (j < lineEnd && j - i < 9 && data[j].unicode() >= '0' && data[j].unicode() <= '9') {
+                ++j;
+            }
+
+            if ((j + 1 < lineEnd) && ((data[j].unicode() == '.') || (data[j].unicode() == ')')) &&
+                isBlank(data[j + 1])) {
+                i = j + 1;
+            }
+            else {
+                return i;
+            }
+        }
+        else {
+            return i;
+        }
+
+        while (i < lineEnd && isBlank(data[i])) {
+            ++i;
+        }
     }
 
-    emit wordCountCalculated(m_projectId, m_treeItemId, wordCount, m_triggerProjectModifiedSignal);
+    return i;
+}
 }
 
-void SKRWordMeterWorker::countCharacters()
-{
-    QTextDocument textDocument;
+SKRWordMeterWorker::SKRWordMeterWorker(SKRWordMeter  *meter,
+                                       int            projectId,
+                                       int            treeItemId,
+                                       const QString& text,
+                                       bool           triggerProjectModifiedSignal) :
+    m_meter(meter), m_projectId(projectId), m_treeItemId(treeItemId), m_text(text),
+    m_triggerProjectModifiedSignal(triggerProjectModifiedSignal)
+{}
 
-    textDocument.setMarkdown(m_text);
-    QString plainText = textDocument.toPlainText();
+void SKRWordMeterWorker::run()
+{
+    int wordCount      = 0;
+    int characterCount = 0;
 
-    int charCount = plainText.count();
+    SKRWordMeter::countMarkdown(m_text, wordCount, characterCount);
 
-    emit characterCountCalculated(m_projectId, m_treeItemId, charCount,  m_triggerProjectModifiedSignal);
+    // emitted from the pool thread, queued to the receivers
+    emit m_meter->wordCountCalculated(m_projectId, m_treeItemId, wordCount, m_triggerProjectModifiedSignal);
+    emit m_meter->characterCountCalculated(m_projectId, m_treeItemId, characterCount,
+                                           m_triggerProjectModifiedSignal);
+    emit m_meter->fingerprintCalculated(m_projectId, m_treeItemId, SKRWordMeter::fingerprint(m_text));
 }
 
-void SKRWordMeterWorker::run()
+SKRWordMeterBatchWorker::SKRWordMeterBatchWorker(SKRWordMeter                         *meter,
+                                                 const QSharedPointer<SKRWordMeterRun>& run,
+                                                 int                                   first,
+                                                 int                                   last) :
+    m_meter(meter), m_run(run), m_first(first), m_last(last)
+{}
+
+///
+/// \brief SKRWordMeterBatchWorker::run
+/// texts whose fingerprint didn't change since their counts were stored are
+/// skipped, the last batch to finish reports the whole run
+void SKRWordMeterBatchWorker::run()
 {
-    countWords();
-    countCharacters();
-    emit finished();
+    const int projectId = m_run->projectId;
+
+    for (int i = m_first; i <= m_last; ++i) {
+        const SKRWordMeter::Text& text = m_run->texts.at(i);
+        QString fingerprint            = SKRWordMeter::fingerprint(text.text);
+
+        if (fingerprint == text.knownFingerprint) {
+            m_run->skippedCount.ref();
+            continue;
+        }
+
+        int wordCount      = 0;
+        int characterCount = 0;
+
+        SKRWordMeter::countMarkdown(text.text, wordCount, characterCount);
+
+        emit m_meter->wordCountCalculated(projectId, text.treeItemId, wordCount, false);
+        emit m_meter->characterCountCalculated(projectId, text.treeItemId, characterCount, false);
+        emit m_meter->fingerprintCalculated(projectId, text.treeItemId, fingerprint);
+        m_run->countedCount.ref();
+    }
+
+    if (!m_run->remainingBatchCount.deref()) {
+        emit m_meter->textsCounted(projectId,
+                                   m_run->countedCount.loadAcquire(),
+                                   m_run->skippedCount.loadAcquire(),
+                                   m_run->timer.elapsed());
+    }
 }
 
 SKRWordMeter::SKRWordMeter(QObject *parent) : QObject(parent)
 {}
 
+SKRWordMeter::~SKRWordMeter()
+{
+    // workers keep a pointer to this meter
+    wordMeterThreadPool()->waitForDone();
+}
+
 void SKRWordMeter::countText(int            projectId,
                              int            treeItemId,
                              const QString& text,
                              bool           sameThread,
                              bool           triggerProjectModifiedSignal)
 {
-    SKRWordMeterWorker *worker = new SKRWordMeterWorker(this,
-                                                        projectId,
-                                                        treeItemId,
-                                                        text,
-                                                        triggerProjectModifiedSignal);
-
     if (sameThread) {
-        connect(worker,
-                &SKRWordMeterWorker::wordCountCalculated,
-                this,
-                &SKRWordMeter::wordCountCalculated,
-                Qt::DirectConnection);
-        connect(worker,
-                &SKRWordMeterWorker::characterCountCalculated,
-                this,
-                &SKRWordMeter::characterCountCalculated,
-                Qt::DirectConnection);
-        worker->countWords();
-        worker->countCharacters();
+        int wordCount      = 0;
+        int characterCount = 0;
+
+        countMarkdown(text, wordCount, characterCount);
+
+        emit wordCountCalculated(projectId, treeItemId, wordCount, triggerProjectModifiedSignal);
+        emit characterCountCalculated(projectId, treeItemId, characterCount, triggerProjectModifiedSignal);
+        emit fingerprintCalculated(projectId, treeItemId, fingerprint(text));
     }
     else {
-        connect(worker,
-                &SKRWordMeterWorker::finished,
-                worker,
-                &QObject::deleteLater,
-                Qt::QueuedConnection);
-        connect(worker,
-                &SKRWordMeterWorker::wordCountCalculated,
-                this,
-                &SKRWordMeter::wordCountCalculated,
-                Qt::QueuedConnection);
-        connect(worker,
-                &SKRWordMeterWorker::characterCountCalculated,
-                this,
-                &SKRWordMeter::characterCountCalculated,
-                Qt::QueuedConnection);
-        worker->start();
+        wordMeterThreadPool()->start(new SKRWordMeterWorker(this,
+                                                            projectId,
+                                                            treeItemId,
+                                                            text,
+                                                            triggerProjectModifiedSignal));
+    }
+}
+
+///
+/// \brief SKRWordMeter::countTexts
+/// \param projectId
+/// \param texts
+/// Counts many texts at once, when a project is opened. The texts are cut in
+/// batches given to the shared pool, so only a few runnables are queued
+/// whatever the size of the project. A text whose fingerprint is the known one
+/// is not counted again. textsCounted is emitted once everything is done.
+void SKRWordMeter::countTexts(int projectId, const QList<Text>& texts)
+{
+    if (texts.isEmpty()) {
+        emit textsCounted(projectId, 0, 0, 0);
+
+        return;
+    }
+
+    QSharedPointer<SKRWordMeterRun> run(new SKRWordMeterRun);
+
+    run->projectId = projectId;
+    run->texts     = texts;
+    run->timer.start();
+
+    // cut before starting anything, a batch may finish before the next is cut
+    QList<QPair<int, int> > batches;
+    int first          = 0;
+    int characterCount = 0;
+
+    for (int i = 0; i < texts.count(); ++i) {
+        characterCount += texts.at(i).text.size();
+
+        if ((i - first + 1 >= batchMaxTextCount) || (characterCount >= batchMaxCharacterCount) ||
+            (i == texts.count() - 1)) {
+            batches.append(qMakePair(first, i));
+            first          = i + 1;
+            characterCount = 0;
+        }
+    }
+
+    run->remainingBatchCount.storeRelease(batches.count());
+
+    for (const QPair<int, int>& batch : qAsConst(batches)) {
+        wordMeterThreadPool()->start(new SKRWordMeterBatchWorker(this, run, batch.first, batch.second));
+    }
+}
+
+///
+/// \brief SKRWordMeter::fingerprint
+/// \param text
+/// \return a short string identifying the text and the counting rules
+/// 64 bits FNV-1a over the UTF-16 code units, prefixed by the length. Stable
+/// between runs and platforms, unlike qHash, so it can be stored.
+QString SKRWordMeter::fingerprint(QStringView text)
+{
+    quint64 hash         = Q_UINT64_C(14695981039346656037);
+    const QChar *data    = text.data();
+    const qsizetype size = text.size();
+
+    for (qsizetype i = 0; i < size; ++i) {
+        hash ^= data[i].unicode();
+        hash *= Q_UINT64_C(1099511628211);
+    }
+
+    return QString("%1-%2-%3").arg(countingVersion).arg(size).arg(hash, 16, 16, QChar('0'));
+}
+
+///
+/// \brief SKRWordMeter::countMarkdown
+/// \param markdown
+/// \param wordCount
+/// \param characterCount
+/// One pass over the markdown, without building a document. Markup (quote,
+/// heading and list markers, emphasis, code fences, link targets, escapes) is
+/// skipped. The characters are those of the rendered plain text: a line or
+/// paragraph break counts as one, indentation and trailing blanks don't. A word
+/// is a run of non blank characters holding at least one letter or number.
+void SKRWordMeter::countMarkdown(QStringView markdown, int& wordCount, int& characterCount)
+{
+    wordCount      = 0;
+    characterCount = 0;
+
+    const QChar *data = markdown.data();
+    qsizetype    size = markdown.size();
+
+    bool inCodeBlock   = false;
+    bool inWord        = false;
+    bool wordHasLetter = false;
+    bool hasText       = false;
+    bool pendingBreak  = false;
+    int  pendingBlanks = 0;
+
+    auto endWord = [&]() {
+                       if (inWord && wordHasLetter) {
+                           wordCount++;
+                       }
+                       inWord        = false;
+                       wordHasLetter = false;
+                   };
+
+    qsizetype lineStart = 0;
+
+    while (lineStart < size) {
+        qsizetype lineEnd = lineStart;
+
+        while (lineEnd < size && data[lineEnd].unicode() != '\n') {
+            ++lineEnd;
+        }
+
+        qsizetype i = lineStart;
+
+        while (i < lineEnd && isBlank(data[i])) {
+            ++i;
+        }
+
+        // code fence
+        if ((lineEnd - i >= 3) &&
+            (((data[i].unicode() == '`') && (data[i + 1].unicode() == '`') && (data[i + 2].unicode() == '`')) ||
+             ((data[i].unicode() == '~') && (data[i + 1].unicode() == '~') && (data[i + 2].unicode() == '~')))) {
+            inCodeBlock = !inCodeBlock;
+            i           = lineEnd;
+        }
+        else if (inCodeBlock) {
+            i = lineStart;
+        }
+        else if (i < lineEnd) {
+            i = skipBlockMarkers(data, i, lineEnd);
+        }
+
+        for (; i < lineEnd; ++i) {
+            QChar  c = data[i];
+            ushort u = c.unicode();
+
+            if (!inCodeBlock) {
+                if ((u == '\\') && (i + 1 < lineEnd) && isAsciiPunctuation(data[i + 1])) {
+                    ++i;
+                    c = data[i];
+                }
+                else if ((u == '*') || (u == '`') || (u == '[')) {
+                    continue;
+                }
+                else if ((u == '~') && (i + 1 < lineEnd) && (data[i + 1].unicode() == '~')) {
+                    ++i;
+                    continue;
+                }
+                else if ((u == '!') && (i + 1 < lineEnd) && (data[i + 1].unicode() == '[')) {
+                    continue;
+                }
+                else if (u == '_') {
+                    // snake_case stays a word
+                    if (!((i > lineStart) && (i + 1 < lineEnd) && isWordCharacter(data[i - 1]) &&
+                          isWordCharacter(data[i + 1]))) {
+                        continue;
+                    }
+                }
+                else if (u == ']') {
+                    // link target
+                    if ((i + 1 < lineEnd) && (data[i + 1].unicode() == '(')) {
+                        i += 2;
+
+                        for (int depth = 1; i < lineEnd; ++i) {
+                            if (data[i].unicode() == '(') {
+                                depth++;
+                            }
+                            else if ((data[i].unicode() == ')') && (--depth == 0)) {
+                                break;
+                            }
+                        }
+                    }
+                    continue;
+                }
+            }
+
+            if (isBlank(c)) {
+                endWord();
+                pendingBlanks++;
+                continue;
+            }
+
+            if (pendingBreak) {
+                characterCount++;
+            }
+            else {
+                characterCount += pendingBlanks;
+            }
+            pendingBreak  = false;
+            pendingBlanks = 0;
+
+            characterCount++;
+            hasText = true;
+
+            inWord         = true;
+            wordHasLetter |= isWordCharacter(c);
+        }
+
+        endWord();
+        pendingBlanks = 0;
+        pendingBreak  = hasText;
+
+        lineStart = lineEnd + 1;
     }
 }
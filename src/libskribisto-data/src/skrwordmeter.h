@@ -2,58 +2,78 @@
 #define SKRWORDMETER_H
 
 #include <QObject>
+#include <QList>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QStringView>
 #include "skr.h"
 
+class SKRWordMeter;
+struct SKRWordMeterRun;
 
-class SKRWordMeterWorker : public QThread {
-    Q_OBJECT
-
+class SKRWordMeterWorker : public QRunnable {
 public:
 
-    SKRWordMeterWorker(QObject       *parent,
+    SKRWordMeterWorker(SKRWordMeter  *meter,
                        int            projectId,
                        int            treeItemId,
                        const QString& text,
                        bool           triggerProjectModifiedSignal);
 
-public slots:
-
-    void countWords();
-    void countCharacters();
-
-signals:
-
-    void wordCountCalculated(int  projectId,
-                             int  treeItemId,
-                             int  wordCount,
-                             bool triggerProjectModifiedSignal);
-    void characterCountCalculated(int  projectId,
-                                  int  treeItemId,
-                                  int  charCount,
-                                  bool triggerProjectModifiedSignal);
-    void finished();
+    void run() override;
 
 private:
 
-    void run() override;
-
+    SKRWordMeter *m_meter;
     int m_projectId;
     int m_treeItemId;
     QString m_text;
     bool m_triggerProjectModifiedSignal;
 };
 
+class SKRWordMeterBatchWorker : public QRunnable {
+public:
+
+    SKRWordMeterBatchWorker(SKRWordMeter                         *meter,
+                            const QSharedPointer<SKRWordMeterRun>& run,
+                            int                                   first,
+                            int                                   last);
+
+    void run() override;
+
+private:
+
+    SKRWordMeter *m_meter;
+    QSharedPointer<SKRWordMeterRun>m_run;
+    int m_first;
+    int m_last;
+};
+
 class SKRWordMeter : public QObject {
     Q_OBJECT
 
 public:
 
+    struct Text {
+        int     treeItemId;
+        QString text;
+        QString knownFingerprint;
+    };
+
     explicit SKRWordMeter(QObject *parent = nullptr);
-    void countText(int            projectId,
-                   int            treeItemId,
-                   const QString& text,
-                   bool           sameThread,
-                   bool           triggerProjectModifiedSignal = true);
+    ~SKRWordMeter();
+    void        countText(int            projectId,
+                          int            treeItemId,
+                          const QString& text,
+                          bool           sameThread,
+                          bool           triggerProjectModifiedSignal = true);
+    void        countTexts(int                projectId,
+                           const QList<Text>& texts);
+
+    static void countMarkdown(QStringView markdown,
+                              int       & wordCount,
+                              int       & characterCount);
+    static QString fingerprint(QStringView text);
 
 signals:
 
@@ -65,10 +85,13 @@ signals:
                                   int  treeItemId,
                                   int  charCount,
                                   bool triggerProjectModifiedSignal);
-
-private:
-
-    QThread m_workerThread;
+    void fingerprintCalculated(int            projectId,
+                               int            treeItemId,
+                               const QString& fingerprint);
+    void textsCounted(int    projectId,
+                      int    countedCount,
+                      int    skippedCount,
+                      qint64 elapsedTime);
 };
 
 #endif // SKRWORDMETER_H
@@ -3,6 +3,7 @@
 
 #include <QCoreApplication>
 #include <QDebug>
+#include <QSettings>
 
 PLMProjectManager::PLMProjectManager(QObject *parent) : QObject(parent)
 {
@@ -35,7 +36,7 @@ SKRResult PLMProjectManager::loadProject(const QUrl& fileName, int& projectId, c
 
     m_projectIdIncrement += 1;
     projectId             = m_projectIdIncrement;
-    PLMProject *project = new PLMProject(this, projectId, fileName, &result, sqlFile);
+    PLMProject *project = new PLMProject(this, projectId, fileName, &result, sqlFile, this->workingMode());
 
     // if result :
     if (project->id() == -1) {
@@ -49,6 +50,7 @@ SKRResult PLMProjectManager::loadProject(const QUrl& fileName, int& projectId, c
 
     IFOK(result) {
         m_projectForIntMap.insert(projectId, project);
+        connect(project, &PLMProject::saveFinished, this, &PLMProjectManager::projectSaveFinished);
     }
 
     return result;
@@ -65,9 +67,29 @@ SKRResult PLMProjectManager::saveProject(int projectId)
 
 // -----------------------------------------------------------------------------
 
+///
+/// \brief PLMProjectManager::compactProject
+/// \param projectId
+/// \return
+/// shrink the database then save it
+SKRResult PLMProjectManager::compactProject(int projectId)
+{
+    PLMProject *project = m_projectForIntMap.value(projectId, 0);
+
+    if (!project) {
+        SKRResult result(SKRResult::Critical, this, "project_missing");
+        result.addData("projectId", projectId);
+        return result;
+    }
+
+    return saveProjectAs(projectId, project->getType(), project->getPath(), false, true);
+}
+
+// -----------------------------------------------------------------------------
+
 SKRResult PLMProjectManager::saveProjectAs(int projectId,
                                            const QString& type,
-                                           const QUrl& path, bool isCopy)
+                                           const QUrl& path, bool isCopy, bool compact)
 {
     SKRResult   result(this);
     PLMProject *project = m_projectForIntMap.value(projectId, 0);
@@ -90,7 +112,7 @@ SKRResult PLMProjectManager::saveProjectAs(int projectId,
 
     PLMExporter exporter(this);
 
-    IFOKDO(result, exporter.exportWholeSQLiteDbTo(project, type, path));
+    IFOKDO(result, exporter.exportWholeSQLiteDbTo(project, type, path, compact));
     IFOK(result) {
         // if it's a true save and not a copy :
         if (!isCopy) {
@@ -148,3 +170,28 @@ SKRResult PLMProjectManager::closeProject(int projectId)
 }
 
 // -----------------------------------------------------------------------------
+
+///
+/// \brief PLMProjectManager::workingMode
+/// \return
+/// read at each load, so the setting applies to the next opened projects
+/// without restarting
+PLMProject::WorkingMode PLMProjectManager::workingMode() const
+{
+    QSettings settings;
+
+    return settings.value("save/walMode", false).toBool() ? PLMProject::WalMode : PLMProject::MemoryJournalMode;
+}
+
+// -----------------------------------------------------------------------------
+
+///
+/// \brief PLMProjectManager::setWorkingMode
+/// \param workingMode
+/// only for the projects loaded afterwards, same setting as the settings page
+void PLMProjectManager::setWorkingMode(PLMProject::WorkingMode workingMode)
+{
+    QSettings settings;
+
+    settings.setValue("save/walMode", workingMode == PLMProject::WalMode);
+}
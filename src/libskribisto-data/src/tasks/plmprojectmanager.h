@@ -31,13 +31,25 @@ public:
     SKRResult saveProjectAs(int            projectId,
                             const QString& type,
                             const QUrl   & path,
-                            bool           isCopy = false);
+                            bool           isCopy  = false,
+                            bool           compact = false);
+    SKRResult compactProject(int projectId);
     PLMProject* project(int projectId);
     QList<int>  projectIdList();
     SKRResult   closeProject(int projectId);
 
+    PLMProject::WorkingMode workingMode() const;
+    void                    setWorkingMode(PLMProject::WorkingMode workingMode);
+
 signals:
 
+    ///
+    /// \brief projectSaveFinished
+    /// emitted when a save deferred to the worker thread of a project is done
+    void projectSaveFinished(int              projectId,
+                             const QUrl     & path,
+                             const SKRResult& result);
+
 public slots:
 
 private:
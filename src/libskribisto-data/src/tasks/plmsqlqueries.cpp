@@ -27,12 +27,23 @@
 #include <QSqlField>
 #include <QRegularExpression>
 #include "sql/skrsqltools.h"
+#include "sql/skrsqlstatementcache.h"
+
+namespace {
+void registerDBType()
+{
+    // once, not for each query
+    static const int dbTypeId = qRegisterMetaType<PLMSqlQueries::DBType>("DBType");
+
+    Q_UNUSED(dbTypeId)
+}
+}
 
 PLMSqlQueries::PLMSqlQueries(int            projectId,
                              const QString& tableName) : m_projectId(projectId),
     m_tableName(tableName)
 {
-    qRegisterMetaType<DBType>("DBType");
+    registerDBType();
 
     PLMProject *project = plmProjectManager->project(m_projectId);
 
@@ -51,7 +62,7 @@ PLMSqlQueries::PLMSqlQueries(QSqlDatabase   sqlDB,
                              const QString& idName) :
     m_sqlDB(sqlDB), m_tableName(tableName), m_idName(idName)
 {
-    qRegisterMetaType<DBType>("DBType");
+    registerDBType();
 }
 
 void PLMSqlQueries::beginTransaction()
@@ -74,28 +85,29 @@ SKRResult PLMSqlQueries::get(int id, const QString& valueName, QVariant& out) co
     SKRResult result(this);
 
     {
-        QSqlQuery query(m_sqlDB);
         QString   queryStr = "SELECT " + valueName
                              + " FROM " + m_tableName +
                              " WHERE " + m_idName + " = :id"
         ;
-        query.prepare(queryStr);
-        query.bindValue(":id", id);
-        query.exec();
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
+        query->bindValue(":id", id);
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
 
-        while (query.next()) {
-            out = query.value(0);
+        while (query->next()) {
+            out = query->value(0);
         }
 
-        if (query.size() == 0) {
+        if (query->size() == 0) {
             result = SKRResult(SKRResult::Critical, this, "query.size() == 0");
         }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -108,7 +120,6 @@ SKRResult PLMSqlQueries::getMultipleValues(int id, const QStringList& valueList,
 
     {
         out.clear();
-        QSqlQuery query(m_sqlDB);
         QString   valuesStr;
 
         for (const QString& value : valueList) {
@@ -128,26 +139,28 @@ SKRResult PLMSqlQueries::getMultipleValues(int id, const QStringList& valueList,
                            + " FROM " + m_tableName +
                            " WHERE " + m_idName + " = :id"
         ;
-        query.prepare(queryStr);
-        query.bindValue(":id", id);
-        query.exec();
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
+        query->bindValue(":id", id);
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
 
 
-        while (query.next()) {
+        while (query->next()) {
             for (const QString& valueName : valueList) {
-                out.insert(valueName, query.value(valueName));
+                out.insert(valueName, query->value(valueName));
             }
         }
 
-        if (query.size() == 0) {
+        if (query->size() == 0) {
             result = SKRResult(SKRResult::Critical, this, "query.size() == 0");
         }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -159,27 +172,28 @@ SKRResult PLMSqlQueries::getSortedIds(QList<int>& out) const
 
     {
         out.clear();
-        QSqlQuery query(m_sqlDB);
         QString   queryStr = "SELECT " + m_idName
                              + " FROM " + m_tableName
                              + " ORDER BY l_sort_order"
         ;
-        query.prepare(queryStr);
-        query.exec();
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
 
-        while (query.next()) {
-            out.append(query.value(0).toInt());
+        while (query->next()) {
+            out.append(query->value(0).toInt());
         }
 
-        if (query.size() == 0) {
+        if (query->size() == 0) {
             result = SKRResult(SKRResult::Critical, this, "query.size() == 0");
         }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -191,26 +205,27 @@ SKRResult PLMSqlQueries::getIds(QList<int>& out) const
 
     {
         out.clear();
-        QSqlQuery query(m_sqlDB);
         QString   queryStr = "SELECT " + m_idName
                              + " FROM " + m_tableName
         ;
-        query.prepare(queryStr);
-        query.exec();
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
 
-        while (query.next()) {
-            out.append(query.value(0).toInt());
+        while (query->next()) {
+            out.append(query->value(0).toInt());
         }
 
-        if (query.size() == 0) {
+        if (query->size() == 0) {
             result = SKRResult(SKRResult::Critical, this, "query.size() == 0");
         }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -218,18 +233,18 @@ SKRResult PLMSqlQueries::getIds(QList<int>& out) const
 
 bool PLMSqlQueries::idExists(int id) const
 {
-    QSqlQuery query(m_sqlDB);
     QString   queryStr = "SELECT :id FROM " + m_tableName
     ;
 
-    query.prepare(queryStr);
-    query.bindValue(":id", id);
-    query.exec();
+    QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
+    query->bindValue(":id", id);
+    query->exec();
 
-    if (query.size() == 0) {
-        return false;
-    }
-    return true;
+    bool exists = query->size() != 0;
+
+    SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
+
+    return exists;
 }
 
 ///
@@ -253,7 +268,6 @@ SKRResult PLMSqlQueries::getValueByIds(const QString       & valueName,
 
     {
         out.clear();
-        QSqlQuery query(m_sqlDB);
         QString   whereStr;
         QString   wh = where;
 
@@ -262,7 +276,7 @@ SKRResult PLMSqlQueries::getValueByIds(const QString       & valueName,
                 wh = m_idName;
             }
 
-            auto rx = QRegularExpression("[><=]^");
+            static const QRegularExpression rx("[><=]^");
 
             if (!wh.contains(rx)) {
                 wh.append(" =");
@@ -275,27 +289,29 @@ SKRResult PLMSqlQueries::getValueByIds(const QString       & valueName,
         sorted ? sortedStr = " ORDER BY l_sort_order" : sortedStr = "";
         QString queryStr = "SELECT " + m_idName + " , " + valueName
                            + " FROM " + m_tableName + whereStr + sortedStr;
-        query.prepare(queryStr);
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
 
         if (!where.isEmpty()) {
-            query.bindValue(":whereValue", whereValue);
+            query->bindValue(":whereValue", whereValue);
         }
 
-        query.exec();
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
 
-        while (query.next()) {
-            out.insert(query.value(0).toInt(), query.value(1));
+        while (query->next()) {
+            out.insert(query->value(0).toInt(), query->value(1));
         }
 
-        if (query.size() == 0) {
+        if (query->size() == 0) {
             result = SKRResult(SKRResult::Critical, this, "query.size() == 0");
         }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -310,7 +326,6 @@ SKRResult PLMSqlQueries::getValueByIdsWhere(const QString                 & valu
 
     {
         out.clear();
-        QSqlQuery query(m_sqlDB);
         QHash<QString, QVariant> finalWhereHash;
         QString whereStr                           = " WHERE ";
         QHash<QString, QVariant>::const_iterator i = where.constBegin();
@@ -322,7 +337,7 @@ SKRResult PLMSqlQueries::getValueByIdsWhere(const QString                 & valu
                 wh = m_idName;
             }
 
-            auto rx         = QRegularExpression("\\s*[><=]{1,2}$");
+            static const QRegularExpression rx("\\s*[><=]{1,2}$");
             QString valueWh = wh;
 
             if (wh.contains(rx)) {
@@ -343,29 +358,91 @@ SKRResult PLMSqlQueries::getValueByIdsWhere(const QString                 & valu
         sorted ? sortedStr = " ORDER BY l_sort_order" : sortedStr = "";
         QString queryStr = "SELECT " + m_idName + " , " + valueName
                            + " FROM " + m_tableName + whereStr + sortedStr;
-        query.prepare(queryStr);
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
         i = finalWhereHash.constBegin();
 
         while (i != finalWhereHash.constEnd()) {
-            query.bindValue(":" + i.key(), i.value());
+            query->bindValue(":" + i.key(), i.value());
             ++i;
         }
 
-        query.exec();
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
 
-        while (query.next()) {
-            out.insert(query.value(0).toInt(), query.value(1));
+        while (query->next()) {
+            out.insert(query->value(0).toInt(), query->value(1));
         }
 
-        if (query.size() == 0) {
+        if (query->size() == 0) {
             result = SKRResult(SKRResult::Critical, this, "query.size() == 0");
         }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
+    }
+
+    return result;
+}
+
+///
+/// \brief PLMSqlQueries::getPivotedValues
+/// \param codeName column grouping the rows, like l_tree_code
+/// \param keyName column holding the keys, like t_name
+/// \param valueName column holding the values, like m_value
+/// \param keys only these keys are fetched
+/// \param out code -> key -> value
+/// \return
+/// One query for all the rows, instead of one per code and key. With
+/// duplicated keys, the last added row wins.
+SKRResult PLMSqlQueries::getPivotedValues(const QString                        & codeName,
+                                          const QString                        & keyName,
+                                          const QString                        & valueName,
+                                          const QStringList                    & keys,
+                                          QHash<int, QHash<QString, QVariant> >& out) const
+{
+    SKRResult result(this);
+
+    {
+        out.clear();
+
+        if (keys.isEmpty()) {
+            return result;
+        }
+
+        QStringList placeholderList;
+
+        for (int i = 0; i < keys.count(); i++) {
+            placeholderList << ":key" + QString::number(i);
+        }
+
+        QString queryStr = "SELECT " + codeName + ", " + keyName + ", " + valueName
+                           + " FROM " + m_tableName
+                           + " WHERE " + keyName + " IN (" + placeholderList.join(", ") + ")"
+                           + " ORDER BY " + m_idName
+        ;
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
+
+        for (int i = 0; i < keys.count(); i++) {
+            query->bindValue(placeholderList.at(i), keys.at(i));
+        }
+
+        query->exec();
+
+        if (query->lastError().isValid()) {
+            result = SKRResult(SKRResult::Critical, this, "sql_error");
+            result.addData("SQLError",   query->lastError().text());
+            result.addData("SQL string", queryStr);
+        }
+
+        while (query->next()) {
+            out[query->value(0).toInt()].insert(query->value(1).toString(), query->value(2));
+        }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -377,7 +454,6 @@ bool PLMSqlQueries::resultExists(const QHash<QString, QVariant>& where) const
     bool value;
 
     {
-        QSqlQuery query(m_sqlDB);
         QString   whereStr                         = " WHERE ";
         QHash<QString, QVariant>::const_iterator i = where.constBegin();
 
@@ -395,29 +471,31 @@ bool PLMSqlQueries::resultExists(const QHash<QString, QVariant>& where) const
 
         QString queryStr = "SELECT " + m_idName
                            + " FROM " + m_tableName + whereStr;
-        query.prepare(queryStr);
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
         i = where.constBegin();
 
         while (i != where.constEnd()) {
-            query.bindValue(":" + i.key(), i.value());
+            query->bindValue(":" + i.key(), i.value());
             ++i;
         }
 
-        query.exec();
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
 
         QHash<int, QVariant> out;
 
-        while (query.next()) {
-            out.insert(query.value(0).toInt(), query.value(1));
+        while (query->next()) {
+            out.insert(query->value(0).toInt(), query->value(1));
         }
 
         out.size() > 0 ? value = true : value = false;
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return value;
@@ -428,7 +506,6 @@ SKRResult PLMSqlQueries::add(const QHash<QString, QVariant>& values, int& newId)
     SKRResult result(this);
 
     {
-        QSqlQuery   query(m_sqlDB);
         QStringList valueNamesStrList;
         QString     valueNamesStr                  = "(";
         QString     valuesStr                      = " VALUES (:";
@@ -449,23 +526,25 @@ SKRResult PLMSqlQueries::add(const QHash<QString, QVariant>& values, int& newId)
 
         QString queryStr = "INSERT INTO " + m_tableName + " "
                            + valueNamesStr + valuesStr;
-        query.prepare(queryStr);
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
         i = values.constBegin();
 
         while (i != values.constEnd()) {
-            query.bindValue(":" + i.key(), i.value());
+            query->bindValue(":" + i.key(), i.value());
             ++i;
         }
 
-        query.exec();
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
 
-        newId = query.lastInsertId().toInt();
+        newId = query->lastInsertId().toInt();
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -496,19 +575,20 @@ SKRResult PLMSqlQueries::remove(int id) const
     SKRResult result(this);
 
     {
-        QSqlQuery query(m_sqlDB);
         QString   queryStr = "DELETE FROM " + m_tableName
                              + " WHERE " + m_idName + " = :id"
         ;
-        query.prepare(queryStr);
-        query.bindValue(":id", id);
-        query.exec();
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
+        query->bindValue(":id", id);
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -519,21 +599,22 @@ SKRResult PLMSqlQueries::set(int id, const QString& valueName, const QVariant& v
     SKRResult result(this);
 
     {
-        QSqlQuery query(m_sqlDB);
         QString   queryStr = "UPDATE " + m_tableName
                              + " SET " + valueName + " = :value"
                                                      " WHERE " + m_idName + " = :id"
         ;
-        query.prepare(queryStr);
-        query.bindValue(":id",    id);
-        query.bindValue(":value", value);
-        query.exec();
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
+        query->bindValue(":id",    id);
+        query->bindValue(":value", value);
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -544,21 +625,22 @@ SKRResult PLMSqlQueries::setId(int id, int newId) const
     SKRResult result(this);
 
     {
-        QSqlQuery query(m_sqlDB);
         QString   queryStr = "UPDATE " + m_tableName
                              + " SET " + m_idName + " = :value"
                                                     " WHERE " + m_idName + " = :id"
         ;
-        query.prepare(queryStr);
-        query.bindValue(":id",    id);
-        query.bindValue(":value", newId);
-        query.exec();
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
+        query->bindValue(":id",    id);
+        query->bindValue(":value", newId);
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -609,20 +691,21 @@ SKRResult PLMSqlQueries::setCurrentDate(int id, const QString& valueName) const
     SKRResult result(this);
 
     {
-        QSqlQuery query(m_sqlDB);
         QString   queryStr = "UPDATE " + m_tableName
                              + " SET " + valueName + " = CURRENT_TIMESTAMP"
                                                      " WHERE " + m_idName + " = :id"
         ;
-        query.prepare(queryStr);
-        query.bindValue(":id", id);
-        query.exec();
+        QSqlQuery *query = SKRSqlStatementCache::acquire(m_sqlDB, queryStr);
+        query->bindValue(":id", id);
+        query->exec();
 
-        if (query.lastError().isValid()) {
+        if (query->lastError().isValid()) {
             result = SKRResult(SKRResult::Critical, this, "sql_error");
-            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQLError",   query->lastError().text());
             result.addData("SQL string", queryStr);
         }
+
+        SKRSqlStatementCache::release(m_sqlDB, queryStr, query);
     }
 
     return result;
@@ -630,43 +713,11 @@ SKRResult PLMSqlQueries::setCurrentDate(int id, const QString& valueName) const
 
 SKRResult PLMSqlQueries::renumberSortOrder()
 {
-    SKRResult result(this);
-    int renumInterval = 1000;
-
-    // Renumber all non-trashed paper in this version. DOES NOT COMMIT - Caller
-    // should
-    QSqlQuery query(m_sqlDB);
-    QString   queryStr = "SELECT " + m_idName
-                         + " FROM " + m_tableName
-                         + " ORDER BY l_sort_order"
-    ;
-
-    /*bool prepareOk = */ query.prepare(queryStr);
-
-    //    qDebug() << "prepareOk" << prepareOk;
-    //    qDebug() << query.lastError().text();
-    query.exec();
-
-    if (query.lastError().isValid()) {
-        result = SKRResult(SKRResult::Critical, this, "sql_error");
-        result.addData("SQLError",   query.lastError().text());
-        result.addData("SQL string", queryStr);
-    }
-
-    //    qDebug() << query.lastError().text();
-
-    int dest = 0;
-    QList<int> list;
-
-    while (query.next()) {
-        list.append(query.value(0).toInt());
-    }
+    // DOES NOT COMMIT - Caller should
+    SKRResult result = SKRSqlTools::renumberSortOrder(m_sqlDB, m_tableName, m_idName);
 
-    for (int& id : list) {
-        // For each note to renumber, pass it to the renum function.. For speed
-        // we commit after all rows renumbered
-        IFOKDO(result, set(id, "l_sort_order", dest));
-        dest += renumInterval;
+    IFKO(result) {
+        result.addData("table", m_tableName);
     }
 
     return result;
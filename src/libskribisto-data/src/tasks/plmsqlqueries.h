@@ -61,6 +61,11 @@ public:
                                  QHash<int, QVariant>          & out,
                                  const QHash<QString, QVariant>& where,
                                  bool                            sorted = false) const;
+    SKRResult getPivotedValues(const QString                        & codeName,
+                               const QString                        & keyName,
+                               const QString                        & valueName,
+                               const QStringList                    & keys,
+                               QHash<int, QHash<QString, QVariant> >& out) const;
     SKRResult set(int             id,
                   const QString & valueName,
                   const QVariant& value) const;
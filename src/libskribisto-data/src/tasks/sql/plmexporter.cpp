@@ -20,13 +20,27 @@
 ***************************************************************************/
 #include "plmexporter.h"
 #include "skrresult.h"
+#include <QSaveFile>
+#include <QElapsedTimer>
+#include <QSqlError>
 
 PLMExporter::PLMExporter(QObject *parent) : QObject(parent)
 {}
 
+///
+/// \brief PLMExporter::exportWholeSQLiteDbTo
+/// \param db
+/// \param type
+/// \param fileName
+/// \param compact run VACUUM before, only for an explicit compaction
+/// \return
+/// The temporary database is copied into the destination, see copyDatabaseFile.
+/// Duration and written bytes are added to the result. In WAL mode, the copy is
+/// only requested and "deferred" is added, the project emits saveFinished.
 SKRResult PLMExporter::exportWholeSQLiteDbTo(PLMProject    *db,
                                              const QString& type,
-                                             const QUrl   & fileName)
+                                             const QUrl   & fileName,
+                                             bool           compact)
 {
     SKRResult result(this);
     QString   finalType = type;
@@ -36,38 +50,124 @@ SKRResult PLMExporter::exportWholeSQLiteDbTo(PLMProject    *db,
     }
 
     if (finalType == "SQLITE") {
+        QElapsedTimer timer;
+        timer.start();
+
         // shrink the database
-        db->getSqlDb().transaction();
-        QString   queryStr("VACUUM");
-        QSqlQuery query(db->getSqlDb());
-        query.prepare(queryStr);
-        query.exec();
-        db->getSqlDb().commit();
-        QString databaseTempFileName =  db->getTempFileName();
-
-        // copy db temp to file
-        QFile tempFile(databaseTempFileName);
-        QFile file(fileName.toLocalFile());
-
-        if (!tempFile.open(QIODevice::ReadOnly)) {
-            result = SKRResult(SKRResult::Critical, this, "tempfile_cant_be_opened");
-            result.addData("fileName", fileName.toLocalFile());
+        if (compact) {
+            IFOKDO(result, this->compactSQLiteDb(db));
+            IFKO(result) {
+                return result;
+            }
+        }
+
+        // in WAL mode, the worker thread of the project checkpoints and copies
+        if (db->getWorkingMode() == PLMProject::WalMode) {
+            db->requestSave(fileName);
+            result.addData("deferred", true);
             return result;
         }
 
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-            result = SKRResult(SKRResult::Warning, this, "path_is_readonly");
+        IFOKDO(result, PLMExporter::copyDatabaseFile(db->getTempFileName(), fileName));
+        IFOK(result) {
+            result.addData("elapsedMs", timer.elapsed());
+        }
+
+        return result;
+    }
+
+    result = SKRResult(SKRResult::Critical, this, "unsupported_finalType");
+
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+
+///
+/// \brief PLMExporter::copyDatabaseFile
+/// \param databaseFileName
+/// \param fileName
+/// \return
+/// The database is streamed in bounded chunks into a QSaveFile, which replaces
+/// the destination by an atomic rename only when everything was written. A copy
+/// of a database in WAL mode is marked back as a rollback journal database : its
+/// WAL is already checkpointed and isn't copied. Thread-safe.
+SKRResult PLMExporter::copyDatabaseFile(const QString& databaseFileName, const QUrl& fileName)
+{
+    SKRResult result("PLMExporter");
+
+    QFile     tempFile(databaseFileName);
+    QSaveFile file(fileName.toLocalFile());
+
+    if (!tempFile.open(QIODevice::ReadOnly)) {
+        result = SKRResult(SKRResult::Critical, "PLMExporter", "tempfile_cant_be_opened");
+        result.addData("fileName", fileName.toLocalFile());
+        return result;
+    }
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        result = SKRResult(SKRResult::Warning, "PLMExporter", "path_is_readonly");
+        result.addData("fileName", fileName.toLocalFile());
+        return result;
+    }
+
+    const qint64 chunkSize = 1024 * 1024;
+    QByteArray   chunk;
+    qint64 bytesWritten = 0;
+
+    while (!tempFile.atEnd()) {
+        chunk = tempFile.read(chunkSize);
+
+        // file format write and read versions of the header, 2 for WAL
+        if ((bytesWritten == 0) && (chunk.size() > 19) && (chunk.at(18) == 2)) {
+            chunk[18] = 1;
+            chunk[19] = 1;
+        }
+
+        if (chunk.isEmpty() || (file.write(chunk) != chunk.size())) {
+            file.cancelWriting();
+            result = SKRResult(SKRResult::Critical, "PLMExporter", "write_failed");
             result.addData("fileName", fileName.toLocalFile());
             return result;
         }
+        bytesWritten += chunk.size();
+    }
 
-        QByteArray array(tempFile.readAll());
-        file.write(array);
-        file.close();
+    tempFile.close();
+
+    if (!file.commit()) {
+        result = SKRResult(SKRResult::Critical, "PLMExporter", "commit_failed");
+        result.addData("fileName", fileName.toLocalFile());
         return result;
     }
 
-    result = SKRResult(SKRResult::Critical, this, "unsupported_finalType");
+    result.addData("bytesWritten", bytesWritten);
+
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+
+///
+/// \brief PLMExporter::compactSQLiteDb
+/// \param db
+/// \return
+/// VACUUM rewrites the whole database, so it is kept out of the usual saves.
+/// It can't run inside a transaction.
+SKRResult PLMExporter::compactSQLiteDb(PLMProject *db)
+{
+    SKRResult result(this);
+    QString   queryStr("VACUUM");
+    QSqlQuery query(db->getSqlDb());
+
+    query.prepare(queryStr);
+    query.exec();
+
+    if (query.lastError().isValid()) {
+        result = SKRResult(SKRResult::Critical, this, "sql_error");
+        result.addData("SQLError",   query.lastError().text());
+        result.addData("SQL string", queryStr);
+    }
 
     return result;
 }
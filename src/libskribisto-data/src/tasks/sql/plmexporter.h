@@ -41,7 +41,12 @@ public:
     explicit PLMExporter(QObject *parent = 0);
     SKRResult exportWholeSQLiteDbTo(PLMProject    *db,
                                     const QString& type,
-                                    const QUrl   & fileName);
+                                    const QUrl   & fileName,
+                                    bool           compact = false);
+    SKRResult compactSQLiteDb(PLMProject *db);
+
+    static SKRResult copyDatabaseFile(const QString& databaseFileName,
+                                      const QUrl   & fileName);
 
 signals:
 
@@ -24,6 +24,7 @@
 #include "tasks/plmsqlqueries.h"
 #include "plmdata.h"
 #include "skrsqltools.h"
+#include "skrsqlstatementcache.h"
 
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlRecord>
@@ -31,6 +32,7 @@
 #include <QTemporaryFile>
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
 #include <QProcess>
 #include <QByteArray>
 #include <QSqlDriver>
@@ -51,14 +53,24 @@ PLMImporter::PLMImporter(QObject *parent) :
 QSqlDatabase PLMImporter::createSQLiteDbFrom(const QString& type,
                                              const QUrl   & fileName,
                                              int            projectId,
-                                             SKRResult    & result)
+                                             SKRResult    & result,
+                                             PLMProject::WorkingMode workingMode)
 {
     if (type == "SQLITE") {
-        // create temp file
-        QTemporaryFile tempFile;
-        tempFile.open();
-        tempFile.setAutoRemove(false);
-        QString tempFileName = tempFile.fileName();
+        // in WAL mode, the working copy is kept next to the project to survive a crash
+        QString tempFileName;
+
+        if (workingMode == PLMProject::WalMode) {
+            tempFileName = PLMProject::workingCopyFileName(fileName);
+        }
+
+        // else, or if another instance uses it, create temp file
+        if (tempFileName.isEmpty() || QFileInfo::exists(tempFileName)) {
+            QTemporaryFile tempFile;
+            tempFile.open();
+            tempFile.setAutoRemove(false);
+            tempFileName = tempFile.fileName();
+        }
 
         // copy db file to temp
         QString fileNameString;
@@ -87,11 +99,31 @@ QSqlDatabase PLMImporter::createSQLiteDbFrom(const QString& type,
             return QSqlDatabase();
         }
 
-        QByteArray array(file.readAll());
-        tempFile.write(array);
-        tempFile.close();
+        // local files are copied by Qt, which clones them (reflink) when the
+        // file system allows it
+        bool copied = false;
+
+        if (fileName.scheme() != "qrc") {
+            file.close();
+            copied = (!QFile::exists(tempFileName) || QFile::remove(tempFileName)) &&
+                     QFile::copy(fileNameString, tempFileName);
+
+            if (copied) {
+                // the copy keeps the permissions of a possibly read-only original
+                QFile::setPermissions(tempFileName, QFile::ReadOwner | QFile::WriteOwner);
+            }
+        }
+
+        // else copy in bounded chunks, never the whole file in memory
+        if (!copied) {
+            IFOKDO(result, this->copyFileInChunks(fileNameString, tempFileName));
+            IFKO(result) {
+                return QSqlDatabase();
+            }
+        }
 
         // open temp file
+        SKRSqlStatementCache::clear(QString::number(projectId));
         QSqlDatabase sqlDb =
             QSqlDatabase::addDatabase("QSQLITE", QString::number(projectId));
         sqlDb.setHostName("localhost");
@@ -111,13 +143,8 @@ QSqlDatabase PLMImporter::createSQLiteDbFrom(const QString& type,
         }
 
         // optimization :
-        QStringList optimization;
-        optimization << QStringLiteral("PRAGMA case_sensitive_like=true")
-                     << QStringLiteral("PRAGMA journal_mode=MEMORY")
-                     << QStringLiteral("PRAGMA temp_store=MEMORY")
-                     << QStringLiteral("PRAGMA locking_mode=EXCLUSIVE")
-                     << QStringLiteral("PRAGMA synchronous = OFF")
-                     << QStringLiteral("PRAGMA recursive_triggers=true");
+        this->setJournalMode(sqlDb, workingMode);
+        QStringList optimization = this->optimizationPragmas(workingMode);
         sqlDb.transaction();
 
         // upgrade :
@@ -151,7 +178,103 @@ QSqlDatabase PLMImporter::createSQLiteDbFrom(const QString& type,
 
 // -----------------------------------------------------------------------------------------------
 
-QSqlDatabase PLMImporter::createEmptySQLiteProject(int projectId, SKRResult& result, const QString& sqlFile)
+SKRResult PLMImporter::copyFileInChunks(const QString& sourceFileName, const QString& destinationFileName)
+{
+    SKRResult result(this);
+    QFile     source(sourceFileName);
+    QFile     destination(destinationFileName);
+
+    if (!source.open(QIODevice::ReadOnly)) {
+        result = SKRResult(SKRResult::Critical, this, "file_cant_be_opened");
+        result.addData("filePath", sourceFileName);
+        return result;
+    }
+
+    if (!destination.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        result = SKRResult(SKRResult::Critical, this, "tempfile_cant_be_opened");
+        result.addData("filePath", destinationFileName);
+        return result;
+    }
+
+    const qint64 chunkSize = 1024 * 1024;
+    QByteArray   chunk;
+
+    while (!source.atEnd()) {
+        chunk = source.read(chunkSize);
+
+        if (chunk.isEmpty() || (destination.write(chunk) != chunk.size())) {
+            result = SKRResult(SKRResult::Critical, this, "copy_failed");
+            result.addData("filePath", destinationFileName);
+            return result;
+        }
+    }
+
+    destination.close();
+    source.close();
+
+    return result;
+}
+
+// -----------------------------------------------------------------------------------------------
+
+///
+/// \brief PLMImporter::setJournalMode
+/// \param sqlDb
+/// \param workingMode
+/// The WAL can't be enabled inside a transaction, so it's done apart, right
+/// after opening. The main connection never checkpoints by itself, the worker
+/// thread of the project does it.
+void PLMImporter::setJournalMode(QSqlDatabase& sqlDb, PLMProject::WorkingMode workingMode)
+{
+    if (workingMode != PLMProject::WalMode) {
+        return;
+    }
+
+    const QStringList pragmas({ QStringLiteral("PRAGMA journal_mode=WAL"),
+                                QStringLiteral("PRAGMA wal_autocheckpoint=0") });
+
+    for (const QString& string : pragmas) {
+        QSqlQuery query(sqlDb);
+
+        query.prepare(string);
+        query.exec();
+    }
+}
+
+// -----------------------------------------------------------------------------------------------
+
+///
+/// \brief PLMImporter::optimizationPragmas
+/// \param workingMode
+/// \return
+/// In WAL mode, a commit synced at checkpoints only is still never corrupted,
+/// and the locking stays normal for the connection of the worker thread.
+QStringList PLMImporter::optimizationPragmas(PLMProject::WorkingMode workingMode) const
+{
+    QStringList optimization;
+
+    if (workingMode == PLMProject::WalMode) {
+        optimization << QStringLiteral("PRAGMA case_sensitive_like=true")
+                     << QStringLiteral("PRAGMA temp_store=MEMORY")
+                     << QStringLiteral("PRAGMA synchronous = NORMAL")
+                     << QStringLiteral("PRAGMA recursive_triggers=true");
+        return optimization;
+    }
+
+    optimization << QStringLiteral("PRAGMA case_sensitive_like=true")
+                 << QStringLiteral("PRAGMA journal_mode=MEMORY")
+                 << QStringLiteral("PRAGMA temp_store=MEMORY")
+                 << QStringLiteral("PRAGMA locking_mode=EXCLUSIVE")
+                 << QStringLiteral("PRAGMA synchronous = OFF")
+                 << QStringLiteral("PRAGMA recursive_triggers=true");
+
+    return optimization;
+}
+
+// -----------------------------------------------------------------------------------------------
+
+QSqlDatabase PLMImporter::createEmptySQLiteProject(int projectId, SKRResult& result, const QString& sqlFile,
+                                                   PLMProject::WorkingMode workingMode)
 {
     bool isSpecificSqlFile = true;
 
@@ -170,6 +293,7 @@ QSqlDatabase PLMImporter::createEmptySQLiteProject(int projectId, SKRResult& res
 
     // open temp file
 
+    SKRSqlStatementCache::clear(QString::number(projectId));
     QSqlDatabase sqlDb = QSqlDatabase::addDatabase("QSQLITE", QString::number(projectId));
 
     sqlDb.setHostName("localhost");
@@ -184,14 +308,9 @@ QSqlDatabase PLMImporter::createEmptySQLiteProject(int projectId, SKRResult& res
 
 
     // optimization :
-    QStringList optimization;
+    this->setJournalMode(sqlDb, workingMode);
+    QStringList optimization = this->optimizationPragmas(workingMode);
 
-    optimization << QStringLiteral("PRAGMA case_sensitive_like=true")
-                 << QStringLiteral("PRAGMA journal_mode=MEMORY")
-                 << QStringLiteral("PRAGMA temp_store=MEMORY")
-                 << QStringLiteral("PRAGMA locking_mode=EXCLUSIVE")
-                 << QStringLiteral("PRAGMA synchronous = OFF")
-                 << QStringLiteral("PRAGMA recursive_triggers=true");
     sqlDb.transaction();
 
     for (const QString& string : qAsConst(optimization)) {
@@ -389,6 +508,8 @@ SKRResult PLMImporter::importPlumeCreatorProject(const QUrl& plumeFileName, cons
 
     m_attendanceConversionHash.clear();
 
+    QList<ImportedItem> attendItems;
+
 
     while (attendXml.readNextStartElement() && attendXml.name().toString() == "plume-attendance") {
         QStringList rolesNames  = attendXml.attributes().value("rolesNames").toString().split("--", Qt::SkipEmptyParts);
@@ -406,38 +527,32 @@ SKRResult PLMImporter::importPlumeCreatorProject(const QUrl& plumeFileName, cons
         while (attendXml.readNextStartElement() && attendXml.name().toString() == "group") {
             int attendNumber  = attendXml.attributes().value("number").toInt();
             QString groupName = attendXml.attributes().value("name").toString();
-            result = this->createNote(projectId, 1, attendNumber, groupName, tempDirPath + "/attend/A", attendFolderId);
+            ImportedItem groupItem;
+            result = this->readNote(1, attendNumber, groupName, tempDirPath + "/attend/A", &groupItem);
             IFOK(result) {
-                int groupNoteId = result.getData("treeItemId", -2).toInt();
-
-                m_attendanceConversionHash.insert(attendNumber, groupNoteId);
-
-                result = this->createTagsFromAttend(projectId, groupNoteId, attendXml, "box_1", box_1Names);
-                result = this->createTagsFromAttend(projectId, groupNoteId, attendXml, "box_2", box_2Names);
-                result = this->createTagsFromAttend(projectId, groupNoteId, attendXml, "box_3", box_3Names);
-                result = this->createTagsFromAttend(projectId, groupNoteId, attendXml, "spinBox_1", spinBox_1Names);
+                groupItem.tagNames << this->readTagFromAttend(attendXml, "box_1", box_1Names)
+                                   << this->readTagFromAttend(attendXml, "box_2", box_2Names)
+                                   << this->readTagFromAttend(attendXml, "box_3", box_3Names)
+                                   << this->readTagFromAttend(attendXml, "spinBox_1", spinBox_1Names);
+                attendItems.append(groupItem);
             }
 
 
             while (attendXml.readNextStartElement() && attendXml.name().toString() == "obj") {
                 int attendNumber = attendXml.attributes().value("number").toInt();
                 QString objName  = attendXml.attributes().value("name").toString();
-                result =
-                    this->createNote(projectId, 2, attendNumber, objName, tempDirPath + "/attend/A", attendFolderId);
+                ImportedItem objItem;
+                result = this->readNote(2, attendNumber, objName, tempDirPath + "/attend/A", &objItem);
                 IFOK(result) {
-                    int objNoteId = result.getData("treeItemId", -2).toInt();
-
-                    m_attendanceConversionHash.insert(attendNumber, objNoteId);
-
-
-                    result = this->createTagsFromAttend(projectId, objNoteId, attendXml, "box_1", box_1Names);
-                    result = this->createTagsFromAttend(projectId, objNoteId, attendXml, "box_2", box_2Names);
-                    result = this->createTagsFromAttend(projectId, objNoteId, attendXml, "box_3", box_3Names);
-                    result = this->createTagsFromAttend(projectId, objNoteId, attendXml, "spinBox_1", spinBox_1Names);
+                    objItem.tagNames << this->readTagFromAttend(attendXml, "box_1", box_1Names)
+                                     << this->readTagFromAttend(attendXml, "box_2", box_2Names)
+                                     << this->readTagFromAttend(attendXml, "box_3", box_3Names)
+                                     << this->readTagFromAttend(attendXml, "spinBox_1", spinBox_1Names);
 
                     QString objQuickDetail = attendXml.attributes().value("quickDetails").toString();
 
-                    plmdata->treePropertyHub()->setProperty(projectId, objNoteId, "label", objQuickDetail);
+                    objItem.properties.insert("label", objQuickDetail);
+                    attendItems.append(objItem);
                 }
 
                 attendXml.readElementText();
@@ -445,6 +560,39 @@ SKRResult PLMImporter::importPlumeCreatorProject(const QUrl& plumeFileName, cons
         }
     }
 
+    // all the attendance at once
+
+    QList<int> attendIds;
+
+    result = this->createItems(projectId, attendFolderId, attendItems, &attendIds);
+    IFKO(result) {
+        result = SKRResult(SKRResult::Critical, this, "note_creation");
+        return result;
+    }
+
+    for (int i = 0; i < attendIds.count(); i++) {
+        const ImportedItem& attendItem = attendItems.at(i);
+        int attendNoteId               = attendIds.at(i);
+
+        m_attendanceConversionHash.insert(attendItem.plumeId, attendNoteId);
+
+        for (const QString& tagName : attendItem.tagNames) {
+            SKRResult tagResult = plmdata->tagHub()->addTag(projectId, tagName);
+            IFOK(tagResult) {
+                plmdata->tagHub()->setTagRelationship(projectId,
+                                                      attendNoteId,
+                                                      tagResult.getData("tagId", -2).toInt());
+            }
+        }
+
+        QHash<QString, QString>::const_iterator it = attendItem.properties.constBegin();
+
+        while (it != attendItem.properties.constEnd()) {
+            plmdata->treePropertyHub()->setProperty(projectId, attendNoteId, it.key(), it.value());
+            ++it;
+        }
+    }
+
 
     // ----------------------------- read
     // tree---------------------------------------
@@ -472,6 +620,10 @@ SKRResult PLMImporter::importPlumeCreatorProject(const QUrl& plumeFileName, cons
 
     QXmlStreamReader xml(lines);
 
+    // one note for each sheet
+    QList<ImportedItem> sheetItems;
+    QList<ImportedItem> noteItems;
+
 
     while (xml.readNextStartElement() && xml.name().toString() == "plume-tree") {
         // pick project name
@@ -487,8 +639,7 @@ SKRResult PLMImporter::importPlumeCreatorProject(const QUrl& plumeFileName, cons
 
             if (xml.name().toString() == "book") {
                 IFOKDO(result,
-                       this->readXMLRecursivelyAndCreatePaper(projectId, 1, &xml, tempDirPath, textFolderId,
-                                                              noteFolderId));
+                       this->readXMLRecursively(1, &xml, tempDirPath, &sheetItems, &noteItems));
             }
         }
 
@@ -511,6 +662,41 @@ SKRResult PLMImporter::importPlumeCreatorProject(const QUrl& plumeFileName, cons
         return result;
     }
 
+    // all the texts and their notes at once
+
+    QList<int> sheetIds;
+    QList<int> noteIds;
+
+    result = this->createItems(projectId, textFolderId, sheetItems, &sheetIds);
+    IFKO(result) {
+        result = SKRResult(SKRResult::Critical, this, "text_creation");
+        return result;
+    }
+
+    result = this->createItems(projectId, noteFolderId, noteItems, &noteIds);
+    IFKO(result) {
+        result = SKRResult(SKRResult::Critical, this, "note_creation");
+        return result;
+    }
+
+    for (int i = 0; i < sheetIds.count(); i++) {
+        int sheetId = sheetIds.at(i);
+
+        IFOKDO(result, plmdata->treeHub()->setTreeRelationship(projectId, noteIds.at(i), sheetId));
+
+        // associate "attendance" notes
+        for (int attendId : sheetItems.at(i).attendIds) {
+            int skrNoteId = m_attendanceConversionHash.value(attendId);
+
+            // associate :
+            result = plmdata->treeHub()->setTreeRelationship(projectId, skrNoteId, sheetId);
+        }
+
+        IFKO(result) {
+            return result;
+        }
+    }
+
 
     // ----------------------------- user dict------
     // -----------------------------
@@ -709,11 +895,17 @@ SKRResult PLMImporter::transformParentsToFolder(int projectId) {
 
 // -----------------------------------------------------------
 
-SKRResult PLMImporter::readXMLRecursivelyAndCreatePaper(int projectId,
-                                                        int indent,
-                                                        QXmlStreamReader *xml,
-                                                        const QString& tempDirPath,
-                                                        int textFolderId, int noteFolderId)
+///
+/// \brief PLMImporter::readXMLRecursively
+/// \param indent
+/// \param xml
+/// \param tempDirPath
+/// \param sheetItems the texts, filled in tree order
+/// \param noteItems the note of each text, at the same index
+/// \return
+/// Only reads the project, the items are created afterwards in one go.
+SKRResult PLMImporter::readXMLRecursively(int indent, QXmlStreamReader *xml, const QString& tempDirPath,
+                                          QList<ImportedItem> *sheetItems, QList<ImportedItem> *noteItems)
 {
     SKRResult result;
 
@@ -726,11 +918,8 @@ SKRResult PLMImporter::readXMLRecursivelyAndCreatePaper(int projectId,
             xml->skipCurrentElement();
         }
         else {
-            IFOKDO(result,
-                   this->createPapersAndAssociations(projectId, indent, *xml, tempDirPath, textFolderId, noteFolderId));
-            IFOKDO(result,
-                   readXMLRecursivelyAndCreatePaper(projectId, indent + 1, xml, tempDirPath, textFolderId,
-                                                    noteFolderId));
+            IFOKDO(result, this->readPaperAndNote(indent, *xml, tempDirPath, sheetItems, noteItems));
+            IFOKDO(result, readXMLRecursively(indent + 1, xml, tempDirPath, sheetItems, noteItems));
         }
     }
 
@@ -739,40 +928,32 @@ SKRResult PLMImporter::readXMLRecursivelyAndCreatePaper(int projectId,
             xml->skipCurrentElement();
             continue;
         }
-        IFOKDO(result,
-               this->createPapersAndAssociations(projectId, indent, *xml, tempDirPath, textFolderId, noteFolderId));
-        IFOKDO(result,
-               readXMLRecursivelyAndCreatePaper(projectId, indent + 1, xml, tempDirPath, textFolderId, noteFolderId));
+        IFOKDO(result, this->readPaperAndNote(indent, *xml, tempDirPath, sheetItems, noteItems));
+        IFOKDO(result, readXMLRecursively(indent + 1, xml, tempDirPath, sheetItems, noteItems));
     }
 
     return result;
 }
 
-SKRResult PLMImporter::createPapersAndAssociations(int projectId,
-                                                   int indent,
-                                                   const QXmlStreamReader& xml,
-                                                   const QString& tempDirPath,
-                                                   int textFolderId, int noteFolderId)
+// -----------------------------------------------------------------------------------------------
+
+SKRResult PLMImporter::readPaperAndNote(int                     indent,
+                                        const QXmlStreamReader& xml,
+                                        const QString         & tempDirPath,
+                                        QList<ImportedItem>    *sheetItems,
+                                        QList<ImportedItem>    *noteItems)
 {
     SKRResult result(this);
 
     int plumeId  = xml.attributes().value("number").toInt();
     QString name = xml.attributes().value("name").toString();
 
-    // create sheet
-
-    result = plmdata->treeHub()->addChildTreeItem(projectId, textFolderId, "TEXT");
-    IFKO(result) {
-        result = SKRResult(SKRResult::Critical, this, "text_creation");
-        return result;
-    }
-    int sheetId = result.getData("treeItemId", -2).toInt();
-
-    int textFolderIndent = plmdata->treeHub()->getIndent(projectId, textFolderId);
+    ImportedItem sheetItem;
 
-    IFOKDO(result, plmdata->treeHub()->setIndent(projectId, sheetId, textFolderIndent + indent));
-    IFOKDO(result, plmdata->treeHub()->setTitle(projectId, sheetId, name));
-    IFOKDO(result, plmdata->treeHub()->setType(projectId, sheetId, "TEXT"));
+    sheetItem.plumeId = plumeId;
+    sheetItem.values.insert("l_indent", indent);
+    sheetItem.values.insert("t_title",  name);
+    sheetItem.values.insert("t_type",   "TEXT");
 
 
     // - fetch text
@@ -801,28 +982,13 @@ SKRResult PLMImporter::createPapersAndAssociations(int projectId,
 
     sheetDoc.setHtml(QString::fromUtf8(textLines));
 
-    IFOKDO(result, plmdata->treeHub()->setPrimaryContent(projectId, sheetId, sheetDoc.toMarkdown()));
-
-
-    IFKO(result) {
-        return result;
-    }
+    sheetItem.values.insert("m_primary_content", sheetDoc.toMarkdown());
 
     // create note
 
+    ImportedItem noteItem;
 
-    result = this->createNote(projectId, indent, plumeId, name, tempDirPath + "/text/N", noteFolderId);
-    bool ok;
-    int  noteId = result.getData("treeItemId", -2).toInt(&ok);
-
-    if (!ok) {
-        result = SKRResult(SKRResult::Critical, this, "bad_conversion_to_int");
-        return result;
-    }
-
-
-    result = plmdata->treeHub()->setTreeRelationship(projectId, noteId, sheetId);
-
+    result = this->readNote(indent, plumeId, name, tempDirPath + "/text/N", &noteItem);
 
     IFKO(result) {
         return result;
@@ -854,10 +1020,10 @@ SKRResult PLMImporter::createPapersAndAssociations(int projectId,
     QTextDocument synDoc;
 
     synDoc.setHtml(QString::fromUtf8(lines));
-    IFOKDO(result, plmdata->treeHub()->setSecondaryContent(projectId, sheetId, synDoc.toMarkdown()));
+    sheetItem.values.insert("m_secondary_content", synDoc.toMarkdown());
 
 
-    // associate "attendance" notes
+    // "attendance" notes to associate
 
     QStringList attendIds = xml.attributes().value("attend").toString().split("-", Qt::SkipEmptyParts);
 
@@ -868,41 +1034,26 @@ SKRResult PLMImporter::createPapersAndAssociations(int projectId,
             continue;
         }
 
-        int skrNoteId = m_attendanceConversionHash.value(attendId);
-
-        // associate :
-        result = plmdata->treeHub()->setTreeRelationship(projectId, skrNoteId, sheetId);
-    }
-
-    IFKO(result) {
-        return result;
+        sheetItem.attendIds.append(attendId);
     }
 
+    sheetItems->append(sheetItem);
+    noteItems->append(noteItem);
 
     return result;
 }
 
 // -----------------------------------------------------------------------------------------------
 
-SKRResult PLMImporter::createNote(int projectId, int indent, int plumeId, const QString& name,
-                                  const QString& tempDirPath, int parentFolderId)
+SKRResult PLMImporter::readNote(int indent, int plumeId, const QString& name,
+                                const QString& tempDirPath, ImportedItem *noteItem)
 {
     SKRResult result(this);
 
-
-    result = plmdata->treeHub()->addChildTreeItem(projectId, parentFolderId, "TEXT");
-    IFKO(result) {
-        result = SKRResult(SKRResult::Critical, this, "note_creation");
-        return result;
-    }
-    int noteId = result.getData("treeItemId", -2).toInt();
-
-
-    int parentFolderIndent = plmdata->treeHub()->getIndent(projectId, parentFolderId);
-
-    IFOKDO(result, plmdata->treeHub()->setIndent(projectId, noteId, parentFolderIndent + indent));
-    IFOKDO(result, plmdata->treeHub()->setTitle(projectId, noteId, name));
-    IFOKDO(result, plmdata->treeHub()->setType(projectId, noteId, "TEXT"));
+    noteItem->plumeId = plumeId;
+    noteItem->values.insert("l_indent", indent);
+    noteItem->values.insert("t_title",  name);
+    noteItem->values.insert("t_type",   "TEXT");
 
 
     // fetch text
@@ -930,7 +1081,7 @@ SKRResult PLMImporter::createNote(int projectId, int indent, int plumeId, const
     QTextDocument noteDoc;
 
     noteDoc.setHtml(QString::fromUtf8(lines));
-    IFOKDO(result, plmdata->treeHub()->setPrimaryContent(projectId, noteId, noteDoc.toMarkdown()));
+    noteItem->values.insert("m_primary_content", noteDoc.toMarkdown());
 
 
     return result;
@@ -938,42 +1089,55 @@ SKRResult PLMImporter::createNote(int projectId, int indent, int plumeId, const
 
 // -----------------------------------------------------------------------------------------------
 
-SKRResult PLMImporter::createTagsFromAttend(int                     projectId,
-                                            int                     noteId,
-                                            const QXmlStreamReader& xml,
-                                            const QString         & attributeName,
-                                            const QStringList     & values)
+///
+/// \brief PLMImporter::createItems
+/// \param projectId
+/// \param parentId
+/// \param items
+/// \param newIds filled with the ids of the items, in the same order
+/// \return
+/// One transaction and one model refresh for all the items.
+SKRResult PLMImporter::createItems(int projectId, int parentId, const QList<ImportedItem>& items,
+                                   QList<int> *newIds)
 {
-    SKRResult result(this);
+    QList<QHash<QString, QVariant> > valuesList;
 
-    if (values.isEmpty()) {
-        return result; // return successfully
+    for (const ImportedItem& item : items) {
+        valuesList.append(item.values);
     }
 
+    SKRResult result = plmdata->treeHub()->addTreeItems(projectId, parentId, valuesList);
 
-    bool ok;
-    int  index = xml.attributes().value(attributeName).toInt(&ok);
-
-    if (!ok) {
-        result = SKRResult(SKRResult::Critical, this, "conversion_to_int");
-        return result;
+    IFOK(result) {
+        *newIds = result.getData("treeItemIdList", QVariant()).value<QList<int> >();
     }
 
-    if (values.count() <= index) {
-        return result; // return successfully
+    return result;
+}
+
+// -----------------------------------------------------------------------------------------------
+
+QStringList PLMImporter::readTagFromAttend(const QXmlStreamReader& xml,
+                                           const QString         & attributeName,
+                                           const QStringList     & values)
+{
+    QStringList tagNames;
+
+    if (values.isEmpty()) {
+        return tagNames;
     }
 
 
-    IFOK(result) {
-        result = plmdata->tagHub()->addTag(projectId, values.at(index));
-        IFOK(result) {
-            result = plmdata->tagHub()->setTagRelationship(projectId,
-                                                           noteId,
-                                                           result.getData("tagId", -2).toInt());
-        }
+    bool ok;
+    int  index = xml.attributes().value(attributeName).toInt(&ok);
+
+    if (!ok || (index < 0) || (values.count() <= index)) {
+        return tagNames;
     }
 
-    return result;
+    tagNames.append(values.at(index));
+
+    return tagNames;
 }
 
 // QSqlDatabase PLMImporter::copySQLiteDbToMemory(QSqlDatabase sourceSqlDb, int
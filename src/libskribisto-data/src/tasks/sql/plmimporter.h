@@ -23,12 +23,16 @@
 #define PLMIMPORTER_H
 
 #include <QFile>
+#include <QHash>
+#include <QStringList>
+#include <QVariant>
 #include <QObject>
 #include <QtSql/QSqlDatabase>
 #include <QUrl>
 #include <QXmlStreamReader>
 
 #include "skrresult.h"
+#include "plmproject.h"
 
 class PLMImporter : public QObject {
     Q_OBJECT
@@ -40,10 +44,12 @@ public:
     QSqlDatabase createSQLiteDbFrom(const QString& type,
                                     const QUrl   & fileName,
                                     int            projectId,
-                                    SKRResult    & result);
+                                    SKRResult    & result,
+                                    PLMProject::WorkingMode workingMode = PLMProject::MemoryJournalMode);
     QSqlDatabase createEmptySQLiteProject(int            projectId,
                                           SKRResult    & result,
-                                          const QString& sqlFile = "");
+                                          const QString& sqlFile                 = "",
+                                          PLMProject::WorkingMode workingMode = PLMProject::MemoryJournalMode);
 
     SKRResult importPlumeCreatorProject(const QUrl& plumeFileName,
                                         const QUrl& skribistoFileName);
@@ -57,32 +63,45 @@ private:
     //    QSqlDatabase copySQLiteDbToMemory(QSqlDatabase sourceSqlDb, int
     // projectId, SKRResult &result);
     SKRResult transformParentsToFolder(int projectId);
-
-    SKRResult createPapersAndAssociations(int                     projectId,
-                                          int                     indent,
-                                          const QXmlStreamReader& xml,
-                                          const QString         & tempDirPath,
-                                          int                     textFolderId,
-                                          int                     noteFolderId);
-    SKRResult createNote(int            projectId,
-                         int            indent,
+    SKRResult copyFileInChunks(const QString& sourceFileName,
+                               const QString& destinationFileName);
+    void      setJournalMode(QSqlDatabase          & sqlDb,
+                             PLMProject::WorkingMode workingMode);
+    QStringList optimizationPragmas(PLMProject::WorkingMode workingMode) const;
+
+    // an item read from the Plume project, created later with the others
+    struct ImportedItem {
+        QHash<QString, QVariant>values; // tbl_tree values, "l_indent" relative to the folder
+        int                     plumeId = -1;
+        QStringList             tagNames;
+        QHash<QString, QString> properties;
+        QList<int>              attendIds;
+    };
+
+    SKRResult   readPaperAndNote(int                     indent,
+                                 const QXmlStreamReader& xml,
+                                 const QString         & tempDirPath,
+                                 QList<ImportedItem>    *sheetItems,
+                                 QList<ImportedItem>    *noteItems);
+    SKRResult   readNote(int            indent,
                          int            plumeId,
                          const QString& name,
                          const QString& tempDirPath,
-                         int            parentFolderId);
-
-    SKRResult createTagsFromAttend(int                     projectId,
-                                   int                     noteId,
-                                   const QXmlStreamReader& xml,
-                                   const QString         & attributeName,
-                                   const QStringList     & values);
-
-    SKRResult readXMLRecursivelyAndCreatePaper(int               projectId,
-                                               int               indent,
-                                               QXmlStreamReader *xml,
-                                               const QString   & tempDirPath,
-                                               int               textFolderId,
-                                               int               noteFolderId);
+                         ImportedItem  *noteItem);
+
+    QStringList readTagFromAttend(const QXmlStreamReader& xml,
+                                  const QString         & attributeName,
+                                  const QStringList     & values);
+
+    SKRResult   readXMLRecursively(int                  indent,
+                                   QXmlStreamReader    *xml,
+                                   const QString      & tempDirPath,
+                                   QList<ImportedItem> *sheetItems,
+                                   QList<ImportedItem> *noteItems);
+    SKRResult   createItems(int                        projectId,
+                            int                        parentId,
+                            const QList<ImportedItem>& items,
+                            QList<int>                *newIds);
 
 private:
 
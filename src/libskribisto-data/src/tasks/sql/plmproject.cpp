@@ -23,6 +23,8 @@
 #include "plmimporter.h"
 #include "plmexporter.h"
 #include "skrsqltools.h"
+#include "skrsqlstatementcache.h"
+#include "skrwalcheckpointer.h"
 #include <QtSql/QSqlError>
 #include <QDebug>
 #include <QString>
@@ -30,12 +32,16 @@
 #include <QSqlRecord>
 #include <QSqlField>
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
 #include <QFileInfo>
 #include <QTimer>
+#include <QThread>
+#include <QSqlQuery>
 
 PLMProject::PLMProject(QObject *parent, int projectId, const QUrl& fileName, SKRResult *result,
-                       const QString& sqlFile) :
-    QObject(parent)
+                       const QString& sqlFile, WorkingMode workingMode) :
+    QObject(parent), m_workingMode(workingMode), m_checkpointThread(nullptr), m_checkpointer(nullptr)
 {
     qRegisterMetaType<PLMProject::DBType>("PLMProject::DBType");
     m_projectId = projectId;
@@ -60,6 +66,11 @@ PLMProject::PLMProject(QObject *parent, int projectId, const QUrl& fileName, SKR
         }
 
         IFOKDO(*result, setPath(fileName))
+
+        // whatever the working mode now, a previous session may have crashed in WAL mode
+        IFOK(*result) {
+            this->recoverCrashedWorkingCopy(fileName);
+        }
     }
 
 
@@ -67,7 +78,7 @@ PLMProject::PLMProject(QObject *parent, int projectId, const QUrl& fileName, SKR
         PLMImporter importer;
 
         if (fileName.isEmpty()) { // virgin project
-            m_sqlDb = importer.createEmptySQLiteProject(projectId, *result, sqlFile);
+            m_sqlDb = importer.createEmptySQLiteProject(projectId, *result, sqlFile, workingMode);
 
             IFKO(*result) {
                 // qWarning << result.getMessage()
@@ -77,7 +88,7 @@ PLMProject::PLMProject(QObject *parent, int projectId, const QUrl& fileName, SKR
                 return;
             }
         } else {
-            m_sqlDb = importer.createSQLiteDbFrom("SQLITE", fileName, projectId, *result);
+            m_sqlDb = importer.createSQLiteDbFrom("SQLITE", fileName, projectId, *result, workingMode);
         }
         this->setPath(fileName);
     }
@@ -104,6 +115,15 @@ PLMProject::PLMProject(QObject *parent, int projectId, const QUrl& fileName, SKR
     }
 
 
+    IFOK(*result) {
+        // the upgrades are done, the schema won't change anymore
+        this->refreshTableInfos();
+
+        if (m_workingMode == WalMode) {
+            this->startCheckpointer();
+        }
+    }
+
     IFKO(*result) {
         *result     = SKRResult(SKRResult::Critical, this, "project_creation_failed");
         m_projectId = -1;
@@ -112,14 +132,24 @@ PLMProject::PLMProject(QObject *parent, int projectId, const QUrl& fileName, SKR
 
 PLMProject::~PLMProject()
 {
+    // finish the pending saves :
+    this->stopCheckpointer();
+
     // close DB :
+    SKRSqlStatementCache::clear(m_sqlDb.connectionName());
     m_sqlDb.close();
 
-    // remove temporary files :
-    QFile tempFile(this->getTempFileName());
+    // remove temporary files, with the WAL if it remains :
+    const QStringList tempFileNames({ this->getTempFileName(),
+                                      this->getTempFileName() + "-wal",
+                                      this->getTempFileName() + "-shm" });
 
-    if (tempFile.exists() && tempFile.isWritable()) {
-        tempFile.remove();
+    for (const QString& tempFileName : tempFileNames) {
+        QFile tempFile(tempFileName);
+
+        if (tempFile.exists() && tempFile.isWritable()) {
+            tempFile.remove();
+        }
     }
 }
 
@@ -130,27 +160,72 @@ QSqlDatabase PLMProject::getSqlDb() const
 
 QString PLMProject::getIdNameFromTable(const QString& tableName)
 {
-    QSqlDatabase sqlDb;
+    return this->getTableInfo(tableName).idName;
+}
+
+///
+/// \brief PLMProject::getTableInfo
+/// \param tableName
+/// \return
+/// Read from the cache filled when the project is opened, so that building
+/// queries doesn't cost a PRAGMA table_info each time. A table created later
+/// is read on first use.
+PLMProject::TableInfo PLMProject::getTableInfo(const QString& tableName)
+{
+    auto it = m_tableInfoByNameHash.constFind(tableName);
+
+    if (it != m_tableInfoByNameHash.constEnd()) {
+        return it.value();
+    }
 
-    sqlDb = m_sqlDb;
+    TableInfo tableInfo = this->readTableInfo(tableName);
 
+    // a missing table may be created later, not cached
+    if (!tableInfo.fieldNames.isEmpty()) {
+        m_tableInfoByNameHash.insert(tableName, tableInfo);
+    }
+
+    return tableInfo;
+}
+
+///
+/// \brief PLMProject::refreshTableInfos
+/// to be called after the schema changed, like after an upgrade
+void PLMProject::refreshTableInfos()
+{
+    m_tableInfoByNameHash.clear();
 
-    if (!sqlDb.isOpen()) {
-        sqlDb.open();
+    if (!m_sqlDb.isOpen()) {
+        m_sqlDb.open();
     }
 
-    QSqlRecord record =  sqlDb.driver()->record(tableName);
-    QString    idName;
+    const QStringList tableNames = m_sqlDb.tables(QSql::Tables);
+
+    for (const QString& tableName : tableNames) {
+        this->getTableInfo(tableName);
+    }
+}
+
+PLMProject::TableInfo PLMProject::readTableInfo(const QString& tableName)
+{
+    if (!m_sqlDb.isOpen()) {
+        m_sqlDb.open();
+    }
+
+    QSqlRecord record = m_sqlDb.driver()->record(tableName);
+    TableInfo  tableInfo;
 
     for (int i = 0; i < record.count(); ++i) {
         QString field(record.field(i).name());
 
+        tableInfo.fieldNames << field;
+
         if (field.endsWith("_id")) {
-            idName = field;
+            tableInfo.idName = field;
         }
     }
 
-    return idName;
+    return tableInfo;
 }
 
 QString PLMProject::getTempFileName() const
@@ -158,6 +233,157 @@ QString PLMProject::getTempFileName() const
     return m_sqlDb.databaseName();
 }
 
+PLMProject::WorkingMode PLMProject::getWorkingMode() const
+{
+    return m_workingMode;
+}
+
+///
+/// \brief PLMProject::getRecoveredPath
+/// \return
+/// the project rebuilt from a working copy left by a crash, empty if none
+QUrl PLMProject::getRecoveredPath() const
+{
+    return m_recoveredPath;
+}
+
+///
+/// \brief PLMProject::workingCopyFileName
+/// \param projectPath
+/// \return
+/// In WAL mode, the working copy is kept hidden next to the project, to be
+/// found again at the next opening if Skribisto didn't close it. Empty if the
+/// project isn't a local file in a writable folder.
+QString PLMProject::workingCopyFileName(const QUrl& projectPath)
+{
+    if (projectPath.isEmpty() || !projectPath.isLocalFile()) {
+        return QString();
+    }
+
+    QFileInfo info(projectPath.toLocalFile());
+
+    if (!QFileInfo(info.absolutePath()).isWritable()) {
+        return QString();
+    }
+
+    return info.absoluteDir().filePath("." + info.fileName() + ".working");
+}
+
+///
+/// \brief PLMProject::recoverCrashedWorkingCopy
+/// \param fileName
+/// The WAL of a leftover working copy holds the last commits. Switching the
+/// copy back to a rollback journal checkpoints them into the database file,
+/// which is then kept next to the project as a project of its own. SQLite
+/// refuses it while another instance still uses the copy, then it's left
+/// alone.
+void PLMProject::recoverCrashedWorkingCopy(const QUrl& fileName)
+{
+    const QString workingCopy = workingCopyFileName(fileName);
+
+    if (workingCopy.isEmpty() || !QFileInfo::exists(workingCopy)) {
+        return;
+    }
+
+    const QString connectionName = QString::number(m_projectId) + "_recovery";
+    bool checkpointed            = false;
+
+    {
+        QSqlDatabase sqlDb = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        sqlDb.setDatabaseName(workingCopy);
+
+        if (sqlDb.open()) {
+            QSqlQuery query(sqlDb);
+
+            checkpointed = query.exec("PRAGMA journal_mode=DELETE") && query.next() &&
+                           (query.value(0).toString().toLower() == "delete");
+            query.finish();
+        }
+        sqlDb.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    if (!checkpointed) {
+        qWarning() << "working copy in use or unreadable, left alone:" << workingCopy;
+        return;
+    }
+
+    QFileInfo info(fileName.toLocalFile());
+    QString   recoveredFileName =
+        info.absoluteDir().filePath(QString("%1_recovered_%2.%3")
+                                    .arg(info.completeBaseName())
+                                    .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss"))
+                                    .arg(info.suffix()));
+
+    if (!QFile::rename(workingCopy, recoveredFileName)) {
+        qWarning() << "working copy can't be moved to" << recoveredFileName;
+        return;
+    }
+    QFile::remove(workingCopy + "-shm");
+
+    m_recoveredPath = QUrl::fromLocalFile(recoveredFileName);
+}
+
+///
+/// \brief PLMProject::requestSave
+/// \param fileName
+/// WAL mode only, the save is queued in the worker thread, saveFinished is
+/// emitted once done
+void PLMProject::requestSave(const QUrl& fileName)
+{
+    if (!m_checkpointer) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(m_checkpointer, "save", Qt::QueuedConnection, Q_ARG(QUrl, fileName));
+}
+
+///
+/// \brief PLMProject::startCheckpointer
+/// falls back to the memory journal if SQLite refused the WAL
+void PLMProject::startCheckpointer()
+{
+    QSqlQuery query(m_sqlDb);
+
+    query.prepare("PRAGMA journal_mode");
+
+    if (!query.exec() || !query.next() || (query.value(0).toString().toLower() != "wal")) {
+        qWarning() << "WAL mode unavailable for" << this->getTempFileName();
+        m_workingMode = MemoryJournalMode;
+        return;
+    }
+    query.finish();
+
+    m_checkpointThread = new QThread();
+    m_checkpointer     = new SKRWalCheckpointer(m_projectId, this->getTempFileName());
+    m_checkpointer->moveToThread(m_checkpointThread);
+
+    connect(m_checkpointer, &SKRWalCheckpointer::saveFinished, this, &PLMProject::saveFinished);
+
+    m_checkpointThread->start();
+    QMetaObject::invokeMethod(m_checkpointer, "start", Qt::QueuedConnection);
+}
+
+void PLMProject::stopCheckpointer()
+{
+    if (!m_checkpointer) {
+        return;
+    }
+
+    // queued after the pending saves
+    QMetaObject::invokeMethod(m_checkpointer, "stop", Qt::BlockingQueuedConnection);
+    m_checkpointThread->quit();
+    m_checkpointThread->wait();
+
+    delete m_checkpointer;
+    delete m_checkpointThread;
+    m_checkpointer     = nullptr;
+    m_checkpointThread = nullptr;
+
+    // deliver the saveFinished of the last saves before going away
+    QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+}
+
 // PLMProperty * PLMProject::getProperty(const QString& tableName)
 // {
 //    return m_plmPropertyForTableNameHash.value(tableName);
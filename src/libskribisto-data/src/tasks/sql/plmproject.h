@@ -24,12 +24,16 @@
 
 #include <QObject>
 #include <QHash>
+#include <QStringList>
 #include <QtSql/QSqlDatabase>
 #include <QUrl>
 
 #include "skrresult.h"
 #include "skribisto_data_global.h"
 
+class QThread;
+class SKRWalCheckpointer;
+
 class EXPORT PLMProject : public QObject {
     Q_OBJECT
 
@@ -38,17 +42,34 @@ public:
     enum DBType { ProjectDB, UserDB };
     Q_ENUM(DBType)
 
+    // MemoryJournalMode : the journal is in memory, nothing is synced
+    // WalMode : the commits are appended to a WAL, checkpointed and saved by a worker thread
+    enum WorkingMode { MemoryJournalMode, WalMode };
+    Q_ENUM(WorkingMode)
+
+    // what the queries need to know about a table, read once per project
+    struct TableInfo {
+        QString     idName;
+        QStringList fieldNames;
+    };
+
     explicit PLMProject(QObject       *parent,
                         int            projectId,
                         const QUrl   & fileName,
                         SKRResult     *result,
-                        const QString& sqlFile = "");
+                        const QString& sqlFile     = "",
+                        WorkingMode    workingMode = MemoryJournalMode);
     ~PLMProject();
     QString      getType() const;
     void         setType(const QString& value);
     int          id() const;
 
     QString      getTempFileName() const;
+    WorkingMode  getWorkingMode() const;
+    void         requestSave(const QUrl& fileName);
+    QUrl         getRecoveredPath() const;
+
+    static QString workingCopyFileName(const QUrl& projectPath);
 
     QUrl         getPath() const;
     SKRResult    setPath(const QUrl& value);
@@ -56,17 +77,35 @@ public:
 
     QSqlDatabase getSqlDb() const;
     QString      getIdNameFromTable(const QString& tableName);
+    TableInfo    getTableInfo(const QString& tableName);
+    void         refreshTableInfos();
 
 signals:
 
+    void saveFinished(int              projectId,
+                      const QUrl     & fileName,
+                      const SKRResult& result);
+
 public slots:
 
+private:
+
+    TableInfo readTableInfo(const QString& tableName);
+    void      recoverCrashedWorkingCopy(const QUrl& fileName);
+    void      startCheckpointer();
+    void      stopCheckpointer();
+
 private:
 
     QSqlDatabase m_sqlDb;
     int m_projectId;
     QString m_type;
     QUrl m_path;
+    QUrl m_recoveredPath;
+    QHash<QString, TableInfo>m_tableInfoByNameHash;
+    WorkingMode m_workingMode;
+    QThread *m_checkpointThread;
+    SKRWalCheckpointer *m_checkpointer;
 };
 
 #endif // PLMDATABASE_H
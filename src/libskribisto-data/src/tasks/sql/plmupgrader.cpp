@@ -616,6 +616,41 @@ SKRResult PLMUpgrader::upgradeSQLite(QSqlDatabase sqlDb)
     if (dbVersion == 1.6) {
         double newDbVersion = 1.7;
 
+        // keep only the last duplicated property so the unique index can be created
+        QString queryStr =
+            R""""(DELETE FROM tbl_tree_property WHERE t_name IS NOT NULL AND l_tree_property_id NOT IN (SELECT MAX(l_tree_property_id) FROM tbl_tree_property WHERE t_name IS NOT NULL GROUP BY l_tree_code, t_name);
+                )"""";
+
+        IFOKDO(result, SKRSqlTools::executeSQLString(queryStr, sqlDb));
+
+        // indexes used by property, tag and sorted tree lookups
+
+        queryStr =
+            R""""(CREATE UNIQUE INDEX IF NOT EXISTS idx_tree_property_tree_code_name ON tbl_tree_property (l_tree_code, t_name);
+                CREATE INDEX IF NOT EXISTS idx_tag_relationship_tree_code ON tbl_tag_relationship (l_tree_code, l_tag_code);
+                CREATE INDEX IF NOT EXISTS idx_tag_relationship_tag_code ON tbl_tag_relationship (l_tag_code, l_tree_code);
+                CREATE INDEX IF NOT EXISTS idx_tree_sort_order ON tbl_tree (l_sort_order);
+                )"""";
+
+        IFOKDO(result, SKRSqlTools::executeSQLString(queryStr, sqlDb));
+
+
+        IFOKDO(result, result = PLMUpgrader::setDbVersion(sqlDb, newDbVersion));
+
+        IFOK(result) {
+            dbVersion = newDbVersion;
+        }
+    }
+    IFKO(result) {
+        return result;
+    }
+
+    // ---------------------------------
+
+    // from 1.7 to 1.8
+    if (dbVersion == 1.7) {
+        double newDbVersion = 1.8;
+
         // fill here
     }
     IFKO(result) {
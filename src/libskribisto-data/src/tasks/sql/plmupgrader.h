@@ -25,8 +25,9 @@
 #include <QSqlDatabase>
 
 #include "skrresult.h"
+#include "skribisto_data_global.h"
 
-class PLMUpgrader : public QObject {
+class EXPORT PLMUpgrader : public QObject {
     Q_OBJECT
 
 public:
@@ -0,0 +1,130 @@
+/***************************************************************************
+*   Copyright (C) 2021 by Cyril Jacquet                                 *
+*   cyril.jacquet@skribisto.eu                                        *
+*                                                                         *
+*  Filename: skrsqlstatementcache.cpp                                                   *
+*  This file is part of Skribisto.                                    *
+*                                                                         *
+*  Skribisto is free software: you can redistribute it and/or modify  *
+*  it under the terms of the GNU General Public License as published by   *
+*  the Free Software Foundation, either version 3 of the License, or      *
+*  (at your option) any later version.                                    *
+*                                                                         *
+*  Skribisto is distributed in the hope that it will be useful,       *
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+*  GNU General Public License for more details.                           *
+*                                                                         *
+*  You should have received a copy of the GNU General Public License      *
+*  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
+***************************************************************************/
+#include "skrsqlstatementcache.h"
+#include <QSqlError>
+
+namespace {
+// connection name -> SQL string -> prepared query
+QHash<QString, QHash<QString, QSqlQuery *> > queriesByConnectionHash;
+int hits   = 0;
+int misses = 0;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRSqlStatementCache::acquire
+/// \param sqlDb
+/// \param queryStr
+/// \return a prepared query, owned by the caller until release() is called
+/// The query is taken out of the cache, so a nested call with the same string
+/// gets its own statement.
+QSqlQuery * SKRSqlStatementCache::acquire(const QSqlDatabase& sqlDb, const QString& queryStr)
+{
+    QSqlQuery *query = queriesByConnectionHash[sqlDb.connectionName()].take(queryStr);
+
+    if (query) {
+        hits++;
+        return query;
+    }
+
+    misses++;
+
+    query = new QSqlQuery(sqlDb);
+    query->setForwardOnly(true);
+    query->prepare(queryStr);
+
+    return query;
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRSqlStatementCache::release
+/// \param sqlDb
+/// \param queryStr
+/// \param query
+/// Resets the statement and keeps it for the next call. Queries in error are
+/// deleted so they are prepared again next time.
+void SKRSqlStatementCache::release(const QSqlDatabase& sqlDb, const QString& queryStr, QSqlQuery *query)
+{
+    if (!query) {
+        return;
+    }
+
+    QHash<QString, QSqlQuery *>& queryHash = queriesByConnectionHash[sqlDb.connectionName()];
+
+    if (query->lastError().isValid() || queryHash.contains(queryStr) || !sqlDb.isOpen()) {
+        delete query;
+        return;
+    }
+
+    query->finish();
+    queryHash.insert(queryStr, query);
+}
+
+// ----------------------------------------------------------------------------------------
+
+///
+/// \brief SKRSqlStatementCache::clear
+/// \param connectionName
+/// must be called before the connection is closed and removed
+void SKRSqlStatementCache::clear(const QString& connectionName)
+{
+    QHash<QString, QSqlQuery *> queryHash = queriesByConnectionHash.take(connectionName);
+
+    qDeleteAll(queryHash);
+}
+
+// ----------------------------------------------------------------------------------------
+
+int SKRSqlStatementCache::hitCount()
+{
+    return hits;
+}
+
+// ----------------------------------------------------------------------------------------
+
+int SKRSqlStatementCache::missCount()
+{
+    return misses;
+}
+
+// ----------------------------------------------------------------------------------------
+
+double SKRSqlStatementCache::hitRate()
+{
+    int total = hits + misses;
+
+    if (total == 0) {
+        return 0.0;
+    }
+
+    return static_cast<double>(hits) / total;
+}
+
+// ----------------------------------------------------------------------------------------
+
+void SKRSqlStatementCache::resetCounters()
+{
+    hits   = 0;
+    misses = 0;
+}
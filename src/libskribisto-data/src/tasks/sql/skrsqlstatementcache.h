@@ -0,0 +1,57 @@
+/***************************************************************************
+*   Copyright (C) 2021 by Cyril Jacquet                                 *
+*   cyril.jacquet@skribisto.eu                                        *
+*                                                                         *
+*  Filename: skrsqlstatementcache.h                                                   *
+*  This file is part of Skribisto.                                    *
+*                                                                         *
+*  Skribisto is free software: you can redistribute it and/or modify  *
+*  it under the terms of the GNU General Public License as published by   *
+*  the Free Software Foundation, either version 3 of the License, or      *
+*  (at your option) any later version.                                    *
+*                                                                         *
+*  Skribisto is distributed in the hope that it will be useful,       *
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+*  GNU General Public License for more details.                           *
+*                                                                         *
+*  You should have received a copy of the GNU General Public License      *
+*  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
+***************************************************************************/
+#ifndef SKRSQLSTATEMENTCACHE_H
+#define SKRSQLSTATEMENTCACHE_H
+
+#include <QHash>
+#include <QString>
+#include <QSqlQuery>
+#include <QtSql/QSqlDatabase>
+
+#include "skribisto_data_global.h"
+
+///
+/// \brief The SKRSqlStatementCache class
+/// Keeps the prepared QSqlQuery of each SQL string per database connection, so
+/// SQLite parses and plans a statement only once. A query is taken with
+/// acquire() and must be given back with release() once its rows are read.
+/// Only used from the main thread, like the databases themselves.
+class EXPORT SKRSqlStatementCache {
+public:
+
+    static QSqlQuery* acquire(const QSqlDatabase& sqlDb,
+                              const QString     & queryStr);
+    static void       release(const QSqlDatabase& sqlDb,
+                              const QString     & queryStr,
+                              QSqlQuery          *query);
+    static void       clear(const QString& connectionName);
+
+    static int        hitCount();
+    static int        missCount();
+    static double     hitRate();
+    static void       resetCounters();
+
+private:
+
+    SKRSqlStatementCache();
+};
+
+#endif // SKRSQLSTATEMENTCACHE_H
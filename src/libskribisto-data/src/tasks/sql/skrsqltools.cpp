@@ -1,6 +1,7 @@
 #include "skrsqltools.h"
 
 #include <QtSql/QSqlQuery>
+#include <QStringList>
 #include <QSqlDriver>
 #include <QSqlError>
 #include <QRegularExpression>
@@ -190,67 +191,65 @@ double SKRSqlTools::getProjectDBVersion(SKRResult *result, QSqlDatabase& sqlDb)
 
 SKRResult SKRSqlTools::renumberTreeSortOrder(QSqlDatabase& sqlDb)
 {
-    SKRResult result("SKRSqlTools::renumberTreeSortOrder");
-    int renumInterval = 1000;
+    SKRResult result = SKRSqlTools::renumberSortOrder(sqlDb, "tbl_tree", "l_tree_id");
 
-    // Renumber all non-trashed paper in this version. DOES NOT COMMIT - Caller
-    // should
-    QSqlQuery query(sqlDb);
-    QString   queryStr = "SELECT l_tree_id"
-                         " FROM tbl_tree"
-                         " ORDER BY l_sort_order"
-    ;
-
-    /*bool prepareOk = */ query.prepare(queryStr);
-
-    //    qDebug() << "prepareOk" << prepareOk;
-    //    qDebug() << query.lastError().text();
-    query.exec();
-
-    if (query.lastError().isValid()) {
-        result = SKRResult(SKRResult::Critical, "SKRSqlTools::renumberTreeSortOrder", "sql_error");
-        result.addData("SQLError",   query.lastError().text());
-        result.addData("SQL string", queryStr);
+    IFKO(result) {
         sqlDb.rollback();
-        return result;
     }
 
-    //    qDebug() << query.lastError().text();
-
-    int dest = 0;
-    QList<int> list;
+    return result;
+}
 
-    while (query.next()) {
-        list.append(query.value(0).toInt());
-    }
+// ------------------------------------------------------------------------------
 
-    for (int& id : list) {
-        // For each note to renumber, pass it to the renum function.. For speed
-        // we commit after all rows renumbered
+///
+/// \brief SKRSqlTools::renumberSortOrder
+/// \param sqlDb
+/// \param tableName
+/// \param idName
+/// \param interval
+/// \return
+/// Renumber all the sort orders of a table with a fixed interval, keeping the
+/// order. The ranks are computed in a temporary table so the whole table is
+/// renumbered with a handful of statements instead of one UPDATE per row. Rows
+/// already at their place are not written. DOES NOT COMMIT - Caller should
+SKRResult SKRSqlTools::renumberSortOrder(QSqlDatabase & sqlDb,
+                                         const QString& tableName,
+                                         const QString& idName,
+                                         int            interval)
+{
+    SKRResult result("SKRSqlTools::renumberSortOrder");
+
+    QString newSortOrderStr = "(SELECT (l_rank - 1) * " + QString::number(interval)
+                              + " FROM tbl_sort_order_renumbering"
+                                " WHERE l_id = " + tableName + "." + idName + ")";
+
+    QStringList queryStrList;
+
+    // l_rank is the rowid, given in insertion order
+    queryStrList << "CREATE TEMP TABLE IF NOT EXISTS tbl_sort_order_renumbering"
+                    " (l_rank INTEGER PRIMARY KEY, l_id INTEGER UNIQUE)"
+                 << "DELETE FROM tbl_sort_order_renumbering"
+                 << "INSERT INTO tbl_sort_order_renumbering (l_id)"
+                    " SELECT " + idName + " FROM " + tableName
+                    + " ORDER BY l_sort_order"
+                 << "UPDATE " + tableName
+                    + " SET l_sort_order = " + newSortOrderStr
+                    + " WHERE l_sort_order IS NOT " + newSortOrderStr
+                 << "DELETE FROM tbl_sort_order_renumbering";
 
+    QSqlQuery query(sqlDb);
 
-        {
-            QString queryStr = "UPDATE tbl_tree"
-                               " SET l_sort_order = :value"
-                               " WHERE l_tree_id = :id"
-            ;
-            query.prepare(queryStr);
-            query.bindValue(":id",    id);
-            query.bindValue(":value", dest);
-            query.exec();
+    for (const QString& queryStr : qAsConst(queryStrList)) {
+        query.exec(queryStr);
 
-            if (query.lastError().isValid()) {
-                result = SKRResult(SKRResult::Critical, "SKRSqlTools::renumberTreeSortOrder", "sql_error");
-                result.addData("SQLError",   query.lastError().text());
-                result.addData("SQL string", queryStr);
-                sqlDb.rollback();
+        if (query.lastError().isValid()) {
+            result = SKRResult(SKRResult::Critical, "SKRSqlTools::renumberSortOrder", "sql_error");
+            result.addData("SQLError",   query.lastError().text());
+            result.addData("SQL string", queryStr);
 
-                return result;
-            }
+            return result;
         }
-
-
-        dest += renumInterval;
     }
 
     return result;
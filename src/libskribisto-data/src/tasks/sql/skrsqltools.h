@@ -6,8 +6,9 @@
 #include <QObject>
 #include <QtSql/QSqlDatabase>
 #include "skrresult.h"
+#include "skribisto_data_global.h"
 
-class SKRSqlTools : public QObject {
+class EXPORT SKRSqlTools : public QObject {
     Q_OBJECT
 
 public:
@@ -22,6 +23,10 @@ public:
     static double    getProjectDBVersion(SKRResult    *result,
                                          QSqlDatabase& sqlDb);
     static SKRResult renumberTreeSortOrder(QSqlDatabase& sqlDb);
+    static SKRResult renumberSortOrder(QSqlDatabase & sqlDb,
+                                       const QString& tableName,
+                                       const QString& idName,
+                                       int            interval = 1000);
     static SKRResult addStringTreeProperty(QSqlDatabase & sqlDb,
                                            int            tree_id,
                                            const QString& name,
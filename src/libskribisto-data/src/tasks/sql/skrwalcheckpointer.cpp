@@ -0,0 +1,148 @@
+/***************************************************************************
+*   Copyright (C) 2021 by Cyril Jacquet                                 *
+*   cyril.jacquet@skribisto.eu                                        *
+*                                                                         *
+*  Filename: skrwalcheckpointer.cpp                                                   *
+*  This file is part of Skribisto.                                    *
+*                                                                         *
+*  Skribisto is free software: you can redistribute it and/or modify  *
+*  it under the terms of the GNU General Public License as published by   *
+*  the Free Software Foundation, either version 3 of the License, or      *
+*  (at your option) any later version.                                    *
+*                                                                         *
+*  Skribisto is distributed in the hope that it will be useful,       *
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+*  GNU General Public License for more details.                           *
+*                                                                         *
+*  You should have received a copy of the GNU General Public License      *
+*  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
+***************************************************************************/
+#include "skrwalcheckpointer.h"
+#include "plmexporter.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTimer>
+#include <QtSql/QSqlDatabase>
+
+SKRWalCheckpointer::SKRWalCheckpointer(int projectId, const QString& databaseFileName) :
+    QObject(nullptr), m_projectId(projectId), m_databaseFileName(databaseFileName),
+    m_connectionName(QString::number(projectId) + "_checkpointer"), m_timer(nullptr)
+{
+    qRegisterMetaType<SKRResult>("SKRResult");
+}
+
+SKRWalCheckpointer::~SKRWalCheckpointer()
+{}
+
+///
+/// \brief SKRWalCheckpointer::start
+/// to be called in the worker thread, the connection belongs to it
+void SKRWalCheckpointer::start()
+{
+    QSqlDatabase sqlDb = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+
+    sqlDb.setDatabaseName(m_databaseFileName);
+
+    if (!sqlDb.open()) {
+        qWarning() << "checkpointer can't open" << m_databaseFileName << sqlDb.lastError().text();
+        return;
+    }
+
+    m_timer = new QTimer(this);
+    m_timer->setInterval(2000);
+    connect(m_timer, &QTimer::timeout, this, &SKRWalCheckpointer::checkpoint);
+    m_timer->start();
+}
+
+// -----------------------------------------------------------------------------
+
+///
+/// \brief SKRWalCheckpointer::checkpoint
+/// moves what it can into the database file without waiting for anyone
+void SKRWalCheckpointer::checkpoint()
+{
+    this->runCheckpoint("PASSIVE");
+}
+
+// -----------------------------------------------------------------------------
+
+///
+/// \brief SKRWalCheckpointer::save
+/// \param fileName
+/// Only this thread checkpoints, so once the WAL is entirely in the database
+/// file, the file stays the same during the copy : the new commits go to the
+/// WAL.
+void SKRWalCheckpointer::save(const QUrl& fileName)
+{
+    QElapsedTimer timer;
+
+    timer.start();
+
+    SKRResult result = this->runCheckpoint("FULL");
+
+    IFOKDO(result, PLMExporter::copyDatabaseFile(m_databaseFileName, fileName));
+    IFOK(result) {
+        result.addData("elapsedMs", timer.elapsed());
+    }
+
+    emit saveFinished(m_projectId, fileName, result);
+}
+
+// -----------------------------------------------------------------------------
+
+///
+/// \brief SKRWalCheckpointer::stop
+/// called after the pending saves, the main connection checkpoints the rest
+/// when closed
+void SKRWalCheckpointer::stop()
+{
+    if (m_timer) {
+        m_timer->stop();
+    }
+
+    {
+        QSqlDatabase sqlDb = QSqlDatabase::database(m_connectionName, false);
+        sqlDb.close();
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+// -----------------------------------------------------------------------------
+
+SKRResult SKRWalCheckpointer::runCheckpoint(const QString& mode)
+{
+    SKRResult result(this);
+    QSqlDatabase sqlDb = QSqlDatabase::database(m_connectionName, false);
+
+    if (!sqlDb.isOpen()) {
+        result = SKRResult(SKRResult::Critical, this, "checkpointer_not_opened");
+        result.addData("filePath", m_databaseFileName);
+        return result;
+    }
+
+    QString   queryStr = QString("PRAGMA wal_checkpoint(%1)").arg(mode);
+    QSqlQuery query(sqlDb);
+
+    query.prepare(queryStr);
+
+    if (!query.exec()) {
+        result = SKRResult(SKRResult::Critical, this, "sql_error");
+        result.addData("SQLError",   query.lastError().text());
+        result.addData("SQL string", queryStr);
+        return result;
+    }
+
+    // busy, frames in the WAL, frames checkpointed
+    if (query.next() && (query.value(0).toInt() != 0)) {
+        result = SKRResult(SKRResult::Warning, this, "checkpoint_busy");
+        result.addData("walFrames",          query.value(1).toInt());
+        result.addData("checkpointedFrames", query.value(2).toInt());
+    }
+    query.finish();
+
+    return result;
+}
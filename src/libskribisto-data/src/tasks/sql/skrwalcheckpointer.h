@@ -0,0 +1,73 @@
+/***************************************************************************
+*   Copyright (C) 2021 by Cyril Jacquet                                 *
+*   cyril.jacquet@skribisto.eu                                        *
+*                                                                         *
+*  Filename: skrwalcheckpointer.h                                                   *
+*  This file is part of Skribisto.                                    *
+*                                                                         *
+*  Skribisto is free software: you can redistribute it and/or modify  *
+*  it under the terms of the GNU General Public License as published by   *
+*  the Free Software Foundation, either version 3 of the License, or      *
+*  (at your option) any later version.                                    *
+*                                                                         *
+*  Skribisto is distributed in the hope that it will be useful,       *
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+*  GNU General Public License for more details.                           *
+*                                                                         *
+*  You should have received a copy of the GNU General Public License      *
+*  along with Skribisto.  If not, see <http://www.gnu.org/licenses/>. *
+***************************************************************************/
+#ifndef SKRWALCHECKPOINTER_H
+#define SKRWALCHECKPOINTER_H
+
+#include <QObject>
+#include <QString>
+#include <QUrl>
+
+#include "skrresult.h"
+
+class QTimer;
+
+///
+/// \brief The SKRWalCheckpointer class
+/// Lives in the worker thread of a project opened in WAL mode, with its own
+/// connection to the working copy. The commits of the main thread only
+/// append to the WAL, this class moves them into the database file from time
+/// to time and does the saves : a full checkpoint, then the copy of the
+/// database file, while the main thread keeps appending to the WAL.
+class SKRWalCheckpointer : public QObject {
+    Q_OBJECT
+
+public:
+
+    explicit SKRWalCheckpointer(int            projectId,
+                                const QString& databaseFileName);
+    ~SKRWalCheckpointer();
+
+public slots:
+
+    void start();
+    void checkpoint();
+    void save(const QUrl& fileName);
+    void stop();
+
+signals:
+
+    void saveFinished(int              projectId,
+                      const QUrl     & fileName,
+                      const SKRResult& result);
+
+private:
+
+    SKRResult runCheckpoint(const QString& mode);
+
+private:
+
+    int m_projectId;
+    QString m_databaseFileName;
+    QString m_connectionName;
+    QTimer *m_timer;
+};
+
+#endif // SKRWALCHECKPOINTER_H
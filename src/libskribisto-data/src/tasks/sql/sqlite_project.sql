@@ -3,7 +3,7 @@
 --
 -- Text encoding used: UTF-8
 --
--- skribisto_db_version:1.6
+-- skribisto_db_version:1.7
 
 PRAGMA foreign_keys = off;
 BEGIN TRANSACTION;
@@ -33,6 +33,19 @@ CREATE TABLE tbl_tag (l_tag_id INTEGER PRIMARY KEY ON CONFLICT ROLLBACK AUTOINCR
 CREATE TABLE tbl_tag_relationship (l_tag_relationship_id INTEGER PRIMARY KEY ON CONFLICT ROLLBACK AUTOINCREMENT NOT NULL ON CONFLICT ROLLBACK, l_tree_code INTEGER REFERENCES tbl_tree (l_tree_id), l_tag_code INTEGER REFERENCES tbl_tag (l_tag_id), dt_created DATETIME NOT NULL ON CONFLICT ROLLBACK DEFAULT (CURRENT_TIMESTAMP));
 
 
+-- Index: idx_tree_property_tree_code_name
+CREATE UNIQUE INDEX idx_tree_property_tree_code_name ON tbl_tree_property (l_tree_code, t_name);
+
+-- Index: idx_tag_relationship_tree_code
+CREATE INDEX idx_tag_relationship_tree_code ON tbl_tag_relationship (l_tree_code, l_tag_code);
+
+-- Index: idx_tag_relationship_tag_code
+CREATE INDEX idx_tag_relationship_tag_code ON tbl_tag_relationship (l_tag_code, l_tree_code);
+
+-- Index: idx_tree_sort_order
+CREATE INDEX idx_tree_sort_order ON tbl_tree (l_sort_order);
+
+
 -- project item
 INSERT INTO tbl_tree (l_tree_id, l_sort_order, l_indent, t_type) VALUES (0, -1, 0, 'PROJECT');
 INSERT INTO tbl_tree_property (l_tree_code, t_name, t_value_type, m_value) VALUES (0, 'is_renamable', 'BOOL', 'true');
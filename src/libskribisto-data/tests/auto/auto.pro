@@ -2,4 +2,5 @@ TEMPLATE = subdirs
 
 SUBDIRS += writecase \
     openprojectcase \
-    settingscase
+    settingscase \
+    benchmarkcase
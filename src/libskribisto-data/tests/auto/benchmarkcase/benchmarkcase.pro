@@ -0,0 +1,25 @@
+QT += testlib
+QT -= gui
+QT += sql gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+# add data lib :
+
+win32: LIBS += -L$$OUT_PWD/../../../src/ -lskribisto-data
+else:unix: LIBS += -L$$OUT_PWD/../../../src/ -lskribisto-data
+
+INCLUDEPATH += $$PWD/../../../src $$PWD/../../../src/models
+DEPENDPATH += $$PWD/../../../src
+
+
+
+SOURCES += \
+    tst_benchmarkcase.cpp
+
+
+RESOURCES += \
+    ../../../../../resources/test/testfiles.qrc
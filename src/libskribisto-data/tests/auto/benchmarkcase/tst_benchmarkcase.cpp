@@ -0,0 +1,1149 @@
+#include <QString>
+#include <QtTest>
+#include <QDebug>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlDriver>
+#include <QSqlRecord>
+#include <QTemporaryFile>
+#include <QTextDocument>
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <algorithm>
+
+#include "plmdata.h"
+#include "skrwordmeter.h"
+#include "skrtreelistmodel.h"
+#include "tasks/plmprojectmanager.h"
+#include "tasks/sql/skrsqltools.h"
+#include "tasks/sql/plmupgrader.h"
+#include "skrresult.h"
+
+class BenchmarkCase : public QObject {
+    Q_OBJECT
+
+public:
+
+    BenchmarkCase();
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    // indexes
+    void propertyLookupWithoutIndex();
+    void upgradeAddsIndexes();
+    void propertyLookupWithIndex();
+
+    // queries
+    void getTitle_data();
+    void getTitle();
+
+    // results
+    void resultSuccessPath();
+    void resultFailurePath();
+
+    // saving
+    void hubSetterLatency_data();
+    void hubSetterLatency();
+
+    // opening
+    void openProject_data();
+    void openProject();
+
+    // sort orders
+    void renumberTreeSortOrder();
+    void addTreeItem_data();
+    void addTreeItem();
+
+    // stats
+    void updateWordStats_data();
+    void updateWordStats();
+
+    // word meter
+    void countMarkdown_data();
+    void countMarkdown();
+    void countWithTextDocument();
+    void countWithWordMeter();
+    void fingerprint();
+    void countTexts_data();
+    void countTexts();
+
+    // typing
+    void typeContent_data();
+    void typeContent();
+
+    // search
+    void fullTextSearch_data();
+    void fullTextSearch();
+
+    // filters
+    void tagLookup_data();
+    void tagLookup();
+
+    // tree model
+    void treeModelLookup_data();
+    void treeModelLookup();
+    void treeStructure_data();
+    void treeStructure();
+
+private:
+
+    QString propertyLookupPlan();
+    void    lookupProperties();
+    QUrl    createProjectFile(int sizeInMB);
+    int     createProject(int treeItemCount,
+                          int depth);
+    QString createMarkdown(int wordCount);
+
+private:
+
+    PLMData *m_data;
+    QTemporaryFile *m_tempFile;
+    QSqlDatabase m_sqlDb;
+    int m_treeItemCount;
+    int m_propertyPerItemCount;
+};
+
+BenchmarkCase::BenchmarkCase() : m_treeItemCount(5000), m_propertyPerItemCount(10)
+{}
+
+void BenchmarkCase::initTestCase()
+{
+    m_data     = new PLMData(this);
+    m_tempFile = new QTemporaryFile(this);
+
+    // needed to have a fileName :
+    m_tempFile->open();
+    m_tempFile->close();
+
+    m_sqlDb = QSqlDatabase::addDatabase("QSQLITE", "benchmarkcase");
+    m_sqlDb.setDatabaseName(m_tempFile->fileName());
+    QVERIFY(m_sqlDb.open());
+
+    // an old 1.6 project, without indexes
+    SKRResult result = SKRSqlTools::executeSQLFile(":/sql/sqlite_project_1_6.sql", m_sqlDb);
+
+    QVERIFY(result.isSuccess());
+
+    result = SKRSqlTools::executeSQLString("INSERT INTO tbl_project (dbl_database_version) VALUES (1.6)", m_sqlDb);
+    QVERIFY(result.isSuccess());
+
+    // 50k properties
+    m_sqlDb.transaction();
+    QSqlQuery treeQuery(m_sqlDb);
+
+    treeQuery.prepare("INSERT INTO tbl_tree (l_tree_id, l_sort_order, l_indent, t_type) VALUES (:id, :sortOrder, 1, 'TEXT')");
+
+    QSqlQuery propertyQuery(m_sqlDb);
+
+    propertyQuery.prepare("INSERT INTO tbl_tree_property (l_tree_code, t_name, m_value) VALUES (:code, :name, :value)");
+
+    for (int i = 1; i <= m_treeItemCount; i++) {
+        treeQuery.bindValue(":id",        i);
+        treeQuery.bindValue(":sortOrder", i * 1000);
+        QVERIFY(treeQuery.exec());
+
+        for (int j = 0; j < m_propertyPerItemCount; j++) {
+            propertyQuery.bindValue(":code",  i);
+            propertyQuery.bindValue(":name",  QString("property_%1").arg(j));
+            propertyQuery.bindValue(":value", QString::number(i * j));
+            QVERIFY(propertyQuery.exec());
+        }
+    }
+    m_sqlDb.commit();
+}
+
+void BenchmarkCase::cleanupTestCase()
+{
+    m_sqlDb.close();
+    m_sqlDb = QSqlDatabase();
+    QSqlDatabase::removeDatabase("benchmarkcase");
+    m_tempFile->remove();
+}
+
+// ------------------------------------------------------------------------------------
+
+QString BenchmarkCase::propertyLookupPlan()
+{
+    QSqlQuery query(m_sqlDb);
+
+    query.exec("EXPLAIN QUERY PLAN SELECT m_value FROM tbl_tree_property WHERE l_tree_code = 42 AND t_name = 'property_3'");
+
+    QStringList details;
+
+    while (query.next()) {
+        details << query.value(3).toString();
+    }
+
+    return details.join("; ");
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::lookupProperties()
+{
+    QSqlQuery query(m_sqlDb);
+
+    query.prepare("SELECT m_value FROM tbl_tree_property WHERE l_tree_code = :code AND t_name = :name");
+
+    for (int i = 1; i <= m_treeItemCount; i += 50) {
+        query.bindValue(":code", i);
+        query.bindValue(":name", QString("property_%1").arg(i % m_propertyPerItemCount));
+        query.exec();
+
+        while (query.next()) {
+            query.value(0);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::propertyLookupWithoutIndex()
+{
+    QString plan = propertyLookupPlan();
+
+    qDebug() << "plan:" << plan;
+    QVERIFY(plan.contains("SCAN"));
+
+    QBENCHMARK {
+        lookupProperties();
+    }
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::upgradeAddsIndexes()
+{
+    SKRResult result = PLMUpgrader::upgradeSQLite(m_sqlDb);
+
+    QVERIFY(result.isSuccess());
+    QCOMPARE(SKRSqlTools::getProjectDBVersion(&result, m_sqlDb), 1.7);
+
+    // the unique constraint is enforced
+    QSqlQuery query(m_sqlDb);
+
+    QVERIFY(!query.exec("INSERT INTO tbl_tree_property (l_tree_code, t_name, m_value) VALUES (1, 'property_1', 'duplicate')"));
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::propertyLookupWithIndex()
+{
+    QString plan = propertyLookupPlan();
+
+    qDebug() << "plan:" << plan;
+    QVERIFY(plan.contains("idx_tree_property_tree_code_name"));
+
+    QBENCHMARK {
+        lookupProperties();
+    }
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::createProjectFile
+/// \param sizeInMB
+/// \return the test project saved with enough text to weigh sizeInMB
+QUrl BenchmarkCase::createProjectFile(int sizeInMB)
+{
+    QTemporaryFile projectFile;
+
+    projectFile.setAutoRemove(false);
+    projectFile.open();
+    projectFile.close();
+    QUrl projectUrl = QUrl::fromLocalFile(projectFile.fileName());
+
+    plmdata->projectHub()->loadProject(QUrl("qrc:/testfiles/skribisto_test_project.skrib"));
+    int projectId = plmdata->projectHub()->getLastLoaded();
+
+    const int itemSizeInMB = 8;
+    QString   content(itemSizeInMB * 1024 * 1024, QChar('a'));
+
+    for (int i = 0; i < sizeInMB; i += itemSizeInMB) {
+        SKRResult result = plmdata->treeHub()->addChildTreeItem(projectId, 0, "TEXT");
+        int treeItemId   = result.getData("treeItemId", -2).toInt();
+
+        plmdata->treeHub()->setPrimaryContent(projectId, treeItemId, content);
+    }
+
+    plmdata->projectHub()->saveProjectAs(projectId, "skrib", projectUrl);
+    plmdata->projectHub()->closeAllProjects();
+
+    return projectUrl;
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::openProject_data()
+{
+    QTest::addColumn<int>("sizeInMB");
+
+    QTest::newRow("10 MB") << 10;
+    QTest::newRow("100 MB") << 100;
+    QTest::newRow("1 GB") << 1024;
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::openProject()
+{
+    QFETCH(int, sizeInMB);
+
+    if ((sizeInMB > 100) && qEnvironmentVariableIsEmpty("SKRIBISTO_LARGE_BENCHMARKS")) {
+        QSKIP("set SKRIBISTO_LARGE_BENCHMARKS to run");
+    }
+
+    QUrl projectUrl = createProjectFile(sizeInMB);
+
+    QBENCHMARK {
+        SKRResult result = plmdata->projectHub()->loadProject(projectUrl);
+        QVERIFY(result.isSuccess());
+        plmdata->projectHub()->closeAllProjects();
+    }
+
+    QFile::remove(projectUrl.toLocalFile());
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::renumberTreeSortOrder()
+{
+    m_sqlDb.transaction();
+
+    // shuffle the sort orders so every row has to move
+    SKRResult result = SKRSqlTools::executeSQLString(
+        "UPDATE tbl_tree SET l_sort_order = (l_tree_id * 7919) % 100003", m_sqlDb);
+
+    QVERIFY(result.isSuccess());
+
+    QBENCHMARK {
+        result = SKRSqlTools::renumberTreeSortOrder(m_sqlDb);
+    }
+    QVERIFY(result.isSuccess());
+
+    QSqlQuery query(m_sqlDb);
+
+    QVERIFY(query.exec("SELECT MIN(l_sort_order), MAX(l_sort_order), COUNT(DISTINCT l_sort_order) FROM tbl_tree"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 0);
+    QCOMPARE(query.value(1).toInt(), (m_treeItemCount - 1) * 1000);
+    QCOMPARE(query.value(2).toInt(), m_treeItemCount);
+
+    m_sqlDb.rollback();
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::addTreeItem_data()
+{
+    QTest::addColumn<int>("treeItemCount");
+
+    QTest::newRow("100 items") << 100;
+    QTest::newRow("1k items") << 1000;
+    QTest::newRow("10k items") << 10000;
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::addTreeItem()
+{
+    QFETCH(int, treeItemCount);
+
+    int projectId = this->createProject(treeItemCount, 1);
+
+    QVERIFY(projectId > 0);
+
+    SKRResult result;
+
+    // insert in the middle so half of the tree moves
+    int targetId = plmdata->treeHub()->getAllIds(projectId).at(treeItemCount / 2);
+
+    QBENCHMARK {
+        result = plmdata->treeHub()->addTreeItemBelow(projectId, targetId, "TEXT");
+    }
+    QVERIFY(result.isSuccess());
+
+    plmdata->projectHub()->closeProject(projectId);
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::createProject
+/// \param treeItemCount
+/// \param depth
+/// \return a hidden project with treeItemCount items nested in chains of depth items
+int BenchmarkCase::createProject(int treeItemCount, int depth)
+{
+    SKRResult result = plmdata->projectHub()->createNewEmptyProject(QUrl(), true);
+
+    if (!result.isSuccess()) {
+        return -1;
+    }
+    int projectId = result.getData("projectId", -2).toInt();
+
+    QSqlDatabase projectDb = QSqlDatabase::database(QString::number(projectId));
+
+    projectDb.transaction();
+    QSqlQuery treeQuery(projectDb);
+
+    treeQuery.prepare("INSERT INTO tbl_tree (l_sort_order, l_indent, t_type) VALUES (:sortOrder, :indent, 'TEXT')");
+
+    for (int i = 1; i <= treeItemCount; i++) {
+        treeQuery.bindValue(":sortOrder", i * 1000);
+        treeQuery.bindValue(":indent",    1 + (i - 1) % depth);
+
+        if (!treeQuery.exec()) {
+            projectDb.rollback();
+            return -1;
+        }
+    }
+    projectDb.commit();
+    plmdata->treeHub()->invalidateTreeTopology(projectId);
+
+    return projectId;
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::updateWordStats_data()
+{
+    QTest::addColumn<int>("treeItemCount");
+
+    QTest::newRow("1k items") << 1000;
+    QTest::newRow("10k items") << 10000;
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::updateWordStats()
+{
+    QFETCH(int, treeItemCount);
+
+    const int depth = 10;
+    int projectId   = this->createProject(treeItemCount, depth);
+
+    QVERIFY(projectId > 0);
+
+    SKRStatHub *statHub = plmdata->statHub();
+    QList<int>  ids     = plmdata->treeHub()->getAllIds(projectId);
+
+    for (int id : qAsConst(ids)) {
+        statHub->updateWordStats(projectId, id, 10, false);
+    }
+
+    QCOMPARE(statHub->getTreeItemTotalCount(SKRStatHub::Word, projectId), ids.count() * 10);
+
+    // typing in the deepest item of the last chain
+    int deepestId = ids.last();
+    int wordCount = 10;
+
+    QBENCHMARK {
+        statHub->updateWordStats(projectId, deepestId, ++wordCount);
+    }
+
+    QCOMPARE(statHub->getTreeItemCountWithChildren(SKRStatHub::Word, projectId, 0),
+             ids.count() * 10 + wordCount - 10);
+    QCOMPARE(statHub->getTreeItemCountWithChildren(SKRStatHub::Word, projectId, deepestId), wordCount);
+
+    plmdata->projectHub()->closeProject(projectId);
+}
+
+// ------------------------------------------------------------------------------------
+
+QString BenchmarkCase::createMarkdown(int wordCount)
+{
+    const QString paragraph = "## Chapter\n\n"
+                              "Lorem **ipsum** dolor _sit_ amet, consectetur adipiscing elit. "
+                              "Sed do eiusmod [tempor](http://example.com) incididunt ut labore et dolore.\n"
+                              "- magna aliqua ut enim\n- ad minim veniam\n\n";
+    const int paragraphWordCount = 25;
+
+    QString markdown;
+
+    markdown.reserve((wordCount / paragraphWordCount + 1) * paragraph.size());
+
+    for (int i = 0; i < wordCount; i += paragraphWordCount) {
+        markdown.append(paragraph);
+    }
+
+    return markdown;
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::getTitle_data()
+{
+    QTest::addColumn<bool>("readTableInfo");
+
+    QTest::newRow("table info read for each query") << true;
+    QTest::newRow("table info cached") << false;
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::getTitle
+/// the cost of the smallest getter. Reading the table info as each query used
+/// to do gives the previous cost.
+void BenchmarkCase::getTitle()
+{
+    QFETCH(bool, readTableInfo);
+
+    int projectId = this->createProject(100, 3);
+
+    QVERIFY(projectId > 0);
+
+    QList<int>   ids   = plmdata->treeHub()->getAllIds(projectId);
+    QSqlDatabase sqlDb = QSqlDatabase::database(QString::number(projectId));
+    QString title;
+
+    QBENCHMARK {
+        for (int id : qAsConst(ids)) {
+            if (readTableInfo) {
+                sqlDb.driver()->record("tbl_tree");
+            }
+            title = plmdata->treeHub()->getTitle(projectId, id);
+        }
+    }
+
+    QCOMPARE(plmProjectManager->project(projectId)->getIdNameFromTable("tbl_tree"), QString("l_tree_id"));
+
+    plmdata->projectHub()->closeProject(projectId);
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::resultSuccessPath
+/// 1M times the results of a hub getter: its own and the one of the queries
+/// assigned to it, without touching the database
+void BenchmarkCase::resultSuccessPath()
+{
+    const int callCount = 1000000;
+    int okCount         = 0;
+
+    QBENCHMARK {
+        okCount = 0;
+
+        for (int i = 0; i < callCount; ++i) {
+            SKRResult result(this);
+            SKRResult queriesResult(m_data);
+
+            result = queriesResult;
+
+            IFOK(result) {
+                okCount++;
+            }
+        }
+    }
+
+    QCOMPARE(okCount, callCount);
+
+    SKRResult result(this);
+
+    QCOMPARE(result.getLastErrorCode(), QString("OK_BENCHMARKCASE"));
+    result = SKRResult(m_data);
+    QCOMPARE(result.getLastErrorCode(), QString("OK_PLMDATA"));
+    QCOMPARE(result.getErrorCodeList(), QStringList() << "OK_PLMDATA");
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::resultFailurePath()
+{
+    SKRResult result(this);
+
+    result.addData("projectId", 1);
+    QCOMPARE(result.getData("projectId", -2).toInt(), 1);
+    QCOMPARE(result.getData("missing", -2).toInt(), -2);
+
+    SKRResult failure(SKRResult::Critical, m_data, "sql_error");
+
+    failure.addData("SQLError", "no such table");
+    result = failure;
+
+    IFOK(result) {
+        QFAIL("a failure assigned is a failure");
+    }
+
+    QCOMPARE(result.getErrorCodeList(), QStringList() << "OK_BENCHMARKCASE" << "C_PLMDATA__sql_error");
+    QCOMPARE(result.getLastErrorCode(), QString("C_PLMDATA__sql_error"));
+    QVERIFY(result.containsErrorCodeDetail("sql_error"));
+    QCOMPARE(result.getData("SQLError",  "").toString(), QString("no such table"));
+    QCOMPARE(result.getData("projectId", -2).toInt(), 1);
+
+    // implicitly shared, the copy doesn't change with the original
+    SKRResult copy = result;
+
+    result.addData("other", 2);
+    QVERIFY(copy != result);
+    QCOMPARE(copy.getData("other", -2).toInt(), -2);
+    QCOMPARE(failure.getErrorCodeList(), QStringList() << "C_PLMDATA__sql_error");
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::hubSetterLatency_data()
+{
+    QTest::addColumn<int>("workingMode");
+
+    QTest::newRow("memory journal") << int(PLMProject::MemoryJournalMode);
+    QTest::newRow("WAL") << int(PLMProject::WalMode);
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::hubSetterLatency
+/// Latency of each setTitle, as seen by the UI thread, with a save every 1000
+/// calls. The histogram has power of two buckets in microseconds.
+void BenchmarkCase::hubSetterLatency()
+{
+    QFETCH(int, workingMode);
+
+    const int callCount = 5000;
+
+    plmProjectManager->setWorkingMode(PLMProject::WorkingMode(workingMode));
+    int projectId = this->createProject(1000, 1);
+
+    plmProjectManager->setWorkingMode(PLMProject::MemoryJournalMode);
+    QVERIFY(projectId > 0);
+    QCOMPARE(int(plmProjectManager->project(projectId)->getWorkingMode()), workingMode);
+
+    QTemporaryFile savedFile;
+
+    savedFile.open();
+    savedFile.close();
+    QUrl savedUrl = QUrl::fromLocalFile(savedFile.fileName());
+
+    QList<int> ids = plmdata->treeHub()->getAllIds(projectId);
+    QVector<qint64> latencies;
+    QElapsedTimer   timer;
+    qint64    saveNs = 0;
+    SKRResult result;
+
+    latencies.reserve(callCount);
+
+    for (int i = 0; i < callCount; ++i) {
+        timer.start();
+        result = plmdata->treeHub()->setTitle(projectId, ids.at(i % ids.count()), QString("title %1").arg(i));
+        latencies.append(timer.nsecsElapsed());
+        QVERIFY(result.isSuccess());
+
+        // synchronous, or handed to the worker thread
+        if (i % 1000 == 999) {
+            timer.start();
+            result = plmdata->projectHub()->saveProjectAs(projectId, "skrib", savedUrl);
+            saveNs += timer.nsecsElapsed();
+            QVERIFY(result.isSuccess());
+        }
+    }
+
+    QVector<int> histogram(16, 0);
+
+    for (qint64 latency : qAsConst(latencies)) {
+        int bucket = 0;
+
+        while (bucket < histogram.count() - 1 && latency >= (1000LL << bucket)) {
+            bucket++;
+        }
+        histogram[bucket]++;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    qDebug() << "setTitle p50" << latencies.at(callCount / 2) / 1000 << "us, p99"
+             << latencies.at(callCount * 99 / 100) / 1000 << "us, max" << latencies.last() / 1000
+             << "us, UI thread time of the saves" << saveNs / 1000000 << "ms";
+
+    for (int bucket = 0; bucket < histogram.count(); ++bucket) {
+        if (histogram.at(bucket) > 0) {
+            qDebug().noquote() << QString("  < %1 us").arg(1 << bucket, 6) << QString(qMax(1, histogram.at(bucket) * 60 / callCount), '#') << histogram.at(bucket);
+        }
+    }
+
+    plmdata->projectHub()->closeProject(projectId);
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::countMarkdown_data()
+{
+    QTest::addColumn<QString>("markdown");
+    QTest::addColumn<int>("wordCount");
+    QTest::addColumn<int>("characterCount");
+
+    QTest::newRow("empty") << "" << 0 << 0;
+    QTest::newRow("plain") << "Hello world" << 2 << 11;
+    QTest::newRow("emphasis") << "Some **bold** and _italic_ text" << 5 << 25;
+    QTest::newRow("heading") << "# Title\n\nParagraph here." << 3 << 21;
+    QTest::newRow("list") << "- one\n- two" << 2 << 7;
+    QTest::newRow("ordered list") << "1. first\n2. second" << 2 << 12;
+    QTest::newRow("link") << "see [the site](http://x.y)" << 3 << 12;
+    QTest::newRow("snake case") << "a snake_case word" << 3 << 17;
+    QTest::newRow("punctuation") << QString("Hello %1 world").arg(QChar(0x2014)) << 2 << 13;
+    QTest::newRow("blank lines") << "\n\nfirst\n\n\n\nsecond\n\n" << 2 << 12;
+    QTest::newRow("escape") << "\\*not bold\\*" << 2 << 10;
+    QTest::newRow("quote") << "> quoted  text  \n> more" << 3 << 17;
+    QTest::newRow("code") << "```\ncode line\n```" << 2 << 9;
+    QTest::newRow("thematic break") << "---" << 0 << 0;
+    QTest::newRow("accents") << QString("l'%1t%1 dernier, %2 Paris").arg(QChar(0xe9)).arg(QChar(0xe0)) << 4 << 22;
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::countMarkdown()
+{
+    QFETCH(QString, markdown);
+    QFETCH(int,     wordCount);
+    QFETCH(int,     characterCount);
+
+    int countedWords      = -1;
+    int countedCharacters = -1;
+
+    SKRWordMeter::countMarkdown(markdown, countedWords, countedCharacters);
+
+    QCOMPARE(countedWords,      wordCount);
+    QCOMPARE(countedCharacters, characterCount);
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::countWithTextDocument
+/// the previous way, markdown parsed into a QTextDocument for each count
+void BenchmarkCase::countWithTextDocument()
+{
+    QString markdown = this->createMarkdown(100000);
+    int     wordCount;
+    int     characterCount;
+
+    QBENCHMARK {
+        QTextDocument wordDocument;
+
+        wordDocument.setMarkdown(markdown);
+        QString plainText = wordDocument.toPlainText();
+
+        plainText.replace(QRegularExpression("\\n+|\\t+"), " ");
+        plainText = plainText.trimmed();
+        wordCount = plainText.count(" ") + 1;
+
+        QTextDocument characterDocument;
+
+        characterDocument.setMarkdown(markdown);
+        characterCount = characterDocument.toPlainText().count();
+    }
+
+    QVERIFY(wordCount > 0);
+    QVERIFY(characterCount > 0);
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::countWithWordMeter()
+{
+    QString markdown = this->createMarkdown(100000);
+    int     wordCount;
+    int     characterCount;
+
+    QBENCHMARK {
+        SKRWordMeter::countMarkdown(markdown, wordCount, characterCount);
+    }
+
+    QCOMPARE(wordCount, 100000);
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::fingerprint()
+{
+    QString text = this->createMarkdown(1000);
+
+    // stored in the projects, must not change between runs
+    QCOMPARE(SKRWordMeter::fingerprint(QString()), QString("1-0-cbf29ce484222325"));
+
+    QCOMPARE(SKRWordMeter::fingerprint(text), SKRWordMeter::fingerprint(QString(text)));
+
+    QString changedText = text;
+
+    changedText[text.size() / 2] = QChar('x');
+    QVERIFY(SKRWordMeter::fingerprint(changedText) != SKRWordMeter::fingerprint(text));
+    QVERIFY(SKRWordMeter::fingerprint(text + " ") != SKRWordMeter::fingerprint(text));
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::countTexts_data()
+{
+    QTest::addColumn<int>("unchangedPercent");
+
+    QTest::newRow("nothing stored") << 0;
+    QTest::newRow("few changes") << 95;
+    QTest::newRow("nothing changed") << 100;
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::countTexts
+/// what opening a project costs, the texts with a known fingerprint being skipped
+void BenchmarkCase::countTexts()
+{
+    QFETCH(int, unchangedPercent);
+
+    SKRWordMeter meter;
+    QList<SKRWordMeter::Text> texts;
+    QString markdown = this->createMarkdown(200);
+
+    for (int i = 0; i < m_treeItemCount; ++i) {
+        QString text = markdown + QString::number(i);
+
+        texts.append({ i, text, i % 100 < unchangedPercent ? SKRWordMeter::fingerprint(text) : QString() });
+    }
+
+    int countedCount = -1;
+    int skippedCount = -1;
+
+    connect(&meter, &SKRWordMeter::textsCounted, this, [&](int projectId, int counted, int skipped) {
+        Q_UNUSED(projectId)
+        countedCount = counted;
+        skippedCount = skipped;
+    });
+
+    QBENCHMARK {
+        countedCount = -1;
+        meter.countTexts(1, texts);
+        QTRY_VERIFY_WITH_TIMEOUT(countedCount != -1, 60000);
+    }
+
+    QCOMPARE(skippedCount,                m_treeItemCount * unchangedPercent / 100);
+    QCOMPARE(countedCount + skippedCount, m_treeItemCount);
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::fullTextSearch_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("expectedCount");
+
+    QTest::newRow("rare word") << "xylophone" << 1;
+    QTest::newRow("common word") << "lorem" << 1000;
+    QTest::newRow("prefix") << "xylo" << 1;
+    QTest::newRow("two words") << "lorem xylophone" << 1;
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::fullTextSearch
+/// 1000 items of 1000 words each
+void BenchmarkCase::fullTextSearch()
+{
+    QFETCH(QString, text);
+    QFETCH(int,     expectedCount);
+
+    const int treeItemCount = 1000;
+    int projectId           = this->createProject(treeItemCount, 1);
+
+    QVERIFY(projectId > 0);
+
+    SKRSearchHub *searchHub = plmdata->searchHub();
+
+    if (!searchHub->isFullTextIndexAvailable(projectId)) {
+        plmdata->projectHub()->closeProject(projectId);
+        QSKIP("SQLite is built without FTS5");
+    }
+
+    QSqlDatabase projectDb = QSqlDatabase::database(QString::number(projectId));
+    QList<int>   ids       = plmdata->treeHub()->getAllIds(projectId);
+
+    projectDb.transaction();
+    QSqlQuery contentQuery(projectDb);
+
+    contentQuery.prepare("UPDATE tbl_tree SET m_primary_content = :content WHERE l_tree_id = :id");
+
+    for (int i = 1; i < ids.count(); i++) {
+        QStringList words;
+
+        words.reserve(1000);
+
+        for (int w = 0; w < 1000; w++) {
+            words << (w % 10 == 0 ? QString("lorem") : QString("w%1").arg((i * 31 + w * 7) % 2000));
+        }
+
+        if (i == treeItemCount / 2) {
+            words[1] = "xylophone";
+        }
+
+        contentQuery.bindValue(":content", words.join(' '));
+        contentQuery.bindValue(":id",      ids.at(i));
+        QVERIFY(contentQuery.exec());
+    }
+    projectDb.commit();
+
+    QList<int> foundIds;
+
+    QBENCHMARK {
+        foundIds = searchHub->getRankedIds(projectId, text);
+    }
+
+    QCOMPARE(foundIds.count(), expectedCount);
+
+    plmdata->projectHub()->closeProject(projectId);
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::tagLookup_data()
+{
+    QTest::addColumn<bool>("allItemsAtOnce");
+
+    QTest::newRow("per item") << false;
+    QTest::newRow("all items") << true;
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::tagLookup
+/// what the tag filter of the proxy model reads for 10k items, one query per
+/// row before, one query per filter change now
+void BenchmarkCase::tagLookup()
+{
+    QFETCH(bool, allItemsAtOnce);
+
+    const int treeItemCount = 10000;
+    int projectId           = this->createProject(treeItemCount, 1);
+
+    QVERIFY(projectId > 0);
+
+    SKRTagHub *tagHub = plmdata->tagHub();
+
+    QVERIFY(tagHub->addTag(projectId, "first").isSuccess());
+    int firstTagId = tagHub->getLastAddedId();
+
+    QVERIFY(tagHub->addTag(projectId, "second").isSuccess());
+    int secondTagId = tagHub->getLastAddedId();
+
+    QList<int> ids = plmdata->treeHub()->getAllIds(projectId);
+
+    QSqlDatabase projectDb = QSqlDatabase::database(QString::number(projectId));
+
+    projectDb.transaction();
+    QSqlQuery tagQuery(projectDb);
+
+    tagQuery.prepare("INSERT INTO tbl_tag_relationship (l_tree_code, l_tag_code) VALUES (:treeId, :tagId)");
+
+    for (int i = 1; i < ids.count(); i++) {
+        tagQuery.bindValue(":treeId", ids.at(i));
+        tagQuery.bindValue(":tagId",  i % 2 == 0 ? firstTagId : secondTagId);
+        QVERIFY(tagQuery.exec());
+
+        if (i % 10 == 0) {
+            tagQuery.bindValue(":treeId", ids.at(i));
+            tagQuery.bindValue(":tagId",  secondTagId);
+            QVERIFY(tagQuery.exec());
+        }
+    }
+    projectDb.commit();
+
+    int taggedCount = 0;
+
+    QBENCHMARK {
+        taggedCount = 0;
+
+        if (allItemsAtOnce) {
+            const QHash<int, QList<int> > tagsByTreeItemHash = tagHub->getTagsForAllItems(projectId);
+
+            for (int id : qAsConst(ids)) {
+                const QList<int> tagIds = tagsByTreeItemHash.value(id);
+                taggedCount += tagIds.contains(firstTagId) && tagIds.contains(secondTagId) ? 1 : 0;
+            }
+        }
+        else {
+            for (int id : qAsConst(ids)) {
+                const QList<int> tagIds = tagHub->getTagsFromItemId(projectId, id);
+                taggedCount += tagIds.contains(firstTagId) && tagIds.contains(secondTagId) ? 1 : 0;
+            }
+        }
+    }
+
+    QCOMPARE(taggedCount, treeItemCount / 10);
+
+    plmdata->projectHub()->closeProject(projectId);
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::treeModelLookup_data()
+{
+    QTest::addColumn<int>("treeItemCount");
+
+    QTest::newRow("1k items") << 1000;
+    QTest::newRow("10k items") << 10000;
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::treeModelLookup
+/// what checking a whole tree costs: one item and one model index per item
+void BenchmarkCase::treeModelLookup()
+{
+    QFETCH(int, treeItemCount);
+
+    int projectId = this->createProject(treeItemCount, 10);
+
+    QVERIFY(projectId > 0);
+
+    SKRTreeListModel model(nullptr);
+
+    QMetaObject::invokeMethod(&model, "populate");
+
+    QList<int> ids = plmdata->treeHub()->getAllIds(projectId);
+
+    QVERIFY(model.rowCount() >= ids.count());
+
+    int foundCount = 0;
+
+    QBENCHMARK {
+        foundCount = 0;
+
+        for (int id : qAsConst(ids)) {
+            SKRTreeItem *item = model.getItem(projectId, id);
+            QModelIndexList modelIndexList = model.getModelIndex(projectId, id);
+
+            if (item && !modelIndexList.isEmpty() && (modelIndexList.first().internalPointer() == item)) {
+                foundCount++;
+            }
+        }
+    }
+
+    QCOMPARE(foundCount, ids.count());
+
+    plmdata->projectHub()->closeProject(projectId);
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::treeStructure_data()
+{
+    QTest::addColumn<int>("treeItemCount");
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("2k items, scans") << 2000 << false;
+    QTest::newRow("2k items, cached") << 2000 << true;
+    QTest::newRow("20k items, cached") << 20000 << true;
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::treeStructure
+/// what a view refresh asks each item of the flat list: parent, row, children count
+void BenchmarkCase::treeStructure()
+{
+    QFETCH(int,  treeItemCount);
+    QFETCH(bool, cached);
+
+    QList<SKRTreeItem *> itemList;
+
+    itemList.append(new SKRTreeItem(1, 0, 0, 0));
+
+    for (int i = 1; i <= treeItemCount; i++) {
+        itemList.append(new SKRTreeItem(1, i, 1 + (i - 1) % 10, i * 1000));
+    }
+
+    if (cached) {
+        SKRTreeItem::cacheStructure(itemList);
+    }
+
+    int parentCount        = 0;
+    int childrenCountTotal = 0;
+
+    QBENCHMARK {
+        parentCount        = 0;
+        childrenCountTotal = 0;
+
+        for (SKRTreeItem *item : qAsConst(itemList)) {
+            parentCount        += item->parent(itemList) ? 1 : 0;
+            childrenCountTotal += item->childrenCount(itemList);
+            item->row(itemList);
+        }
+    }
+
+    // every item but the project item has a parent and is a child
+    QCOMPARE(parentCount,        treeItemCount);
+    QCOMPARE(childrenCountTotal, treeItemCount);
+
+    qDeleteAll(itemList);
+}
+
+// ------------------------------------------------------------------------------------
+
+void BenchmarkCase::typeContent_data()
+{
+    QTest::addColumn<bool>("journaled");
+
+    QTest::newRow("full rewrite") << false;
+    QTest::newRow("journal") << true;
+}
+
+// ------------------------------------------------------------------------------------
+
+///
+/// \brief BenchmarkCase::typeContent
+/// 100 saves while typing in the middle of a 50k words chapter
+void BenchmarkCase::typeContent()
+{
+    QFETCH(bool, journaled);
+
+    int projectId = this->createProject(1, 1);
+
+    QVERIFY(projectId > 0);
+
+    SKRTreeHub *treeHub    = plmdata->treeHub();
+    int         treeItemId = treeHub->getAllIds(projectId).last();
+    QString     content    = this->createMarkdown(50000);
+
+    QVERIFY(treeHub->setPrimaryContent(projectId, treeItemId, content, true, true).isSuccess());
+
+    int middle = content.size() / 2;
+
+    QBENCHMARK {
+        for (int i = 0; i < 100; i++) {
+            content.insert(middle + i, QChar('a' + i % 26));
+
+            if (journaled) {
+                treeHub->setPrimaryContent(projectId, treeItemId, content);
+            }
+            else {
+                treeHub->setPrimaryContent(projectId, treeItemId, content, true, true);
+            }
+        }
+    }
+
+    QVERIFY(treeHub->compactContentJournal(projectId).isSuccess());
+    QCOMPARE(treeHub->getPrimaryContent(projectId, treeItemId), content);
+
+    if (journaled) {
+        QVariantMap stats = treeHub->getContentJournalStats(projectId);
+
+        qInfo() << "requested" << stats.value("requestedCharacters").toLongLong()
+                << "journaled" << stats.value("journaledCharacters").toLongLong()
+                << "compacted" << stats.value("compactedCharacters").toLongLong()
+                << "write amplification" << stats.value("writeAmplification").toDouble();
+    }
+
+    plmdata->projectHub()->closeProject(projectId);
+}
+
+QTEST_GUILESS_MAIN(BenchmarkCase)
+
+#include "tst_benchmarkcase.moc"
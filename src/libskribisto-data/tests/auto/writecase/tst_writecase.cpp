@@ -6,10 +6,14 @@
 #include <QTime>
 #include <QDate>
 #include <QDebug>
+#include <QSqlQuery>
 
 
 #include "plmdata.h"
 #include "skrresult.h"
+#include "skrwordmeter.h"
+#include "tasks/sql/skrsqlstatementcache.h"
+#include "tasks/plmprojectmanager.h"
 
 class WriteCase : public QObject {
     Q_OBJECT
@@ -32,6 +36,9 @@ private Q_SLOTS:
     void getAllIndents();
     void getAllSortOrders();
     void getAllIds();
+    void getAllPrimaryContents();
+    void loadStats();
+    void statementCache();
     void setTitle();
     void getTitle();
     void setIndent();
@@ -41,6 +48,7 @@ private Q_SLOTS:
     void getTrashed();
     void setPrimaryContent();
     void getPrimaryContent();
+    void journalPrimaryContent();
     void setCreationDate();
     void getCreationDate();
     void setUpdateDate();
@@ -50,11 +58,17 @@ private Q_SLOTS:
     void missingProjectError();
 
     void addTreeItem();
+    void addTreeItems();
     void removeTreeItem();
 
+    // save
+    void walSave();
+    void walCrashRecovery();
+
     // properties
     void property();
     void property_replace();
+    void getPropertiesForAllItems();
 
     // label
     void getTreeLabel();
@@ -63,6 +77,12 @@ private Q_SLOTS:
     // tag
     void setTag();
 
+    // search
+    void searchTreeItemEdits();
+    void searchTags();
+    void searchTrashedAndRemoved();
+    void searchWithoutIndex();
+
 
 private:
 
@@ -169,6 +189,63 @@ void WriteCase::getAllIds()
 
 // ------------------------------------------------------------------------------------
 
+void WriteCase::getAllPrimaryContents()
+{
+    // journaled, not yet in tbl_tree
+    plmdata->treeHub()->setPrimaryContent(m_currentProjectId, 1, "journaled content");
+
+    QHash<int, QString> hash  = plmdata->treeHub()->getAllPrimaryContents(m_currentProjectId);
+    QHash<int, QString> types = plmdata->treeHub()->getAllTypes(m_currentProjectId);
+
+    QCOMPARE(hash.value(1), QString("journaled content"));
+
+    const QList<int> ids = plmdata->treeHub()->getAllIds(m_currentProjectId);
+
+    for (int id : ids) {
+        QCOMPARE(hash.value(id),  plmdata->treeHub()->getPrimaryContent(m_currentProjectId, id));
+        QCOMPARE(types.value(id), plmdata->treeHub()->getType(m_currentProjectId, id));
+    }
+}
+
+// ------------------------------------------------------------------------------------
+
+void WriteCase::loadStats()
+{
+    SKRStatHub *statHub     = plmdata->statHub();
+    QString     content     = "three little words";
+    QString     fingerprint = SKRWordMeter::fingerprint(content);
+
+    statHub->updateWordStats(m_currentProjectId, 1, 3, false);
+    statHub->updateCharacterStats(m_currentProjectId, 1, content.size(), false);
+    statHub->updateFingerprint(m_currentProjectId, 1, fingerprint);
+    statHub->persistStats(m_currentProjectId);
+
+    QCOMPARE(plmdata->treePropertyHub()->getProperty(m_currentProjectId, 1, "count_fingerprint"), fingerprint);
+
+    // read back from the properties only
+    statHub->loadStats(m_currentProjectId);
+
+    QCOMPARE(statHub->getFingerprints(m_currentProjectId).value(1), fingerprint);
+    QCOMPARE(statHub->getTreeItemCountWithChildren(SKRStatHub::Word, m_currentProjectId, 1), 3);
+    QVERIFY(statHub->getTreeItemTotalCount(SKRStatHub::Word, m_currentProjectId) >= 3);
+    QVERIFY(statHub->getCountingStats(m_currentProjectId).value("storedCount").toInt() >= 1);
+}
+
+// ------------------------------------------------------------------------------------
+
+void WriteCase::statementCache()
+{
+    SKRSqlStatementCache::resetCounters();
+
+    QString title = plmdata->treeHub()->getTitle(m_currentProjectId, 1);
+
+    QCOMPARE(plmdata->treeHub()->getTitle(m_currentProjectId, 1), title);
+    QVERIFY(SKRSqlStatementCache::hitCount() >= 1);
+    QVERIFY(SKRSqlStatementCache::missCount() <= 1);
+}
+
+// ------------------------------------------------------------------------------------
+
 void WriteCase::setTitle()
 {
     QSignalSpy spy(plmdata->treeHub(), SIGNAL(titleChanged(int,int,QString)));
@@ -314,6 +391,37 @@ void WriteCase::getPrimaryContent()
 
 // ------------------------------------------------------------------------------------
 
+void WriteCase::journalPrimaryContent()
+{
+    SKRTreeHub *treeHub = plmdata->treeHub();
+    QString     typed   = treeHub->getPrimaryContent(m_currentProjectId, 8);
+
+    // typing at the end, in the middle, then erasing
+    typed.append(" and more");
+    QVERIFY(treeHub->setPrimaryContent(m_currentProjectId, 8, typed).isSuccess());
+    typed.insert(100, "inserted ");
+    QVERIFY(treeHub->setPrimaryContent(m_currentProjectId, 8, typed).isSuccess());
+    typed.remove(10, 20);
+    QVERIFY(treeHub->setPrimaryContent(m_currentProjectId, 8, typed).isSuccess());
+
+    QCOMPARE(treeHub->getPrimaryContent(m_currentProjectId, 8), typed);
+
+    QVariantMap stats = treeHub->getContentJournalStats(m_currentProjectId);
+
+    QCOMPARE(stats.value("deltaCount").toInt(),          3);
+    QCOMPARE(stats.value("journaledCharacters").toInt(), 18);
+    QCOMPARE(stats.value("compactionCount").toInt(),     0);
+
+    // replayed into tbl_tree
+    QVERIFY(treeHub->compactContentJournal(m_currentProjectId).isSuccess());
+
+    stats = treeHub->getContentJournalStats(m_currentProjectId);
+    QCOMPARE(stats.value("compactionCount").toInt(), 1);
+    QCOMPARE(treeHub->getPrimaryContent(m_currentProjectId, 8), typed);
+}
+
+// ------------------------------------------------------------------------------------
+
 void WriteCase::setCreationDate()
 {
     QSignalSpy spy(plmdata->treeHub(), SIGNAL(creationDateChanged(int,int,QDateTime)));
@@ -428,6 +536,56 @@ void WriteCase::addTreeItem()
 
 // ------------------------------------------------------------------------------------
 
+void WriteCase::addTreeItems()
+{
+    QSignalSpy addedSpy(plmdata->treeHub(), SIGNAL(treeItemAdded(int,int)));
+    QSignalSpy bulkAddedSpy(plmdata->treeHub(), SIGNAL(treeItemsAdded(int,QList<int>)));
+
+    int parentIndent       = plmdata->treeHub()->getIndent(m_currentProjectId, 1);
+    QList<int> idsBefore   = plmdata->treeHub()->getAllIds(m_currentProjectId);
+    QHash<int, int>indents = plmdata->treeHub()->getAllIndents(m_currentProjectId);
+
+    // the subtree goes after the last descendant of the parent
+    int insertionIndex = idsBefore.indexOf(1) + 1;
+
+    while (insertionIndex < idsBefore.count() && indents.value(idsBefore.at(insertionIndex)) > parentIndent) {
+        insertionIndex++;
+    }
+
+    QList<QHash<QString, QVariant> > valuesList;
+    QList<int> relativeIndents = { 1, 2, 1 };
+
+    for (int i = 0; i < relativeIndents.count(); i++) {
+        QHash<QString, QVariant> values;
+        values.insert("l_indent",          relativeIndents.at(i));
+        values.insert("t_title",           QString("bulk %1").arg(i));
+        values.insert("t_type",            "TEXT");
+        values.insert("m_primary_content", QString("content %1").arg(i));
+        valuesList.append(values);
+    }
+
+    SKRResult result = plmdata->treeHub()->addTreeItems(m_currentProjectId, 1, valuesList);
+
+    QVERIFY(result.isSuccess() == true);
+    QList<int> newIds = result.getData("treeItemIdList", QVariant()).value<QList<int> >();
+    QCOMPARE(newIds.count(), 3);
+    QCOMPARE(addedSpy.count(),     0);
+    QCOMPARE(bulkAddedSpy.count(), 1);
+
+    QList<int> idsAfter = plmdata->treeHub()->getAllIds(m_currentProjectId);
+    QCOMPARE(idsAfter.count(), idsBefore.count() + 3);
+    QCOMPARE(idsAfter.mid(insertionIndex, 3), newIds);
+
+    for (int i = 0; i < newIds.count(); i++) {
+        QCOMPARE(plmdata->treeHub()->getIndent(m_currentProjectId, newIds.at(i)), parentIndent + relativeIndents.at(i));
+        QCOMPARE(plmdata->treeHub()->getTitle(m_currentProjectId, newIds.at(i)),  QString("bulk %1").arg(i));
+        QCOMPARE(plmdata->treeHub()->getPrimaryContent(m_currentProjectId, newIds.at(i)),
+                 QString("content %1").arg(i));
+    }
+}
+
+// ------------------------------------------------------------------------------------
+
 void WriteCase::removeTreeItem()
 {
     SKRResult result = plmdata->treeHub()->removeTreeItem(m_currentProjectId, 1);
@@ -437,6 +595,119 @@ void WriteCase::removeTreeItem()
 
 // ------------------------------------------------------------------------------------
 
+void WriteCase::walSave()
+{
+    QTemporaryFile savedFile;
+
+    savedFile.open();
+    savedFile.close();
+    QUrl savedUrl = QUrl::fromLocalFile(savedFile.fileName());
+
+    plmProjectManager->setWorkingMode(PLMProject::WalMode);
+    SKRResult result = plmdata->projectHub()->loadProject(m_testProjectPath, true);
+
+    plmProjectManager->setWorkingMode(PLMProject::MemoryJournalMode);
+    QVERIFY(result.isSuccess());
+
+    int projectId = result.getData("projectId", -2).toInt();
+
+    QCOMPARE(plmProjectManager->project(projectId)->getWorkingMode(), PLMProject::WalMode);
+
+    plmdata->treeHub()->setTitle(projectId, 1, "wal_title");
+
+    // the save is done by the worker thread
+    QSignalSpy spy(plmdata->projectHub(), SIGNAL(projectSaved(int)));
+
+    result = plmdata->projectHub()->saveProjectAs(projectId, "skrib", savedUrl);
+    QVERIFY(result.isSuccess());
+    QVERIFY(result.getData("deferred", false).toBool());
+    QVERIFY(spy.wait(5000));
+    QCOMPARE(spy.takeFirst().at(0).toInt(), projectId);
+
+    // only in the WAL, not saved
+    plmdata->treeHub()->setTitle(projectId, 1, "after_save");
+    plmdata->projectHub()->closeProject(projectId);
+
+    // the copy is a rollback journal database
+    QVERIFY(savedFile.open());
+    QByteArray header = savedFile.read(20);
+
+    savedFile.close();
+    QCOMPARE(int(header.at(18)), 1);
+    QCOMPARE(int(header.at(19)), 1);
+
+    result = plmdata->projectHub()->loadProject(savedUrl, true);
+    QVERIFY(result.isSuccess());
+    projectId = result.getData("projectId", -2).toInt();
+    QCOMPARE(plmdata->treeHub()->getTitle(projectId, 1), QString("wal_title"));
+    plmdata->projectHub()->closeProject(projectId);
+}
+
+// ------------------------------------------------------------------------------------
+
+void WriteCase::walCrashRecovery()
+{
+    QTemporaryDir dir;
+
+    QVERIFY(dir.isValid());
+    QString projectFileName = dir.filePath("project.skrib");
+
+    QVERIFY(QFile::copy(":/testfiles/skribisto_test_project.skrib", projectFileName));
+    QFile::setPermissions(projectFileName, QFile::ReadOwner | QFile::WriteOwner);
+    QUrl projectUrl = QUrl::fromLocalFile(projectFileName);
+
+    plmProjectManager->setWorkingMode(PLMProject::WalMode);
+    SKRResult result = plmdata->projectHub()->loadProject(projectUrl, true);
+
+    plmProjectManager->setWorkingMode(PLMProject::MemoryJournalMode);
+    QVERIFY(result.isSuccess());
+
+    int projectId = result.getData("projectId", -2).toInt();
+
+    // the working copy is next to the project
+    QString workingCopy = PLMProject::workingCopyFileName(projectUrl);
+
+    QCOMPARE(plmProjectManager->project(projectId)->getTempFileName(), workingCopy);
+
+    plmdata->treeHub()->setTitle(projectId, 1, "crashed_title");
+
+    // what a crash leaves : the working copy and its WAL, not checkpointed
+    QVERIFY(QFile::copy(workingCopy,          dir.filePath("crashed")));
+    QVERIFY(QFile::copy(workingCopy + "-wal", dir.filePath("crashed-wal")));
+    plmdata->projectHub()->closeProject(projectId);
+    QVERIFY(!QFile::exists(workingCopy));
+    QVERIFY(QFile::rename(dir.filePath("crashed"),     workingCopy));
+    QVERIFY(QFile::rename(dir.filePath("crashed-wal"), workingCopy + "-wal"));
+
+    // found again, whatever the working mode
+    result = plmdata->projectHub()->loadProject(projectUrl, true);
+    QVERIFY(result.isSuccess());
+    projectId = result.getData("projectId", -2).toInt();
+    QVERIFY(plmdata->treeHub()->getTitle(projectId, 1) != QString("crashed_title"));
+
+    QUrl recoveredPath = plmProjectManager->project(projectId)->getRecoveredPath();
+
+    QVERIFY(!recoveredPath.isEmpty());
+    QVERIFY(QFile::exists(recoveredPath.toLocalFile()));
+    QVERIFY(!QFile::exists(workingCopy));
+    QVERIFY(!QFile::exists(workingCopy + "-wal"));
+
+    result = plmdata->projectHub()->recoverProject(projectId, recoveredPath);
+    QVERIFY(result.isSuccess());
+    projectId = result.getData("projectId", -2).toInt();
+    QCOMPARE(plmdata->treeHub()->getTitle(projectId, 1), QString("crashed_title"));
+    QCOMPARE(plmdata->projectHub()->getPath(projectId), projectUrl);
+    QVERIFY(!plmdata->projectHub()->isProjectSaved(projectId));
+
+    // the recovered file goes away once saved
+    result = plmdata->projectHub()->saveProject(projectId);
+    QVERIFY(result.isSuccess());
+    QVERIFY(!QFile::exists(recoveredPath.toLocalFile()));
+    plmdata->projectHub()->closeProject(projectId);
+}
+
+// ------------------------------------------------------------------------------------
+
 void WriteCase::property()
 {
     QSignalSpy spy(plmdata->treePropertyHub(),
@@ -458,6 +729,19 @@ void WriteCase::property()
     QVERIFY(keyList.length() > 0);
 }
 
+void WriteCase::getPropertiesForAllItems()
+{
+    plmdata->treePropertyHub()->setProperty(m_currentProjectId, 1, "test1", "value1");
+
+    QHash<int, QHash<QString, QString> > hash = plmdata->treePropertyHub()->getPropertiesForAllItems(
+        m_currentProjectId,
+        QStringList() << "test0" << "test1" << "missing");
+
+    QCOMPARE(hash.value(1).value("test0"), QString("value0"));
+    QCOMPARE(hash.value(1).value("test1"), QString("value1"));
+    QVERIFY(!hash.value(1).contains("missing"));
+}
+
 void WriteCase::property_replace()
 {
     QSignalSpy spy(plmdata->treePropertyHub(),
@@ -506,6 +790,143 @@ void WriteCase::setTag()
 
 }
 
+// ------------------------------------------------------------------------------------
+
+void WriteCase::searchTreeItemEdits()
+{
+    SKRSearchHub *searchHub = plmdata->searchHub();
+    SKRTreeHub   *treeHub   = plmdata->treeHub();
+
+    // built before the edits, only the triggers can keep it up to date
+    QVERIFY(searchHub->isFullTextIndexAvailable(m_currentProjectId));
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "quokka").isEmpty());
+
+    QVERIFY(treeHub->setTitle(m_currentProjectId, 8, "quokka").isSuccess());
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "quokka"), QList<int>() << 8);
+
+    QVERIFY(treeHub->setTitle(m_currentProjectId, 8, "numbat").isSuccess());
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "quokka").isEmpty());
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "numbat"), QList<int>() << 8);
+
+    // journaled, compacted by the search
+    QString primaryContent = treeHub->getPrimaryContent(m_currentProjectId, 8);
+
+    QVERIFY(treeHub->setPrimaryContent(m_currentProjectId, 8, primaryContent + " wombat").isSuccess());
+    QVERIFY(treeHub->setSecondaryContent(m_currentProjectId, 8, "bilby").isSuccess());
+    QVERIFY(treeHub->getContentJournalStats(m_currentProjectId).value("deltaCount").toInt() > 0);
+
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "wombat"),        QList<int>() << 8);
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "bilby"),         QList<int>() << 8);
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "numbat wombat"), QList<int>() << 8);
+
+    QVERIFY(treeHub->setPrimaryContent(m_currentProjectId, 8, primaryContent).isSuccess());
+    QVERIFY(treeHub->setSecondaryContent(m_currentProjectId, 8, "").isSuccess());
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "wombat").isEmpty());
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "bilby").isEmpty());
+}
+
+// ------------------------------------------------------------------------------------
+
+void WriteCase::searchTags()
+{
+    SKRSearchHub *searchHub = plmdata->searchHub();
+    SKRTagHub    *tagHub    = plmdata->tagHub();
+
+    QVERIFY(searchHub->isFullTextIndexAvailable(m_currentProjectId));
+
+    SKRResult result = tagHub->addTag(m_currentProjectId, "dingo");
+
+    QVERIFY(result.isSuccess());
+    int tagId = result.getData("tagId", -2).toInt();
+
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "dingo").isEmpty());
+
+    QVERIFY(tagHub->setTagRelationship(m_currentProjectId, 8, tagId).isSuccess());
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "dingo"), QList<int>() << 8);
+
+    QVERIFY(tagHub->setTagName(m_currentProjectId, tagId, "echidna").isSuccess());
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "dingo").isEmpty());
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "echidna"), QList<int>() << 8);
+
+    QVERIFY(tagHub->removeTagRelationship(m_currentProjectId, 8, tagId).isSuccess());
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "echidna").isEmpty());
+
+    QVERIFY(tagHub->setTagRelationship(m_currentProjectId, 8, tagId).isSuccess());
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "echidna"), QList<int>() << 8);
+
+    QVERIFY(tagHub->removeTag(m_currentProjectId, tagId).isSuccess());
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "echidna").isEmpty());
+}
+
+// ------------------------------------------------------------------------------------
+
+void WriteCase::searchTrashedAndRemoved()
+{
+    SKRSearchHub *searchHub = plmdata->searchHub();
+    SKRTreeHub   *treeHub   = plmdata->treeHub();
+
+    QVERIFY(searchHub->isFullTextIndexAvailable(m_currentProjectId));
+    QVERIFY(treeHub->setTitle(m_currentProjectId, 8, "quokka").isSuccess());
+
+    // the trash is filtered by the views, not by the search
+    QVERIFY(treeHub->setTrashedWithChildren(m_currentProjectId, 8, true).isSuccess());
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "quokka"), QList<int>() << 8);
+
+    QVERIFY(treeHub->removeTreeItem(m_currentProjectId, 8).isSuccess());
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "quokka").isEmpty());
+}
+
+// ------------------------------------------------------------------------------------
+
+void WriteCase::searchWithoutIndex()
+{
+    SKRSearchHub *searchHub = plmdata->searchHub();
+    SKRTreeHub   *treeHub   = plmdata->treeHub();
+    SKRTagHub    *tagHub    = plmdata->tagHub();
+
+    // a plain table in the way of the FTS5 one, like a SQLite built without it
+    QSqlQuery query(plmProjectManager->project(m_currentProjectId)->getSqlDb());
+
+    QVERIFY(query.exec("CREATE TEMP TABLE tbl_tree_search (l_unused INTEGER)"));
+
+    QList<SKRResult> sentResults;
+    QObject receiver;
+
+    connect(searchHub, &SKRSearchHub::errorSent, &receiver, [&sentResults](const SKRResult& result) {
+        sentResults << result;
+    });
+
+    QVERIFY(!searchHub->isFullTextIndexAvailable(m_currentProjectId));
+    QCOMPARE(sentResults.count(),                  1);
+    QCOMPARE(sentResults.first().getStatus(),      SKRResult::Warning);
+    QCOMPARE(sentResults.first().getLastErrorCode(),
+             QString("W_SKRSEARCHHUB__full_text_index_unavailable"));
+
+    QVERIFY(treeHub->setTitle(m_currentProjectId, 8, "quokka").isSuccess());
+    QVERIFY(treeHub->setSecondaryContent(m_currentProjectId, 8, "bilby 100%").isSuccess());
+
+    SKRResult result = tagHub->addTag(m_currentProjectId, "dingo");
+
+    QVERIFY(result.isSuccess());
+    QVERIFY(tagHub->setTagRelationship(m_currentProjectId, 8,
+                                       result.getData("tagId", -2).toInt()).isSuccess());
+
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "quokka"),             QList<int>() << 8);
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "dingo quokka bilby"), QList<int>() << 8);
+    QCOMPARE(searchHub->getRankedIds(m_currentProjectId, "100%"),               QList<int>() << 8);
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "quokka numbat").isEmpty());
+
+    // % and _ are not wildcards
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "quo_ka").isEmpty());
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "quo%ka").isEmpty());
+
+    QVERIFY(treeHub->removeTreeItem(m_currentProjectId, 8).isSuccess());
+    QVERIFY(searchHub->getRankedIds(m_currentProjectId, "quokka").isEmpty());
+
+    // told only once
+    QCOMPARE(sentResults.count(), 1);
+}
+
 QTEST_GUILESS_MAIN(WriteCase)
 
 #include "tst_writecase.moc"
@@ -31,6 +31,10 @@ TextPage::TextPage(QObject *parent) : QObject(parent)
             &SKRWordMeter::wordCountCalculated,
             plmdata->statHub(),
             &SKRStatHub::updateWordStats);
+    connect(m_wordMeter, &SKRWordMeter::fingerprintCalculated, plmdata->statHub(),
+            &SKRStatHub::updateFingerprint);
+    connect(m_wordMeter, &SKRWordMeter::textsCounted, plmdata->statHub(),
+            &SKRStatHub::recordCountingRun);
 }
 
 // ---------------------------------------------------
@@ -59,6 +63,25 @@ void TextPage::updateCharAndWordCount(int projectId, int treeItemId, bool sameTh
     m_wordMeter->countText(projectId, treeItemId, primaryContent, sameThread, false);
 }
 
+// ---------------------------------------------------
+
+void TextPage::updateAllCharAndWordCount(int                        projectId,
+                                         const QList<int>         & treeItemIds,
+                                         const QHash<int, QString>& knownFingerprints)
+{
+    // one query for all the contents
+    const QHash<int, QString> primaryContents = plmdata->treeHub()->getAllPrimaryContents(projectId);
+    QList<SKRWordMeter::Text> texts;
+
+    texts.reserve(treeItemIds.count());
+
+    for (int treeItemId : treeItemIds) {
+        texts.append({ treeItemId, primaryContents.value(treeItemId), knownFingerprints.value(treeItemId) });
+    }
+
+    m_wordMeter->countTexts(projectId, texts);
+}
+
 // ---------------------------------------------------
 QTextDocumentFragment TextPage::generateExporterTextFragment(int                projectId,
                                                              int                treeItemId,
@@ -84,6 +84,9 @@ public:
     void      updateCharAndWordCount(int  projectId,
                                      int  treeItemId,
                                      bool sameThread = false)  override;
+    void      updateAllCharAndWordCount(int                        projectId,
+                                        const QList<int>         & treeItemIds,
+                                        const QHash<int, QString>& knownFingerprints) override;
 
     // exporter
     QTextDocumentFragment generateExporterTextFragment(int                projectId,